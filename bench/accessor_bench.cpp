@@ -0,0 +1,114 @@
+/**
+ * @file accessor_bench.cpp
+ * @brief Counts heap allocations and times tree walks through the Token
+ * and ExpressionNode accessors, alone and in a full differentiate and
+ * evaluate pipeline
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "derivative.hpp"
+#include "approx.hpp"
+#include "arithmetic.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+static std::atomic<long> allocations(0);
+
+void* operator new(std::size_t size)
+{
+    allocations++;
+    void* out = std::malloc(size == 0 ? 1 : size);
+    if (!out)
+    {
+        throw std::bad_alloc();
+    }
+    return out;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Reads every node the way the simplifier and the rules do: children,
+// token and operator string
+static long walk(const std::shared_ptr<ExpressionNode>& node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    long count = 1;
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        count += walk(func->getSubExprTree());
+    }
+    if (node->getStr() == "^" || node->getToken()->getStr() == "/")
+    {
+        count++;
+    }
+    return count + walk(node->getLeft()) + walk(node->getRight());
+}
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    auto var = std::make_shared<Variable>("x");
+    std::cout << "input\tallocations per pipeline\tpipeline us\t"
+                << "allocations per walk\twalk ns per node\n";
+    for (std::string input : {"x^2*sin(x)",
+                    "x^3*sin(x)*exp(x)+cos(x)/(x^2+1)",
+                    "exp(sin(cos(tan(x^2+1))))",
+                    "sin(x)*cos(x)*tan(x)*exp(x)*sqrt(x)*ln(x)"})
+    {
+        int repeats = 200;
+        std::shared_ptr<ExpressionNode> derivative;
+        double value = 0;
+        long before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (int counter = 0; counter < repeats; counter++)
+        {
+            Derivative engine(input, "x");
+            engine.log.setEnabled(false);
+            derivative = engine.solve();
+            value += Approx::approximate(derivative, var, 1.3);
+        }
+        std::chrono::duration<double, std::micro> pipeline =
+                                    std::chrono::steady_clock::now() - start;
+        long perPipeline = (allocations - before) / repeats;
+
+        int walks = 20000;
+        long nodes = 0;
+        before = allocations;
+        start = std::chrono::steady_clock::now();
+        for (int counter = 0; counter < walks; counter++)
+        {
+            nodes += walk(derivative);
+        }
+        std::chrono::duration<double, std::nano> walking =
+                                    std::chrono::steady_clock::now() - start;
+        long perWalk = (allocations - before) / walks;
+
+        std::cout << input << "\t" << perPipeline << "\t"
+                    << pipeline.count() / repeats << "\t" << perWalk << "\t"
+                    << walking.count() / nodes << "\n";
+        if (value == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file allocation_bench.cpp
+ * @brief Counts heap allocations per derivative and per evaluation
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "derivative.hpp"
+#include "approx.hpp"
+#include "arithmetic.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+static std::atomic<long> allocations(0);
+
+void* operator new(std::size_t size)
+{
+    allocations++;
+    void* out = std::malloc(size == 0 ? 1 : size);
+    if (!out)
+    {
+        throw std::bad_alloc();
+    }
+    return out;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    auto var = std::make_shared<Variable>("x");
+    std::cout << "input\tallocations per derivative\tmicroseconds\t"
+            << "allocations per evaluation\n";
+    for (std::string input : {"x^2*sin(x)",
+                    "x^3*sin(x)*exp(x)+cos(x)/(x^2+1)",
+                    "exp(sin(cos(tan(x^2+1))))",
+                    "sin(x)*cos(x)*tan(x)*exp(x)*sqrt(x)*ln(x)"})
+    {
+        int repeats = 200;
+        std::shared_ptr<ExpressionNode> derivative;
+        long before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (int counter = 0; counter < repeats; counter++)
+        {
+            Derivative engine(input, "x");
+            engine.log.setEnabled(false);
+            derivative = engine.solve();
+        }
+        std::chrono::duration<double, std::micro> elapsed =
+                                    std::chrono::steady_clock::now() - start;
+        long perDerivative = (allocations - before) / repeats;
+
+        before = allocations;
+        for (int counter = 0; counter < repeats; counter++)
+        {
+            Approx::approximate(derivative, var, 1.3);
+        }
+        long perEvaluation = (allocations - before) / repeats;
+        std::cout << input << "\t" << perDerivative << "\t"
+                    << elapsed.count() / repeats << "\t" << perEvaluation
+                    << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file equivalence_bench.cpp
+ * @brief Times Equivalence against the old four-point Approx check on
+ * large derivative trees
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "equivalence.hpp"
+#include "approx.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "arithmetic.hpp"
+#include "operation.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef std::shared_ptr<ExpressionNode> nodePtr;
+
+static nodePtr differentiate(nodePtr root, std::shared_ptr<Variable> var,
+                                                                int times)
+{
+    for (int counter = 0; counter < times; counter++)
+    {
+        Derivative engine(root, var);
+        engine.log.setEnabled(false);
+        root = engine.solve();
+    }
+    return root;
+}
+
+static int countNodes(const nodePtr& node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        return 1 + countNodes(func->getSubExprTree());
+    }
+    return 1 + countNodes(node->getLeft()) + countNodes(node->getRight());
+}
+
+// Microseconds per call, averaged over repeats
+static double time(const std::function<void()>& body, int repeats)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int counter = 0; counter < repeats; counter++)
+    {
+        body();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+                                    std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    auto var = std::make_shared<Variable>("x");
+    std::string input = "x^3*sin(x)*exp(x)+cos(x)/(x^2+1)";
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    TreeFixer::checkTree(root);
+
+    std::cout << "microseconds per check\n"
+            << "order\tnodes\thash\tstructural\tequivalent\tapprox x4\t"
+            << "approx agrees\n";
+    for (int order = 1; order <= 5; order++)
+    {
+        auto first = differentiate(root, var, order);
+        auto second = first->cloneTree();
+        // Same function, different shape: structural check fails
+        auto shifted = Operation::add(first->cloneTree(),
+                    std::make_shared<ExpressionNode>(
+                                    std::make_shared<Number>("0", 0)));
+        int repeats = 20;
+        bool same = true;
+        bool approxSame = true;
+        double hash = time([&]() { Equivalence::hash(first); }, repeats);
+        double structural = time([&]() {
+            same = same && Equivalence::structurallyEqual(first, second);
+        }, repeats);
+        double numeric = time([&]() {
+            same = same && Equivalence::equivalent(first, shifted);
+        }, repeats);
+        double approx = time([&]() {
+            for (double value : {10.0, 59.0, 1.1, 2958.0})
+            {
+                approxSame = approxSame &&
+                                Approx::approximate(first, var, value) ==
+                                Approx::approximate(shifted, var, value);
+            }
+        }, repeats);
+        std::cout << order << "\t" << countNodes(first) << "\t" << hash
+                    << "\t" << structural << "\t" << numeric << "\t"
+                    << approx << "\t" << (approxSame ? "yes" : "no")
+                    << (same ? "" : "\tmismatch") << "\n";
+    }
+    return 0;
+}
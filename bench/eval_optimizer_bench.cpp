@@ -0,0 +1,69 @@
+/**
+ * @file eval_optimizer_bench.cpp
+ * @brief Evaluations per second of derivatives as frozen trees and as
+ * optimized programs
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "eval_optimizer.hpp"
+#include "derivative.hpp"
+#include "arithmetic.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    auto var = std::make_shared<Variable>("x");
+    std::cout << "input\tentries\tprogram entries\tMevals/s tree\t"
+                << "Mevals/s program\n";
+    for (std::string input : {"x^2*sin(x)",
+                    "x^3*sin(x)*exp(x)+cos(x)/(x^2+1)",
+                    "x^5-3*x^4+2*x-7",
+                    "(x^2+3x+1)^3/(x-4)",
+                    "exp(sin(cos(tan(x^2+1))))",
+                    "sin(x)*cos(x)*tan(x)*exp(x)*sqrt(x)*ln(x)",
+                    "ln(x^2+1)*tan(x)"})
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        auto derivative = engine.solve();
+        FlatTree tree(derivative);
+        Program program = EvalOptimizer::compile(derivative, var);
+
+        int points = 200000;
+        std::vector<double> scratch;
+        double sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < points; idx++)
+        {
+            double value = 0.5 + idx * 1e-6;
+            sum += tree.evaluate(&value, scratch);
+        }
+        std::chrono::duration<double> treeTime =
+                                std::chrono::steady_clock::now() - start;
+
+        double programSum = 0;
+        start = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < points; idx++)
+        {
+            double value = 0.5 + idx * 1e-6;
+            programSum += program.evaluate(&value, scratch);
+        }
+        std::chrono::duration<double> programTime =
+                                std::chrono::steady_clock::now() - start;
+
+        std::cout << input << "\t" << tree.size() << "\t" << program.size()
+                    << "\t" << 1e-6 * points / treeTime.count() << "\t"
+                    << 1e-6 * points / programTime.count()
+                    << (std::abs(sum - programSum) > 1e-6 * std::abs(sum) ?
+                                                    "\tMISMATCH" : "")
+                    << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file lexing_bench.cpp
+ * @brief Measures tokenizer throughput on inputs made of long numeric
+ * literals
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "tokenizer.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main()
+{
+    std::cout << "input\tliterals\tMB/s\tmicroseconds\n";
+    for (std::string literal : {"123456", "3.14159265358979",
+                                        "0.000123456789", "1.2345e-07"})
+    {
+        for (int literals : {8, 64})
+        {
+            std::string input = literal;
+            for (int counter = 1; counter < literals; counter++)
+            {
+                input += "+" + literal + "x";
+            }
+            int repeats = 2000;
+            std::size_t tokens = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int counter = 0; counter < repeats; counter++)
+            {
+                Tokenizer parser(input);
+                tokens += parser.tokenize().size();
+            }
+            std::chrono::duration<double> elapsed =
+                                    std::chrono::steady_clock::now() - start;
+            double megabytes = 1e-6 * input.size() * repeats;
+            std::cout << literal << "\t" << literals << "\t"
+                        << megabytes / elapsed.count() << "\t"
+                        << 1e6 * elapsed.count() / repeats << "\n";
+            if (tokens == 0)
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
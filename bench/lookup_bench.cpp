@@ -0,0 +1,63 @@
+/**
+ * @file lookup_bench.cpp
+ * @brief Times tokenizing and token construction, which go through the
+ * Lookup tables
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "tokenizer.hpp"
+#include "token.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+int main()
+{
+    std::cout << "case\tmicroseconds\n";
+    for (std::string input : {"2x(x+1)sin(x)cos(x)",
+                    "x^3*sin(x)*exp(x)+cos(x)/(x^2+1)",
+                    "sqrt(x)ln(x)tan(x)sec(x)csc(x)cot(x)3x^2y"})
+    {
+        int repeats = 20000;
+        std::size_t tokens = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int counter = 0; counter < repeats; counter++)
+        {
+            Tokenizer parser(input);
+            tokens += parser.tokenize().size();
+        }
+        std::chrono::duration<double, std::micro> elapsed =
+                                    std::chrono::steady_clock::now() - start;
+        std::cout << "tokenize " << input << "\t"
+                    << elapsed.count() / repeats << "\n";
+        if (tokens == 0)
+        {
+            return 1;
+        }
+    }
+
+    int repeats = 200000;
+    std::size_t precedence = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int counter = 0; counter < repeats; counter++)
+    {
+        for (const char* name : {"sin", "sqrt", "ln", "tan"})
+        {
+            Function func(name);
+            precedence += func.getPrecedence();
+        }
+        for (const char* symbol : {"+", "*", "^", "/"})
+        {
+            Operator op(symbol);
+            precedence += op.getPrecedence();
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+                                std::chrono::steady_clock::now() - start;
+    std::cout << "construct 8 tokens\t" << elapsed.count() / repeats
+                << "\t(" << precedence << ")\n";
+    return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file nary_bench.cpp
+ * @brief Compares the binary Derivative with the n-ary path on long
+ * polynomials and products
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "nary_node.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "arithmetic.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+typedef std::shared_ptr<ExpressionNode> nodePtr;
+
+static nodePtr getTree(const std::string& input)
+{
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    TreeFixer::checkTree(root);
+    return root;
+}
+
+static int depth(const nodePtr& node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        return 1 + depth(func->getSubExprTree());
+    }
+    return 1 + std::max(depth(node->getLeft()), depth(node->getRight()));
+}
+
+static int countNodes(const nodePtr& node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        return 1 + countNodes(func->getSubExprTree());
+    }
+    return 1 + countNodes(node->getLeft()) + countNodes(node->getRight());
+}
+
+// Microseconds per call, averaged over repeats
+static double time(const std::function<void()>& body, int repeats)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int counter = 0; counter < repeats; counter++)
+    {
+        body();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+                                    std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+// c1*x^1 + c2*x^2 + ... + ck*x^k
+static std::string polynomial(int terms)
+{
+    std::string out;
+    for (int power = 1; power <= terms; power++)
+    {
+        out += (power == 1 ? "" : "+") + std::to_string(power % 7 + 1) +
+                                    "*x^" + std::to_string(power);
+    }
+    return out;
+}
+
+// sin(x)*cos(x)*exp(x)*... repeated k times, shifted so no two match
+static std::string longProduct(int factors)
+{
+    const std::string functions[] = {"sin", "cos", "exp"};
+    std::string out;
+    for (int idx = 0; idx < factors; idx++)
+    {
+        out += (idx == 0 ? "" : "*") + functions[idx % 3] + "(x+" +
+                                            std::to_string(idx + 1) + ")";
+    }
+    return out;
+}
+
+static void compare(const std::string& name, const std::string& input)
+{
+    auto var = std::make_shared<Variable>("x");
+    auto root = getTree(input);
+    nodePtr binary;
+    NaryNode::naryPtr nary;
+    int repeats = 5;
+    double binaryTime = time([&]() {
+        Derivative engine(root, var);
+        engine.log.setEnabled(false);
+        binary = engine.solve();
+    }, repeats);
+    double naryTime = time([&]() {
+        nary = NaryNode::build(root)->differentiate(var);
+    }, repeats);
+    auto balanced = nary->toBinary();
+    std::cout << name << "\t" << depth(binary) << "\t" << countNodes(binary)
+                << "\t" << binaryTime << "\t" << nary->depth() << "\t"
+                << depth(balanced) << "\t" << countNodes(balanced) << "\t"
+                << naryTime << "\n";
+}
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    std::cout << "input\tbinary depth\tbinary nodes\tbinary us\t"
+            << "n-ary depth\tbalanced depth\tbalanced nodes\tn-ary us\n";
+    for (int terms : {8, 16, 32, 64, 128})
+    {
+        compare("poly " + std::to_string(terms), polynomial(terms));
+    }
+    for (int factors : {4, 8, 16, 32})
+    {
+        compare("prod " + std::to_string(factors), longProduct(factors));
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file parallel_derivative_bench.cpp
+ * @brief Differentiates wide sums of heavy terms on one thread, four
+ * threads and every hardware thread
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "derivative.hpp"
+#include "arithmetic.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static std::string wideSum(int count)
+{
+    std::string out;
+    for (int idx = 1; idx <= count; idx++)
+    {
+        std::string k = std::to_string(idx);
+        out += (idx > 1 ? "+" : "") + ("sin(x^2+" + k + ")*exp(cos(x*" + k +
+                    "))*(x^3+" + k + "*x^2+x+" + k + ")/(x^2+" + k +
+                    ")*ln(x^4+" + k + ")*sqrt(x^2+" + k + "*x+" + k +
+                    ")*tan(x+" + k + ")");
+    }
+    return out;
+}
+
+// Parsing is left out, only solve() is timed
+static double solve(const std::string& input, int threads, int repeats)
+{
+    std::chrono::duration<double, std::milli> elapsed(0);
+    for (int idx = 0; idx < repeats; idx++)
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        engine.setThreads(threads);
+        auto start = std::chrono::steady_clock::now();
+        engine.solve();
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    return elapsed.count() / repeats;
+}
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    int threads = std::thread::hardware_concurrency();
+    std::cout << "hardware threads: " << threads << "\n";
+    std::cout << "terms\tms 1 thread\tms 4 threads\tms all threads\n";
+    for (int count : {1, 4, 64, 512, 2048})
+    {
+        std::string input = wideSum(count);
+        int repeats = count >= 512 ? 1 : 2048 / count;
+        std::cout << count << "\t" << solve(input, 1, repeats) << "\t"
+                    << solve(input, 4, repeats) << "\t"
+                    << solve(input, 0, repeats) << "\n";
+    }
+    // Below the threshold: no pool is started at all
+    std::cout << "x^2*sin(x)\t" << solve("x^2*sin(x)", 1, 20000) << "\t"
+                << solve("x^2*sin(x)", 4, 20000) << "\t"
+                << solve("x^2*sin(x)", 0, 20000) << "\n";
+    return 0;
+}
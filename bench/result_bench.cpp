@@ -0,0 +1,111 @@
+/**
+ * @file result_bench.cpp
+ * @brief Measures batch differentiation with one bad input in ten,
+ * rejected by exceptions and by Derivative::trySolve
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "derivative.hpp"
+#include "arithmetic.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Every tenth input is bad, the kinds taking turns
+static std::vector<std::string> batch(int count)
+{
+    const std::vector<std::string> bad = {"(x^2+1", "x^2+1)", "1.5.2*x",
+                                            "x+2/0", "sin_2(x)", "x^2*"};
+    std::vector<std::string> out;
+    for (int idx = 0; idx < count; idx++)
+    {
+        std::string k = std::to_string(idx % 7 + 2);
+        if (idx % 10 == 9)
+        {
+            out.push_back(bad[(idx / 10) % bad.size()]);
+        }
+        else
+        {
+            out.push_back("x^" + k + "*sin(" + k + "x)+ln(x^2+" + k + ")");
+        }
+    }
+    return out;
+}
+
+// Seconds to run every input through the throwing form, and the count
+// rejected
+static double throwing(const std::vector<std::string>& inputs, int& rejected)
+{
+    rejected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& input : inputs)
+    {
+        try
+        {
+            Derivative engine(input, "x");
+            engine.log.setEnabled(false);
+            engine.solve();
+        }
+        catch (const std::runtime_error&)
+        {
+            rejected++;
+        }
+    }
+    std::chrono::duration<double> elapsed =
+                                std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static double result(const std::vector<std::string>& inputs, int& rejected)
+{
+    rejected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& input : inputs)
+    {
+        if (!Derivative::trySolve(input, "x").ok())
+        {
+            rejected++;
+        }
+    }
+    std::chrono::duration<double> elapsed =
+                                std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main()
+{
+    Arithmetic::floatSimplification = false;
+    std::cout << "inputs\tthrowing/s\tresult/s\t"
+                << "us/rejection throwing\tus/rejection result\n";
+    for (int count : {1000, 10000})
+    {
+        auto inputs = batch(count);
+        std::vector<std::string> bad;
+        for (int idx = 9; idx < count; idx += 10)
+        {
+            bad.push_back(inputs[idx]);
+        }
+
+        int thrown = 0;
+        int rejected = 0;
+        double batchThrowing = throwing(inputs, thrown);
+        double batchResult = result(inputs, rejected);
+        if (thrown != rejected || thrown != bad.size())
+        {
+            std::cerr << "rejected " << thrown << " and " << rejected
+                        << " of " << count << "\n";
+            return 1;
+        }
+        double badThrowing = throwing(bad, thrown);
+        double badResult = result(bad, rejected);
+        std::cout << count << "\t" << count / batchThrowing << "\t"
+                    << count / batchResult << "\t"
+                    << 1e6 * badThrowing / bad.size() << "\t"
+                    << 1e6 * badResult / bad.size() << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file specialize_bench.cpp
+ * @brief Compares evaluating a parameterized expression per point with
+ * specializing it once per batch
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "specializer.hpp"
+#include "approx.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main()
+{
+    std::string input = "exp(a*b)*sin(k*x+d^2)+sqrt(a+b)*x^2-ln(k)/(a*d)"
+                        "+cos(b*k)*x";
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    TreeFixer::checkTree(root);
+    root = TreeFixer::simplify(root);
+
+    auto var = std::make_shared<Variable>("x");
+    Bindings parameters = Bindings::parse("a=0.5,b=2,k=3,d=1.25");
+    int points = 1000000;
+    std::vector<double> scratch;
+
+    auto start = std::chrono::steady_clock::now();
+    FlatTree full(root);
+    std::vector<double> slots = parameters.getSlots(full, var);
+    int sweep = full.getSlot(var);
+    double sum = 0;
+    for (int idx = 0; idx < points; idx++)
+    {
+        slots[sweep] = idx * 1e-6;
+        sum += full.evaluate(slots.data(), scratch);
+    }
+    std::chrono::duration<double, std::milli> fullTime =
+                                std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    FlatTree special = Specializer::compile(root, parameters);
+    std::vector<double> specialSlots(special.getVariables().size(), 0.0);
+    int specialSweep = special.getSlot(var);
+    double specialSum = 0;
+    for (int idx = 0; idx < points; idx++)
+    {
+        specialSlots[specialSweep] = idx * 1e-6;
+        specialSum += special.evaluate(specialSlots.data(), scratch);
+    }
+    std::chrono::duration<double, std::milli> specialTime =
+                                std::chrono::steady_clock::now() - start;
+
+    std::cout << "entries\t" << full.size() << " -> " << special.size()
+                << "\n";
+    std::cout << "full\t" << fullTime.count() << " ms\t" << sum << "\n";
+    std::cout << "specialized\t" << specialTime.count() << " ms\t"
+                << specialSum << "\n";
+    return 0;
+}
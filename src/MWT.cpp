@@ -29,7 +29,7 @@ std::shared_ptr<MWTNode> MWTNode::constructMWT()
         std::shared_ptr<MWTNode> current = root;
 
         // Traverse through the characters in the entry key
-        for (const char& letter : entry.first)
+        for (const char& letter : entry.name)
         {
             // Check if the child node exists
             std::shared_ptr<MWTNode> child = current->getChild(letter);
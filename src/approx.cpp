@@ -9,11 +9,13 @@
 
 #include <exception>
 #include <cfloat>
+#include <cmath>
 #include <iostream>
-#include <stack>
+#include <vector>
 
 
-Approx::Approx(std::string raw_input, std::string diffVar, double value)
+Approx::Approx(const std::string& raw_input, const std::string& diffVar,
+                                                                double value)
 {
     this->value = value;
     this->diffVar = std::make_shared<Variable>(diffVar);
@@ -21,104 +23,152 @@ Approx::Approx(std::string raw_input, std::string diffVar, double value)
     auto parsed = parser.tokenize();
     ShuntingYard converter(parsed);
     auto postfix = converter.getPostfix();
-    this->root = ExpressionNode::buildTree(postfix);
+    this->root = ExpressionNode::buildTree(std::move(postfix));
 
     this->derivative = Derivative(raw_input,"x").solve();
+    this->flatRoot = FlatTree(this->root);
+    this->flatDerivative = FlatTree(this->derivative);
 }
 std::pair<double,double> Approx::approximate()
 {
     
     
-    double originalApprox = approximate(this->root, this->diffVar, this->value);
+    double originalApprox = approximate(this->flatRoot, this->diffVar,
+                                                                this->value);
     
-    double derivativeApprox = approximate(this->derivative, this->diffVar, 
+    double derivativeApprox = approximate(this->flatDerivative, this->diffVar,
                                                                 this->value);
     return std::make_pair(originalApprox, derivativeApprox);
 }
-std::shared_ptr<Token> Approx::replaceToken(nodePtr node, 
-                                            std::shared_ptr<Variable> wrt, 
-                                            double value)
+double Approx::approximate(nodePtr root, std::shared_ptr<Variable> wrt,
+                                                                double value)
+{
+    // Freezing reads the tree without copying or changing it
+    return approximate(FlatTree(root), wrt, value);
+}
+
+double Approx::approximate(const FlatTree& tree, std::shared_ptr<Variable> wrt,
+                                                                double value)
+{
+    Bindings bindings;
+    bindings.set(wrt, value);
+    std::vector<double> slots = bindings.getSlots(tree);
+    return tree.evaluate(slots.data());
+}
+
+double Approx::approximate(const FlatTree& tree, const Bindings& bindings)
+{
+    std::vector<double> slots = bindings.getSlots(tree);
+    return tree.evaluate(slots.data());
+}
+
+Result<double> Approx::tryApproximate(const FlatTree& tree,
+                                                    const Bindings& bindings)
+{
+    auto slots = bindings.tryGetSlots(tree);
+    if (!slots.ok())
+    {
+        return slots.error();
+    }
+    double value = tree.evaluate(slots.value().data());
+    if (!std::isfinite(value))
+    {
+        return Error{Error::Code::DOMAIN, "Undefined value: " +
+                                                    std::to_string(value)};
+    }
+    return value;
+}
+
+Interval Approx::bound(nodePtr node, std::shared_ptr<Variable> wrt,
+                                                    const Interval& range)
 {
     if (!node)
     {
-        return nullptr;
+        throw std::runtime_error("Cannot bound an empty tree");
     }
-    std::shared_ptr<Token> outToken = node->getToken();
-    if (node->getType() == TokenType::VARIABLE)
+    auto token = node->getToken();
+    Interval out;
+    if (node->getType() == TokenType::NUMBER)
     {
-        std::shared_ptr<Number> num;
-        if (wrt->equals(node->getToken()))
+        auto num = std::dynamic_pointer_cast<Number>(token);
+        return Interval(num->isInt() ? num->getInt() * 1.0 :
+                                                    num->getDouble());
+    }
+    else if (node->getType() == TokenType::VARIABLE)
+    {
+        out = wrt->equals(token) ? range : Interval(1.0);
+    }
+    else if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        auto arg = bound(func->getSubExprTree(), wrt, range);
+        auto definition = Lookup::getFunction(func->getStr());
+        if (definition)
         {
-
-            outToken = std::make_shared<Number>(std::to_string(value),  value);
+            out = definition->evaluate(arg);
+        }
+        else if (func->getStr() == "log")
+        {
+            double base = 10.0;
+            if (func->getSubscript())
+            {
+                auto subscript = func->getSubscript();
+                base = subscript->isInt() ? subscript->getInt() * 1.0 :
+                                            subscript->getDouble();
+            }
+            out = Interval::log(arg, base);
         }
         else
         {
-            outToken = std::make_shared<Number>("1.0",1.0);
+            throw std::runtime_error("Cannot bound function " +
+                                                            func->getStr());
         }
-        
     }
-    else if (node->getType() == TokenType::FUNCTION)
+    else if (node->getType() == TokenType::OPERATOR)
     {
-        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
-        auto subExpr = func->getSubExprTree();
-        auto funcIter = Lookup::functionLookup.find(node->getStr());
-        
-        auto subApprox = approximate(subExpr, wrt, value);
-        if (subApprox == DBL_MAX)
+        auto left = bound(node->getLeft(), wrt, range);
+        auto right = bound(node->getRight(), wrt, range);
+        std::string op = node->getStr();
+        if (op == "+")
         {
-            func->getSubExprTree()->printTree();
-            throw std::runtime_error("Function subexpr not a number");
+            out = left + right;
         }
-        auto newSubRoot = std::make_shared<Number>(std::to_string(subApprox),
-                                                    subApprox);
-        func->setSubExprTree(std::make_shared<ExpressionNode>(newSubRoot));
-        outToken = func;
-
-        
-    }
-    return outToken;
-}
-double Approx::approximate(nodePtr root, std::shared_ptr<Variable> wrt, 
-                                                                double value)
-{
-    auto rootCopy = root->copyTree();
-    auto leaves = ExpressionNode::getLeaves(rootCopy);
-    std::stack<nodePtr> stack;
-    nodePtr current = rootCopy;
-    while (current != nullptr || !stack.empty()) {
-         
-        while (current != nullptr) {
-             
-            stack.push(current);
-            current = current->getLeft();
+        else if (op == "-")
+        {
+            out = left - right;
+        }
+        else if (op == "*")
+        {
+            out = left * right;
+        }
+        else if (op == "/")
+        {
+            out = left / right;
+        }
+        else if (op == "^")
+        {
+            out = Interval::pow(left, right);
+        }
+        else
+        {
+            throw std::runtime_error("Cannot bound operator " + op);
         }
- 
-        current = stack.top();
-        stack.pop();
-        auto replacement = replaceToken(current, wrt, value);
-        current->setToken(replacement);
-        current = current->getRight();
- 
-    }
-    
-    bool tempBool = Arithmetic::floatSimplification;
-    Arithmetic::floatSimplification = true;
-    TreeFixer::simplify(rootCopy);
-    Arithmetic::floatSimplification = tempBool;
-    if (rootCopy->getType() != TokenType::NUMBER)
-    {
-        rootCopy->printTree();
-        throw std::runtime_error("tree root not a number");
-        return DBL_MAX;
     }
-    auto out = std::dynamic_pointer_cast<Number>(rootCopy->getToken());
-    if (out->isInt())
+    else
     {
-        return out->getInt() * 1.0;
+        throw std::runtime_error("Cannot bound token " + node->getStr());
     }
-    else
+    return token->isNegative() ? -out : out;
+}
+
+Interval Approx::bound(const FlatTree& tree, std::shared_ptr<Variable> wrt,
+                                                    const Interval& range)
+{
+    std::vector<Interval> slots(tree.getVariables().size(), Interval(1.0));
+    int slot = tree.getSlot(wrt);
+    if (slot != -1)
     {
-        return out->getDouble();
+        slots[slot] = range;
     }
-}
\ No newline at end of file
+    return tree.evaluate(slots.data());
+}
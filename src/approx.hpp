@@ -3,6 +3,10 @@
 
 #include "token.hpp"
 #include "expression_node.hpp"
+#include "flat_tree.hpp"
+#include "interval.hpp"
+#include "bindings.hpp"
+#include "result.hpp"
 
 #include <memory>
 #include <string>
@@ -14,18 +18,60 @@ private:
     typedef std::shared_ptr<Number> numPtr;
     nodePtr root;
     nodePtr derivative;
+    FlatTree flatRoot;
+    FlatTree flatDerivative;
     double value;
     std::shared_ptr<Variable> diffVar;
-    static std::shared_ptr<Token> replaceToken(nodePtr node, 
-                                                std::shared_ptr<Variable> wrt, 
-                                                double value);
 public:
-    Approx(std::string raw_input, std::string diffVar, double value);
+    Approx(const std::string& raw_input, const std::string& diffVar,
+                                                            double value);
     
     std::pair<double,double> approximate();
     static double approximate(nodePtr node, 
                         std::shared_ptr<Variable> wrt, 
                         double value);
+
+    /**
+     * @brief evaluates a frozen tree without copying or simplifying it
+     *
+     * @details Domain errors come back as NaN or infinity.
+     * @throws std::runtime_error if the tree has a variable other than wrt,
+     * use approximate(tree, bindings) to give it a value
+     */
+    static double approximate(const FlatTree& tree,
+                        std::shared_ptr<Variable> wrt,
+                        double value);
+
+    /**
+     * @brief evaluates a frozen tree with a value for every variable
+     *
+     * @throws std::runtime_error if a variable of the tree is unbound
+     */
+    static double approximate(const FlatTree& tree,
+                        const Bindings& bindings);
+
+    /**
+     * @brief approximate(tree, bindings) that never throws
+     *
+     * @details An unbound variable is an UNBOUND error. Unlike approximate,
+     * a NaN or infinite value is a DOMAIN error, so a batch can tell
+     * rejected inputs apart with one check.
+     */
+    static Result<double> tryApproximate(const FlatTree& tree,
+                        const Bindings& bindings);
+
+    /**
+     * @brief bounds the tree while wrt ranges over range
+     *
+     * @details Variables other than wrt are treated as 1.0. Domain errors and division by zero never throw: they
+     * set Interval::partial, or give an empty interval when no value in
+     * the range is valid.
+     */
+    static Interval bound(nodePtr node, std::shared_ptr<Variable> wrt,
+                        const Interval& range);
+    static Interval bound(const FlatTree& tree,
+                        std::shared_ptr<Variable> wrt,
+                        const Interval& range);
     
 };
 
@@ -1,13 +1,37 @@
 #include "arithmetic.hpp"
 #include "latex_converter.hpp"
-#include "tree_modifier.hpp"
+#include "token_pool.hpp"
 
+#include <charconv>
 #include <cmath>
 #include <iostream>
+#include <limits>
 
 
 bool Arithmetic::floatSimplification = true;
 
+static const char* DIVIDE_BY_ZERO = "Undefined arithmetic: divide by 0";
+static const char* ZERO_TO_ZERO = "Undefined arithmetic: 0^0";
+
+// A whole-number result: an int when it fits, otherwise an integral
+// double so that folding 3000000000*2 does not wrap around
+static std::shared_ptr<Number> integral(double result)
+{
+    if (result >= std::numeric_limits<int>::min() &&
+                                result <= std::numeric_limits<int>::max())
+    {
+        return TokenPool::number(static_cast<int>(result));
+    }
+    // Number keeps the magnitude and a sign flag
+    char buffer[320];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer),
+                        std::fabs(result), std::chars_format::fixed).ptr;
+    auto out = std::make_shared<Number>(std::string(buffer, end),
+                                                    std::fabs(result));
+    out->setNegative(result < 0);
+    return out;
+}
+
 std::shared_ptr<Number> Arithmetic::performOperation(const operation& op,
                             numPtr left, numPtr right, bool isDivision = false)
 {
@@ -18,14 +42,11 @@ std::shared_ptr<Number> Arithmetic::performOperation(const operation& op,
         if (left->isInt() && right->isInt())
         {
             // If evenly divisible
-            if (left->getInt() % right->getInt() == 0)
+            if (static_cast<long long>(left->getInt()) % right->getInt() == 0)
             {
-                int result = left->getInt() / right->getInt();
-                // return int
-                auto out = std::make_shared<Number>(std::to_string(result),
-                                                                        result);
-                out->setNegative(result < 0);
-                return out;
+                // INT_MIN / -1 does not fit back in an int
+                return integral(static_cast<double>(left->getInt()) /
+                                                        right->getInt());
             }
             else
             {
@@ -50,11 +71,22 @@ std::shared_ptr<Number> Arithmetic::performOperation(const operation& op,
     // Handle cases where both operands are integers for non-division operations
     if (left->isInt() && right->isInt())
     {
-        int result = static_cast<int>(op(left->getInt(), right->getInt()));
-        // Return an int
+        // The result may not fit back in an int, or be whole at all
+        double result = op(left->getInt(), right->getInt());
+        if (!std::isfinite(result))
+        {
+            return nullptr;
+        }
+        if (std::trunc(result) == result)
+        {
+            return integral(result);
+        }
+        if (!Arithmetic::floatSimplification)
+        {
+            return nullptr;
+        }
         auto out = std::make_shared<Number>(std::to_string(result), result);
         out->setNegative(result < 0);
-        
         return out;
 
 
@@ -79,14 +111,16 @@ std::shared_ptr<Number> Arithmetic::performOperation(const operation& op,
         return nullptr;
     }
 
+    // Leave 0^-1 and overflowing folds for evaluation to report
+    if (!std::isfinite(result))
+    {
+        return nullptr;
+    }
     double floatPart = std::modf(result, &floatPart);
     
     if (floatPart == 0.0)
     {
-        auto out = std::make_shared<Number>(std::to_string((int)result),
-                                                                (int)result);
-        out->setNegative(result < 0);
-        return out;
+        return integral(result);
     }
     if (!Arithmetic::floatSimplification)
     {
@@ -102,7 +136,7 @@ std::shared_ptr<Number> Arithmetic::divide(nodePtr node, numPtr left,
 {
     if (right->equals(0))
     {
-        throw std::runtime_error("Undefined arithmetic: divide by 0");
+        throw std::runtime_error(DIVIDE_BY_ZERO);
     }
 
     auto divideOp = [](double a, double b) { return a / b; };
@@ -134,7 +168,7 @@ std::shared_ptr<Number> Arithmetic::power(nodePtr node, numPtr left,
 {
     if (left->equals(0) && right->equals(0))
     {
-        throw std::runtime_error("Undefined arithmetic: 0^0");
+        throw std::runtime_error(ZERO_TO_ZERO);
     }
 
     auto powerOp = [](double a, double b) { return std::pow(a, b); };
@@ -152,23 +186,31 @@ std::shared_ptr<Number> Arithmetic::getNumberToken(const nodePtr& node) {
     return nullptr;
 }
 
+std::string Arithmetic::getDomainError(const nodePtr& operatorNode)
+{
+    auto leftNum = getNumberToken(operatorNode->getLeft());
+    auto rightNum = getNumberToken(operatorNode->getRight());
+    if (operatorNode->getStr() == "/" && rightNum && rightNum->equals(0))
+    {
+        return DIVIDE_BY_ZERO;
+    }
+    if (operatorNode->getStr() == "^" && leftNum && rightNum &&
+                                leftNum->equals(0) && rightNum->equals(0))
+    {
+        return ZERO_TO_ZERO;
+    }
+    return "";
+}
+
 void Arithmetic::setNodeToZero(nodePtr& operatorNode) {
-    operatorNode->removeLeftChild();
-    operatorNode->removeRightChild();
-    operatorNode->setToken(std::make_shared<Number>("0", 0));
-    operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-        std::make_shared<Number>("0", 0)));
+    operatorNode = std::make_shared<ExpressionNode>(TokenPool::number(0));
 }
 
 void Arithmetic::setNodeToOne(nodePtr& operatorNode) {
-    operatorNode->removeLeftChild();
-    operatorNode->removeRightChild();
-    operatorNode->setToken(std::make_shared<Number>("1", 1));
-    operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-        std::make_shared<Number>("0", 0)));
+    operatorNode = std::make_shared<ExpressionNode>(TokenPool::number(1));
 }
 
-void Arithmetic::simplify(nodePtr node, numPtr left, numPtr right)
+void Arithmetic::simplify(nodePtr& node, numPtr left, numPtr right)
 {
     if (node->getStr() == "^")
     {
@@ -202,11 +244,7 @@ void Arithmetic::simplifyExponent(nodePtr& operatorNode)
         if (value)
         {
             //std::cout << leftNum->getStr() << "^" << rightNum->getStr() << " = " << value->getStr() << "\n";
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(value);
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("0", 0)));
+            operatorNode = std::make_shared<ExpressionNode>(value);
             
             return;
         }
@@ -219,26 +257,18 @@ void Arithmetic::simplifyExponent(nodePtr& operatorNode)
         }
         else if (leftNum->equals(1))
         {
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(std::make_shared<Number>("1", 1));
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-                std::make_shared<Number>("0", 0)));
+            setNodeToOne(operatorNode);
         }
     }
     else if (rightNum)
     {
         if (rightNum->equals(0))
         {
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(std::make_shared<Number>("1", 1));
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-                std::make_shared<Number>("0", 0)));
+            setNodeToOne(operatorNode);
         }
         else if (rightNum->equals(1))
         {
-            TreeModifier::replaceWithLeftChild(operatorNode);
+            operatorNode = operatorNode->getLeft();
         }
     }
 }
@@ -254,11 +284,7 @@ void Arithmetic::simplifyMultiplication(nodePtr& operatorNode)
         if (value)
         {
             //std::cout << leftNum->getStr() << "*" << rightNum->getStr() << " = " << value->getStr() << "\n";
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(value);
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("0", 0)));
+            operatorNode = std::make_shared<ExpressionNode>(value);
             return;
         }
     }
@@ -271,7 +297,7 @@ void Arithmetic::simplifyMultiplication(nodePtr& operatorNode)
         else if (leftNum->equals(1))
         {
        
-            TreeModifier::replaceWithRightChild(operatorNode);
+            operatorNode = operatorNode->getRight();
         }
     }
     else if (rightNum)
@@ -282,7 +308,7 @@ void Arithmetic::simplifyMultiplication(nodePtr& operatorNode)
         }
         else if (rightNum->equals(1))
         {
-            TreeModifier::replaceWithLeftChild(operatorNode);
+            operatorNode = operatorNode->getLeft();
         }
     }
 }
@@ -298,11 +324,7 @@ void Arithmetic::simplifyDivision(nodePtr& operatorNode)
         if (value)
         {
             //std::cout << leftNum->getStr() << "/" << rightNum->getStr() << " = " << value->getStr() << "\n";
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(value);
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("0", 0)));
+            operatorNode = std::make_shared<ExpressionNode>(value);
             return;
         }
     }
@@ -318,11 +340,11 @@ void Arithmetic::simplifyDivision(nodePtr& operatorNode)
     {
         if (rightNum->equals(0))
         {
-            throw std::runtime_error("Undefined arithmetic: divide by 0");
+            throw std::runtime_error(DIVIDE_BY_ZERO);
         }
         else if (rightNum->equals(1))
         {
-            TreeModifier::replaceWithLeftChild(operatorNode);
+            operatorNode = operatorNode->getLeft();
         }
     }
 }
@@ -337,11 +359,7 @@ void Arithmetic::simplifyAddition(nodePtr& operatorNode)
         if (value)
         {
             //std::cout << leftNum->getStr() << "+" << rightNum->getStr() << " = " << value->getStr() << "\n";
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(value);
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("0", 0)));
+            operatorNode = std::make_shared<ExpressionNode>(value);
             return;
         }
     }
@@ -349,14 +367,14 @@ void Arithmetic::simplifyAddition(nodePtr& operatorNode)
     {
         if (leftNum->equals(0))
         {
-            TreeModifier::replaceWithRightChild(operatorNode);
+            operatorNode = operatorNode->getRight();
         }
     }
     else if (rightNum)
     {
         if (rightNum->equals(0))
         {
-            TreeModifier::replaceWithLeftChild(operatorNode);
+            operatorNode = operatorNode->getLeft();
         }
     }
 }
@@ -372,11 +390,7 @@ void Arithmetic::simplifySubtraction(nodePtr& operatorNode)
         if (value)
         {
             //std::cout << leftNum->getStr() << "-" << rightNum->getStr() << " = " << value->getStr() << "\n";
-            operatorNode->removeLeftChild();
-            operatorNode->removeRightChild();
-            operatorNode->setToken(value);
-            operatorNode->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("0", 0)));
+            operatorNode = std::make_shared<ExpressionNode>(value);
             return;
         }
     }
@@ -384,15 +398,20 @@ void Arithmetic::simplifySubtraction(nodePtr& operatorNode)
     {
         if (leftNum->equals(0))
         {
-            TreeModifier::replaceWithRightChild(operatorNode);
-            operatorNode->getToken()->flipSign();
+            // 0 - u is -u: a new node, u may be shared
+            auto negated = std::make_shared<ExpressionNode>(
+                                operatorNode->getRight()->getToken()->clone());
+            negated->getToken()->flipSign();
+            negated->setLeft(operatorNode->getRight()->getLeft());
+            negated->setRight(operatorNode->getRight()->getRight());
+            operatorNode = negated;
         }
     }
     else if (rightNum)
     {
         if (rightNum->equals(0))
         {
-            TreeModifier::replaceWithLeftChild(operatorNode);
+            operatorNode = operatorNode->getLeft();
         }
     }
 }
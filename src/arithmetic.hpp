@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <functional>
+#include <string>
 
 class Arithmetic
 {
@@ -22,14 +23,26 @@ public:
     static numPtr divide(nodePtr operatorNode, numPtr left, numPtr right);
     static numPtr add(nodePtr operatorNode, numPtr left, numPtr right);
     static numPtr subtract(nodePtr operatorNode, numPtr left, numPtr right);
-    static void simplify(nodePtr operatorNode, numPtr left, numPtr right);
-    
+    static void simplify(nodePtr& operatorNode, numPtr left, numPtr right);
+
+    /**
+     * @brief Rules for a single operator node whose children are already
+     * simplified. A rule never changes the node it is given: it points
+     * operatorNode at a child or at a new node, so the old node can still
+     * be shared by other trees.
+     */
     static void simplifyExponent(nodePtr& operatorNode);
     static void simplifyMultiplication(nodePtr& operatorNode);
     static void simplifyDivision(nodePtr& operatorNode);
     static void simplifyAddition(nodePtr& operatorNode);
     static void simplifySubtraction(nodePtr& operatorNode);
 
+    /**
+     * @brief The error the rules above would throw for operatorNode, such
+     * as a division by 0 or 0^0, empty if there is none.
+     */
+    static std::string getDomainError(const nodePtr& operatorNode);
+
     static numPtr getNumberToken(const nodePtr& node);
     static void setNodeToZero(nodePtr& operatorNode);
     static void setNodeToOne(nodePtr& operatorNode);
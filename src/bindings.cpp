@@ -0,0 +1,119 @@
+#include "bindings.hpp"
+#include "derivative.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+Bindings Bindings::parse(const std::string& list)
+{
+    Bindings out;
+    std::size_t start = 0;
+    while (start <= list.size())
+    {
+        std::size_t end = list.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+        std::string entry = list.substr(start, end - start);
+        std::size_t split = entry.find('=');
+        if (split == std::string::npos || split == 0 ||
+                                            split + 1 == entry.size())
+        {
+            throw std::runtime_error("Invalid binding \"" + entry +
+                                            "\", expected name=value");
+        }
+        std::size_t used = 0;
+        std::string number = entry.substr(split + 1);
+        double value = 0;
+        try
+        {
+            value = std::stod(number, &used);
+        }
+        catch (const std::exception&)
+        {
+            used = 0;
+        }
+        if (used != number.size() || !std::isfinite(value))
+        {
+            throw std::runtime_error("Invalid value in binding \"" + entry +
+                                                                        "\"");
+        }
+        auto var = Derivative::parseVariable(entry.substr(0, split));
+        if (out.find(var) != -1)
+        {
+            throw std::runtime_error("Invalid binding \"" + entry +
+                                    "\", the variable is already bound");
+        }
+        out.set(var, value);
+        start = end + 1;
+    }
+    return out;
+}
+
+void Bindings::set(std::shared_ptr<Variable> var, double value)
+{
+    int idx = this->find(var);
+    if (idx != -1)
+    {
+        this->values[idx] = value;
+        return;
+    }
+    this->variables.push_back(var);
+    this->values.push_back(value);
+}
+
+void Bindings::set(const std::string& name, double value)
+{
+    this->set(Derivative::parseVariable(name), value);
+}
+
+int Bindings::find(const std::shared_ptr<Variable>& var) const
+{
+    for (int idx = 0; idx < this->variables.size(); idx++)
+    {
+        if (this->variables[idx]->equals(var))
+        {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+int Bindings::size() const
+{
+    return this->variables.size();
+}
+
+double Bindings::getValue(int idx) const
+{
+    return this->values[idx];
+}
+
+std::vector<double> Bindings::getSlots(const FlatTree& tree,
+                                    std::shared_ptr<Variable> free) const
+{
+    return this->tryGetSlots(tree, free).orThrow();
+}
+
+Result<std::vector<double>> Bindings::tryGetSlots(const FlatTree& tree,
+                                    std::shared_ptr<Variable> free) const
+{
+    const auto& treeVariables = tree.getVariables();
+    std::vector<double> slots(treeVariables.size(), 0.0);
+    for (int slot = 0; slot < treeVariables.size(); slot++)
+    {
+        if (free && treeVariables[slot]->equals(free))
+        {
+            continue;
+        }
+        int idx = this->find(treeVariables[slot]);
+        if (idx == -1)
+        {
+            return Error{Error::Code::UNBOUND, "No value bound to variable " +
+                                        treeVariables[slot]->getFullStr()};
+        }
+        slots[slot] = this->values[idx];
+    }
+    return slots;
+}
@@ -0,0 +1,70 @@
+#ifndef __BINDINGS_HPP__
+#define __BINDINGS_HPP__
+
+#include "token.hpp"
+#include "flat_tree.hpp"
+#include "result.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Values for the variables of an expression, subscripts included.
+ *
+ * @details Names are matched against a FlatTree's variables once, by
+ * getSlots, which lays the values out in the tree's slot order. The
+ * evaluation itself then reads a dense array and never looks at a name.
+ * Nothing defaults to 1.0: a variable without a value is an error.
+ */
+class Bindings
+{
+public:
+    Bindings() = default;
+
+    /**
+     * @brief Parses "a=2,b=3,a_1=0.5".
+     *
+     * @throws std::runtime_error on a malformed entry, a value that is not
+     * finite or a variable bound twice
+     */
+    static Bindings parse(const std::string& list);
+
+    /**
+     * @brief Binds var to value, replacing any earlier value.
+     */
+    void set(std::shared_ptr<Variable> var, double value);
+    void set(const std::string& name, double value);
+
+    /**
+     * @brief Index of var in the bindings, -1 if it has no value.
+     */
+    int find(const std::shared_ptr<Variable>& var) const;
+
+    int size() const;
+    double getValue(int idx) const;
+
+    /**
+     * @brief Values for tree, indexed by its variable slots.
+     *
+     * @param tree the frozen tree to be evaluated.
+     * @param free a variable the caller fills in itself, such as the one a
+     * sweep runs over. Its slot is left at 0. May be null.
+     * @throws std::runtime_error if any other variable of tree is unbound
+     */
+    std::vector<double> getSlots(const FlatTree& tree,
+                        std::shared_ptr<Variable> free = nullptr) const;
+
+    /**
+     * @brief getSlots that returns an UNBOUND error for an unbound variable
+     * instead of throwing.
+     */
+    Result<std::vector<double>> tryGetSlots(const FlatTree& tree,
+                        std::shared_ptr<Variable> free = nullptr) const;
+
+private:
+    std::vector<std::shared_ptr<Variable>> variables;
+    std::vector<double> values;
+};
+
+#endif // __BINDINGS_HPP__
@@ -0,0 +1,262 @@
+#include "code_converter.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+std::string CodeConverter::convertToC(nodePtr root,
+                    const std::vector<varPtr>& variables,
+                    const std::string& name)
+{
+    return convertToC(FlatTree(root), variables, name);
+}
+
+std::string CodeConverter::convertToC(const FlatTree& tree,
+                    const std::vector<varPtr>& variables,
+                    const std::string& name)
+{
+    std::string out = "#include <math.h>\n\n";
+    out += "#ifdef __cplusplus\nextern \"C\"\n#endif\n";
+    out += "double " + name + "(const double* vars)\n";
+    out += "{\n";
+    out += "    return " + convertToExpression(tree, variables) + ";\n";
+    out += "}\n";
+    return out;
+}
+
+std::string CodeConverter::convertToExpression(const FlatTree& tree,
+                    const std::vector<varPtr>& variables)
+{
+    if (tree.size() == 0)
+    {
+        throw std::runtime_error("Cannot generate code for an empty tree");
+    }
+
+    // Map tree slots onto the caller's variable order
+    std::vector<int> indices;
+    for (const auto& var : tree.getVariables())
+    {
+        int index = -1;
+        for (int idx = 0; idx < variables.size(); idx++)
+        {
+            if (variables[idx]->equals(var))
+            {
+                index = idx;
+                break;
+            }
+        }
+        if (index == -1)
+        {
+            throw std::runtime_error("No index given for variable " +
+                                                        var->getFullStr());
+        }
+        indices.push_back(index);
+    }
+
+    std::vector<std::string> out(tree.size());
+    for (int idx = 0; idx < tree.size(); idx++)
+    {
+        OpCode code = tree.getOpCode(idx);
+        int left = tree.getLeft(idx);
+        int right = tree.getRight(idx);
+        switch (code)
+        {
+            case OpCode::INTEGER:
+            case OpCode::REAL:
+                out[idx] = number(tree.getValue(idx));
+                break;
+            case OpCode::VARIABLE:
+                out[idx] = "vars[" +
+                        std::to_string(indices[tree.getSymbol(idx)]) + "]";
+                break;
+            case OpCode::NEGATE:
+                out[idx] = "(-" + out[left] + ")";
+                break;
+            case OpCode::ADD:
+                out[idx] = "(" + out[left] + " + " + out[right] + ")";
+                break;
+            case OpCode::SUBTRACT:
+                out[idx] = "(" + out[left] + " - " + out[right] + ")";
+                break;
+            case OpCode::MULTIPLY:
+                out[idx] = "(" + out[left] + " * " + out[right] + ")";
+                break;
+            case OpCode::DIVIDE:
+                out[idx] = "(" + out[left] + " / " + out[right] + ")";
+                break;
+            case OpCode::POWER:
+                out[idx] = "pow(" + out[left] + ", " + out[right] + ")";
+                break;
+            default:
+                out[idx] = functionToC(code, out[left], tree.getValue(idx));
+                break;
+        }
+        // Release children early, generated strings can get large
+        if (left != -1)
+        {
+            std::string().swap(out[left]);
+        }
+        if (right != -1)
+        {
+            std::string().swap(out[right]);
+        }
+    }
+    return out[tree.root()];
+}
+
+std::vector<std::shared_ptr<Variable>> CodeConverter::getVariables(
+                                        const FlatTree& tree, varPtr first)
+{
+    std::vector<varPtr> variables = {first};
+    for (const auto& var : tree.getVariables())
+    {
+        if (!var->equals(first))
+        {
+            variables.push_back(var);
+        }
+    }
+    return variables;
+}
+
+std::string CodeConverter::number(double value)
+{
+    // "%g" would print inf or nan, which C does not accept; the macros
+    // come from <math.h>
+    if (std::isnan(value))
+    {
+        return "NAN";
+    }
+    if (std::isinf(value))
+    {
+        return value < 0 ? "(-INFINITY)" : "INFINITY";
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    std::string out = buffer;
+    if (out.find_first_of(".e") == std::string::npos)
+    {
+        out += ".0";
+    }
+    if (value < 0)
+    {
+        out = "(" + out + ")";
+    }
+    return out;
+}
+
+// Mirrors FunctionDefinition::evaluate for each function
+std::string CodeConverter::functionToC(OpCode code, std::string argument,
+                                                                double base)
+{
+    switch (code)
+    {
+        case OpCode::SIN:   return "sin(" + argument + ")";
+        case OpCode::COS:   return "cos(" + argument + ")";
+        case OpCode::TAN:   return "tan(" + argument + ")";
+        case OpCode::COT:   return "(1.0 / tan(" + argument + "))";
+        case OpCode::CSC:   return "(1.0 / sin(" + argument + "))";
+        case OpCode::SEC:   return "(1.0 / cos(" + argument + "))";
+        case OpCode::EXP:   return "exp(" + argument + ")";
+        case OpCode::LN:    return "log(" + argument + ")";
+        case OpCode::LOG:
+            return "(log(" + argument + ") / log(" + number(base) + "))";
+        case OpCode::SQRT:  return "sqrt(" + argument + ")";
+        default:
+            throw std::runtime_error("Not a function opcode");
+    }
+}
+
+std::string CodeConverter::convertToSSA(const Program& program,
+                                const std::vector<std::string>& names)
+{
+    if (program.getOutputCount() == 0)
+    {
+        throw std::runtime_error("Cannot generate code without an output");
+    }
+    if (names.size() != program.getOutputCount())
+    {
+        throw std::runtime_error("Expected one name per program output");
+    }
+
+    // Only the entries some output depends on are written
+    std::vector<bool> needed(program.size(), false);
+    for (int position = 0; position < names.size(); position++)
+    {
+        needed[program.getOutput(position)] = true;
+    }
+    for (int idx = program.size() - 1; idx >= 0; idx--)
+    {
+        if (needed[idx] && program.getLeft(idx) != -1)
+        {
+            needed[program.getLeft(idx)] = true;
+        }
+        if (needed[idx] && program.getRight(idx) != -1)
+        {
+            needed[program.getRight(idx)] = true;
+        }
+    }
+
+    std::string out;
+    std::vector<std::string> operands(program.size());
+    int temporaries = 0;
+    for (int idx = 0; idx < program.size(); idx++)
+    {
+        if (!needed[idx])
+        {
+            continue;
+        }
+        OpCode code = program.getOpCode(idx);
+        std::string left = program.getLeft(idx) == -1 ? "" :
+                                            operands[program.getLeft(idx)];
+        std::string right = program.getRight(idx) == -1 ? "" :
+                                            operands[program.getRight(idx)];
+        std::string expr;
+        switch (code)
+        {
+            case OpCode::INTEGER:
+            case OpCode::REAL:
+                operands[idx] = number(program.getValue(idx));
+                continue;
+            case OpCode::VARIABLE:
+            {
+                // a_{1} is written a_1, a valid identifier
+                auto var = program.getVariables()[program.getSymbol(idx)];
+                operands[idx] = var->getStr();
+                if (!var->getSubscript().empty())
+                {
+                    operands[idx] += "_" + var->getSubscript();
+                }
+                continue;
+            }
+            case OpCode::NEGATE:
+                expr = "-" + left;
+                break;
+            case OpCode::ADD:
+                expr = left + " + " + right;
+                break;
+            case OpCode::SUBTRACT:
+                expr = left + " - " + right;
+                break;
+            case OpCode::MULTIPLY:
+                expr = left + " * " + right;
+                break;
+            case OpCode::DIVIDE:
+                expr = left + " / " + right;
+                break;
+            case OpCode::POWER:
+                expr = "pow(" + left + ", " + right + ")";
+                break;
+            default:
+                expr = functionToC(code, left, program.getValue(idx));
+                break;
+        }
+        operands[idx] = "t" + std::to_string(++temporaries);
+        out += operands[idx] + " = " + expr + ";\n";
+    }
+    for (int position = 0; position < names.size(); position++)
+    {
+        out += names[position] + " = " +
+                            operands[program.getOutput(position)] + ";\n";
+    }
+    return out;
+}
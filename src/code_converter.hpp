@@ -0,0 +1,69 @@
+#ifndef __CODE_CONVERTER_HPP__
+#define __CODE_CONVERTER_HPP__
+
+#include "expression_node.hpp"
+#include "flat_tree.hpp"
+#include "program.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Converts expression trees into standalone C source.
+ *
+ * @details The generated function has the signature
+ * `double name(const double* vars)`, where vars[i] holds the value of the
+ * i-th variable of the list passed to the converter. The source only
+ * depends on <math.h> and compiles as both C and C++.
+ */
+class CodeConverter
+{
+private:
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+    typedef std::shared_ptr<Variable> varPtr;
+
+    static std::string number(double value);
+    static std::string functionToC(OpCode code, std::string argument,
+                                                                double base);
+public:
+    // Converts the entire expression tree into a C function
+    static std::string convertToC(nodePtr root,
+                                const std::vector<varPtr>& variables,
+                                const std::string& name = "f");
+
+    // Converts a frozen tree into a C function
+    static std::string convertToC(const FlatTree& tree,
+                                const std::vector<varPtr>& variables,
+                                const std::string& name = "f");
+
+    // Converts a frozen tree into a single C expression over vars[]
+    static std::string convertToExpression(const FlatTree& tree,
+                                const std::vector<varPtr>& variables);
+
+    /**
+     * @brief Converts a program into straight-line assignments.
+     *
+     * @details Every operation the outputs need becomes one statement
+     * `tN = ...;` over variables, constants and earlier temporaries, and
+     * each output is then assigned as `name = ...;`. Entries shared by
+     * several uses or outputs are assigned once. The statements are
+     * valid C once <math.h> is included and the temporaries and outputs
+     * are declared.
+     * @param names one name per program output, in output order.
+     */
+    static std::string convertToSSA(const Program& program,
+                                const std::vector<std::string>& names);
+
+    /**
+     * @brief Orders the variables of a tree for code generation
+     *
+     * @param first the variable that should get index 0, usually the
+     * differentiating variable. It is included even if the tree lacks it.
+     * @return first, followed by the remaining variables in tree order.
+     */
+    static std::vector<varPtr> getVariables(const FlatTree& tree,
+                                                        varPtr first);
+};
+
+#endif // __CODE_CONVERTER_HPP__
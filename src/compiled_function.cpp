@@ -0,0 +1,106 @@
+#include "compiled_function.hpp"
+#include "code_converter.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+CompiledFunction::CompiledFunction(nodePtr root,
+                    const std::vector<varPtr>& variables) :
+    CompiledFunction(FlatTree(root), variables) {}
+
+CompiledFunction::CompiledFunction(const FlatTree& tree,
+                    const std::vector<varPtr>& variables) :
+    handle(nullptr), entry(nullptr)
+{
+    this->compile(CodeConverter::convertToC(tree, variables, "symbolic_f"),
+                                                            "symbolic_f");
+}
+
+CompiledFunction::CompiledFunction(const std::string& source,
+                    const std::string& name) : handle(nullptr), entry(nullptr)
+{
+    this->compile(source, name);
+}
+
+CompiledFunction::~CompiledFunction()
+{
+    if (this->handle)
+    {
+        dlclose(this->handle);
+    }
+    this->cleanup();
+}
+
+void CompiledFunction::cleanup()
+{
+    if (!this->directory.empty())
+    {
+        std::remove((this->directory + "/function.c").c_str());
+        std::remove((this->directory + "/function.so").c_str());
+        rmdir(this->directory.c_str());
+        this->directory.clear();
+    }
+}
+
+void CompiledFunction::compile(const std::string& source,
+                                                const std::string& name)
+{
+    char templ[] = "/tmp/symbolicXXXXXX";
+    if (!mkdtemp(templ))
+    {
+        throw std::runtime_error("Could not create build directory");
+    }
+    this->directory = templ;
+    std::string sourcePath = this->directory + "/function.c";
+    std::string libraryPath = this->directory + "/function.so";
+
+    std::ofstream file(sourcePath);
+    file << source;
+    file.close();
+    if (!file)
+    {
+        this->cleanup();
+        throw std::runtime_error("Could not write " + sourcePath);
+    }
+
+    const char* compiler = std::getenv("SYMBOLIC_CC");
+    std::string command = compiler ? compiler : "cc";
+    command += " -O2 -shared -fPIC -o " + libraryPath + " " + sourcePath +
+                                                                " -lm";
+    if (std::system(command.c_str()) != 0)
+    {
+        this->cleanup();
+        throw std::runtime_error("Compilation failed: " + command);
+    }
+
+    this->handle = dlopen(libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!this->handle)
+    {
+        this->cleanup();
+        throw std::runtime_error(std::string("dlopen failed: ") + dlerror());
+    }
+    this->entry = reinterpret_cast<function>(
+                                    dlsym(this->handle, name.c_str()));
+    if (!this->entry)
+    {
+        dlclose(this->handle);
+        this->handle = nullptr;
+        this->cleanup();
+        throw std::runtime_error("Symbol " + name + " not found");
+    }
+}
+
+double CompiledFunction::evaluate(const double* vars) const
+{
+    return this->entry(vars);
+}
+
+double CompiledFunction::operator()(const double* vars) const
+{
+    return this->entry(vars);
+}
@@ -0,0 +1,49 @@
+#ifndef __COMPILED_FUNCTION_HPP__
+#define __COMPILED_FUNCTION_HPP__
+
+#include "expression_node.hpp"
+#include "flat_tree.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Native version of an expression built with the system compiler.
+ *
+ * @details The source from CodeConverter is written to a temporary
+ * directory, compiled into a shared library and loaded with dlopen. The
+ * compiler defaults to "cc" and can be overridden with the SYMBOLIC_CC
+ * environment variable. Throws std::runtime_error if any step fails.
+ */
+class CompiledFunction
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+    typedef std::shared_ptr<Variable> varPtr;
+    typedef double (*function)(const double*);
+private:
+    void* handle;
+    function entry;
+    std::string directory;
+    void compile(const std::string& source, const std::string& name);
+    void cleanup();
+public:
+    CompiledFunction(nodePtr root, const std::vector<varPtr>& variables);
+    CompiledFunction(const FlatTree& tree,
+                                const std::vector<varPtr>& variables);
+    CompiledFunction(const std::string& source, const std::string& name);
+    ~CompiledFunction();
+
+    CompiledFunction(const CompiledFunction&) = delete;
+    CompiledFunction& operator=(const CompiledFunction&) = delete;
+
+    /**
+     * @brief Evaluates the function
+     *
+     * @param vars values in the order of the variables passed at compile time
+     */
+    double evaluate(const double* vars) const;
+    double operator()(const double* vars) const;
+};
+
+#endif // __COMPILED_FUNCTION_HPP__
@@ -8,62 +8,171 @@
 #include "latex_converter.hpp"
 #include "operation.hpp"
 #include "tree_fixer.hpp"
+#include "token_pool.hpp"
+#include "limit_guard.hpp"
 
+#include <exception>
 #include <iostream>
 #include <stdexcept>
 #include <cmath>
 
-Derivative::Derivative(std::string input, std::string wrt) : log(false)
+// Counts the nodes of a tree, function arguments included, up to limit
+static int countNodes(const std::shared_ptr<ExpressionNode>& node, int limit)
+{
+    int count = 1;
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        count += countNodes(func->getSubExprTree(), limit - count);
+    }
+    if (count < limit && node->getLeft())
+    {
+        count += countNodes(node->getLeft(), limit - count);
+    }
+    if (count < limit && node->getRight())
+    {
+        count += countNodes(node->getRight(), limit - count);
+    }
+    return count;
+}
+
+Derivative::Derivative(const std::string& input, const std::string& wrt)
+    : zero(std::make_shared<ExpressionNode>(TokenPool::number(0))),
+    one(std::make_shared<ExpressionNode>(TokenPool::number(1))), log(false)
 {
     log.setInput(input);
     log.setMode("Derivative");
     
     Tokenizer parser(input);
+    this->diffVar = parseVariable(wrt);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto postfix = converter.getPostfix();
+    this->root = ExpressionNode::buildTree(std::move(postfix));
+    TreeFixer::checkTree(this->root);
+    this->root = TreeFixer::simplify(this->root);
+}
+
+Derivative::Derivative(std::shared_ptr<Variable> wrt)
+    : zero(std::make_shared<ExpressionNode>(TokenPool::number(0))),
+    one(std::make_shared<ExpressionNode>(TokenPool::number(1))), log(false)
+{
+    this->diffVar = std::move(wrt);
+    this->root = nullptr;
+}
+
+std::shared_ptr<Variable> Derivative::parseVariable(const std::string& wrt)
+{
+    return Derivative::tryParseVariable(wrt).orThrow();
+}
+
+Result<std::shared_ptr<Variable>> Derivative::tryParseVariable(
+                                                    const std::string& wrt)
+{
     Tokenizer diffVarParser(wrt);
-    auto diffVarParsed = diffVarParser.tokenize();
+    auto parsed = diffVarParser.tryTokenize();
+    if (!parsed.ok())
+    {
+        return parsed.error();
+    }
+    auto& diffVarParsed = parsed.value();
     if (diffVarParsed.size() != 1)
     {
         std::string errMsg = "Invalid differentiating variable, ";
         errMsg += "must be one variable, but parsed output has size ";
         errMsg += std::to_string(diffVarParsed.size()) + ": " +
             diffVarParsed.toString() + "\n";
-        throw std::runtime_error(errMsg.c_str());
+        return Error{Error::Code::SYNTAX, errMsg};
     }
-    this->diffVar = std::dynamic_pointer_cast<Variable>(diffVarParsed[0]);
+    auto diffVar = diffVarParsed[0];
     if (diffVar->getType() != TokenType::VARIABLE)
     {
         std::string errMsg = "Invalid differentiating variable, ";
         errMsg += "input must be a variable, but parsed token has type ";
         errMsg += Lookup::getTokenType(diffVar->getType()) + ": " +
             diffVar->getFullStr() + "\n";
-        throw std::runtime_error(errMsg.c_str());
+        return Error{Error::Code::SYNTAX, errMsg};
     }
-    auto parsed = parser.tokenize();
-    ShuntingYard converter(parsed);
-    auto postfix = converter.getPostfix();
-    this->root = ExpressionNode::buildTree(postfix);
-    TreeFixer::checkTree(this->root);
-    TreeFixer::simplify(this->root);
+    return std::dynamic_pointer_cast<Variable>(diffVar);
 }
 
-Derivative::Derivative(nodePtr root, std::shared_ptr<Variable> wrt) : log(false)
+Result<std::shared_ptr<ExpressionNode>> Derivative::trySolve(
+                            const std::string& input, const std::string& wrt)
 {
-    this->diffVar = wrt;
-    this->root = root->copyTree();
+    auto diffVar = Derivative::tryParseVariable(wrt);
+    if (!diffVar.ok())
+    {
+        return diffVar.error();
+    }
+    auto root = ExpressionNode::tryParse(input);
+    if (!root.ok())
+    {
+        return root.error();
+    }
+    auto simplified = TreeFixer::trySimplify(root.value());
+    if (!simplified.ok())
+    {
+        return simplified.error();
+    }
+    Derivative engine(diffVar.value());
+    engine.log.setEnabled(false);
+    engine.root = simplified.value();
+    return engine.solve();
+}
+
+Derivative::Derivative(const nodePtr& root, std::shared_ptr<Variable> wrt)
+    : zero(std::make_shared<ExpressionNode>(TokenPool::number(0))),
+    one(std::make_shared<ExpressionNode>(TokenPool::number(1))), log(false)
+{
+    this->diffVar = std::move(wrt);
+    // Derivatives are memoized on the nodes, so take a private copy; a
+    // deep one, copyTree would share function arguments with the caller
+    this->root = root->cloneTree();
     TreeFixer::checkTree(this->root);
-    TreeFixer::simplify(this->root);
+    this->root = TreeFixer::simplify(this->root);
 }
 
 
 
+void Derivative::setThreads(int threads)
+{
+    this->threads = threads;
+}
+
 std::shared_ptr<ExpressionNode> Derivative::solve()
 {
-    TreeFixer::checkTree(this->root);
-    TreeFixer::simplify(this->root);
+    TreeFixer::checkTree(this->root, this->settled);
+    this->root = TreeFixer::simplify(this->root, this->settled);
     //this->root->printTree();
-    auto derivative = this->solve(this->root);
+
+    // The calling thread works too, and a tree too small to fork twice
+    // is not worth starting threads for
+    int count = this->threads > 0 ? this->threads :
+                                    std::thread::hardware_concurrency();
+    std::unique_ptr<ThreadPool> workers;
+    if (count > 1 && !this->log.isEnabled() &&
+                countNodes(this->root, 3 * PARALLEL_THRESHOLD) >=
+                                                    3 * PARALLEL_THRESHOLD)
+    {
+        workers = std::make_unique<ThreadPool>(count - 1);
+        this->pool = workers.get();
+    }
+    nodePtr derivative;
+    try
+    {
+        derivative = this->solve(this->root);
+    }
+    catch (...)
+    {
+        this->pool = nullptr;
+        this->settled.clear();
+        throw;
+    }
+    this->pool = nullptr;
     
-    TreeFixer::simplify(derivative);
+    derivative = TreeFixer::simplify(derivative, this->settled);
+    // The set owns every intermediate node, keep only the result alive
+    this->settled.clear();
     //derivative->printTree();
     log.setOutput(derivative);
     return derivative;
@@ -71,48 +180,52 @@ std::shared_ptr<ExpressionNode> Derivative::solve()
 
 std::shared_ptr<ExpressionNode> Derivative::solve(nodePtr node)
 {
+    LimitGuard::Level level;
     if (node->getDerivative())
     {
         
         return node->getDerivative();
     }
+    if (node == this->zero || node == this->one)
+    {
+        // Memoizing would make the shared constants point at themselves
+        return this->zero;
+    }
     if (!node->hasVariable(this->diffVar))
     {
         //std::cout << "The expression " <<  LaTeXConverter::convertToLaTeX(node)
         //<< " does not contain the variable, setting derivative to zero\n";
-        node->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("0", 0)));
+        node->setDerivative(this->zero);
         
     }
     else if (node->getType() == TokenType::VARIABLE)
     {
-        node->setDerivative(std::make_shared<ExpressionNode>(
-            std::make_shared<Number>("1", 1)));
+        node->setDerivative(this->one);
         //std::cout << "The expression " <<  LaTeXConverter::convertToLaTeX(node)
         //<< " is just the variable wrt, setting derivative to 1\n";
     }
     else if (node->getType() == TokenType::FUNCTION)
     {
         auto original = std::dynamic_pointer_cast<Function>(node->getToken());
-        auto subTree = original->getSubExprTree()->copyTree();
-        auto subExprDerivative = this->solve(subTree);
-        node->setDerivative(subExprDerivative->copyTree());
-        auto funcIter = Lookup::functionLookup.find(node->getStr());
-        if (funcIter != Lookup::functionLookup.end())
+        auto subExprDerivative = this->solve(original->getSubExprTree());
+        node->setDerivative(subExprDerivative);
+        auto func = Lookup::getFunction(node->getStr());
+        if (func)
         {
-            auto func = funcIter->second;
 
              
             func->update(node);
 
             
             auto deriv = func->getDerivative();
-            TreeFixer::checkTree(deriv);
+            TreeFixer::checkTree(deriv, this->settled);
             node->setDerivative(deriv);
             
             
         }
         log.logChainRule(node, subExprDerivative);
+        node->setDerivative(TreeFixer::simplify(node->getDerivative(),
+                                                        this->settled));
         /*std::cout << "\nDerivative of "
             << LaTeXConverter::convertToLaTeX(node)
             << " using chain rule is "
@@ -163,8 +276,9 @@ std::shared_ptr<ExpressionNode> Derivative::solve(nodePtr node)
                 node->getRight()->getDerivative()));
             log.logSubtraction(node);
         }
-        TreeFixer::checkTree(node->getDerivative());
-        TreeFixer::simplify(node->getDerivative());
+        TreeFixer::checkTree(node->getDerivative(), this->settled);
+        node->setDerivative(TreeFixer::simplify(node->getDerivative(),
+                                                        this->settled));
     }
     return node->getDerivative();
 }
@@ -175,6 +289,39 @@ std::shared_ptr<ExpressionNode> Derivative::solve(nodePtr node)
 
 void Derivative::solveChildren(nodePtr node)
 {
+    auto left = node->getLeft();
+    auto right = node->getRight();
+    if (this->pool && left && right &&
+            countNodes(right, PARALLEL_THRESHOLD) >= PARALLEL_THRESHOLD &&
+            countNodes(left, PARALLEL_THRESHOLD) >= PARALLEL_THRESHOLD)
+    {
+        // The task works under this thread's guard, at this depth
+        LimitGuard* guard = LimitGuard::current();
+        int depth = LimitGuard::depth();
+        auto task = this->pool->submit([this, right, guard, depth]() {
+            LimitGuard::Scope scope(guard, depth);
+            Derivative forked(this->diffVar);
+            forked.log.setEnabled(false);
+            forked.pool = this->pool;
+            forked.solve(right);
+        });
+        // The task reads right, wait for it before rethrowing
+        std::exception_ptr error;
+        try
+        {
+            this->solve(left);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        this->pool->join(task);
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
     if (node->getLeft())
     {
         solve(node->getLeft());
@@ -201,7 +348,7 @@ std::shared_ptr<ExpressionNode> Derivative::powerRule(nodePtr node)
     {
         // Apply the basic power rule: d/dx [f(x)^a] = a * f(x)^(a-1) * f'(x)
         nodePtr one = std::make_shared<ExpressionNode>(
-                    std::make_shared<Number>("1", 1)); \
+                    TokenPool::number(1)); \
             nodePtr exponentMinusOne = Operation::subtract(exponent, one);
 
         derivative = Operation::times(exponent, 
@@ -243,7 +390,8 @@ std::shared_ptr<ExpressionNode> Derivative::powerRule(nodePtr node)
             Operation::times(lnBase, exponent->getDerivative()));
     }
     node->setDerivative(derivative);
-    TreeFixer::simplify(node->getDerivative());
+    node->setDerivative(TreeFixer::simplify(node->getDerivative(),
+                                                        this->settled));
     return node->getDerivative();
 }
 
@@ -281,7 +429,8 @@ std::shared_ptr<ExpressionNode> Derivative::productRule(nodePtr node)
         
     }
 
-    TreeFixer::simplify(node->getDerivative());
+    node->setDerivative(TreeFixer::simplify(node->getDerivative(),
+                                                        this->settled));
     return node->getDerivative();
 }
 
@@ -301,7 +450,7 @@ std::shared_ptr<ExpressionNode> Derivative::quotientRule(nodePtr node)
         u->getDerivative()), Operation::times(u, v->getDerivative()));
     // v^2
     nodePtr denominator = Operation::power(v,
-        std::make_shared<ExpressionNode>(std::make_shared<Number>("2", 2)));
+        std::make_shared<ExpressionNode>(TokenPool::number(2)));
 
     // d/dx [u/v] = (v * u' - u * v') / (v^2)
     node->setDerivative(Operation::divide(numerator, denominator));
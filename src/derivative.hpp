@@ -4,18 +4,84 @@
 
 #include "expression_node.hpp"
 #include "log.hpp"
+#include "thread_pool.hpp"
+#include "result.hpp"
 
 #include <memory>
+#include <unordered_set>
 class Derivative
 {
     typedef std::shared_ptr<ExpressionNode> nodePtr;
 private:
     nodePtr root;
     std::shared_ptr<Variable> diffVar;
+    //! Shared by every constant and variable slot, never changed
+    nodePtr zero;
+    nodePtr one;
+    //! Sub-trees left as they are by TreeFixer, never walked again.
+    //! Emptied when solve() returns, as it holds the intermediate nodes
+    std::unordered_set<nodePtr> settled;
+    int threads = 1;
+    //! Pool of the parallel solve() in progress, null otherwise
+    ThreadPool* pool = nullptr;
 public:
+    //! Operands smaller than this, in nodes, are never separate tasks
+    static const int PARALLEL_THRESHOLD = 64;
+
     Logger log;
-    Derivative(std::string input, std::string wrt);
-    Derivative(nodePtr root, std::shared_ptr<Variable> wrt);
+    Derivative(const std::string& input, const std::string& wrt);
+    Derivative(const nodePtr& root, std::shared_ptr<Variable> wrt);
+
+    /**
+     * @brief creates a differentiator without a root, for use with
+     * solve(nodePtr) on trees owned by the caller
+     *
+     */
+    Derivative(std::shared_ptr<Variable> wrt);
+
+    /**
+     * @brief parses a differentiating variable
+     *
+     * @param wrt the input string, must be exactly one variable
+     * @return the parsed variable
+     * @throws std::runtime_error if wrt is not a single variable
+     */
+    static std::shared_ptr<Variable> parseVariable(const std::string& wrt);
+    static Result<std::shared_ptr<Variable>> tryParseVariable(
+                                                    const std::string& wrt);
+
+    /**
+     * @brief parses and differentiates input, the log disabled, without
+     * throwing on bad input
+     *
+     * @details Parse errors come back as SYNTAX errors and undefined
+     * constants, such as 1/0, as DOMAIN errors. Once the input has been
+     * parsed and simplified nothing the rules build can fail, so solve()
+     * runs as usual; a LimitExceeded from an installed guard still throws.
+     */
+    static Result<nodePtr> trySolve(const std::string& input,
+                                                    const std::string& wrt);
+
+    /**
+     * @brief lets solve() differentiate large operands as parallel tasks
+     *
+     * @details When both operands of an operator have at least
+     * PARALLEL_THRESHOLD nodes, the right one is differentiated and
+     * simplified as a task while this thread takes the left one. Each
+     * task runs its own engine, constants included, on a sub-tree no
+     * other task reaches: nodes keep their derivative, so two tasks must
+     * never touch the same node. Rules only link new nodes to the ones
+     * they reuse, as nodes have no parent link to write back. Only solve()
+     * forks, as its tree is parsed or deep-copied and shares no nodes;
+     * solve(nodePtr) on the caller's trees stays on the calling thread.
+     * So does a solve() with the log enabled, whose steps are in order.
+     * Arithmetic::floatSimplification must not change during a solve.
+     *
+     * @param threads number of threads, the calling one included. 0 uses
+     * the hardware concurrency, 1 (the default) keeps everything on the
+     * calling thread.
+     */
+    void setThreads(int threads);
     /**
      * @brief calculates the derivative of the entire tree
      * 
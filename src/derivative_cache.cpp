@@ -0,0 +1,270 @@
+#include "derivative_cache.hpp"
+#include "tree_archive.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char CACHE_MAGIC[8] = {'S', 'Y', 'M', 'C', 'A', 'C', 'H', 'E'};
+const std::uint32_t CACHE_ORDER_MARKER = 0x01020304;
+const std::uint32_t COMMITTED = 0x434f4d54;
+const std::size_t CACHE_HEADER = 16;
+
+// u32 commit, u32 key bytes, u64 hash, u64 size, u32 output bytes,
+// u32 reserved, u64 tree bytes
+const std::size_t RECORD_HEADER = 40;
+
+DerivativeCache::DerivativeCache(const std::string& path)
+    : path(path), data(nullptr), bytes(0)
+{
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Cannot open cache " + path);
+    }
+    flock(fd, LOCK_EX);
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    if (ok && info.st_size == 0)
+    {
+        char header[CACHE_HEADER + 8] = {};
+        std::uint32_t version = VERSION;
+        std::memcpy(header, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        std::memcpy(header + 8, &version, sizeof(version));
+        std::memcpy(header + 12, &CACHE_ORDER_MARKER,
+                                                sizeof(CACHE_ORDER_MARKER));
+        ok = pwrite(fd, header, sizeof(header), 0) == sizeof(header);
+    }
+    flock(fd, LOCK_UN);
+    ::close(fd);
+    if (!ok)
+    {
+        throw std::runtime_error("Cannot initialize cache " + path);
+    }
+    this->map();
+}
+
+DerivativeCache::~DerivativeCache()
+{
+    this->unmap();
+}
+
+void DerivativeCache::map()
+{
+    this->unmap();
+    int fd = ::open(this->path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Cannot open cache " + this->path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size < CACHE_HEADER)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot read cache " + this->path);
+    }
+    void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map cache " + this->path);
+    }
+    this->data = static_cast<const char*>(map);
+    this->bytes = info.st_size;
+
+    std::uint32_t version;
+    std::uint32_t order;
+    std::memcpy(&version, this->data + 8, sizeof(version));
+    std::memcpy(&order, this->data + 12, sizeof(order));
+    if (std::memcmp(this->data, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+                        version != VERSION || order != CACHE_ORDER_MARKER)
+    {
+        this->unmap();
+        throw std::runtime_error("Not a derivative cache of this version: " +
+                                                                this->path);
+    }
+}
+
+void DerivativeCache::unmap()
+{
+    if (this->data)
+    {
+        munmap(const_cast<char*>(this->data), this->bytes);
+    }
+    this->data = nullptr;
+    this->bytes = 0;
+}
+
+std::string DerivativeCache::key(const std::string& expression,
+                        const std::string& variable,
+                        const std::string& options)
+{
+    std::string out;
+    for (char c : expression)
+    {
+        if (!std::isspace(static_cast<unsigned char>(c)))
+        {
+            out += c;
+        }
+    }
+    return out + '\n' + variable + '\n' + options;
+}
+
+// 64-bit FNV-1a
+std::uint64_t DerivativeCache::hash(const std::string& key)
+{
+    std::uint64_t out = 14695981039346656037ull;
+    for (char c : key)
+    {
+        out ^= static_cast<unsigned char>(c);
+        out *= 1099511628211ull;
+    }
+    return out;
+}
+
+std::size_t DerivativeCache::scan(std::uint64_t hash, const std::string& key,
+                                                    std::size_t& end) const
+{
+    std::size_t offset = CACHE_HEADER;
+    while (offset + RECORD_HEADER <= this->bytes)
+    {
+        const char* record = this->data + offset;
+        std::uint32_t commit;
+        std::uint32_t keyBytes;
+        std::uint64_t recordHash;
+        std::uint64_t size;
+        std::memcpy(&commit, record, sizeof(commit));
+        std::memcpy(&keyBytes, record + 4, sizeof(keyBytes));
+        std::memcpy(&recordHash, record + 8, sizeof(recordHash));
+        std::memcpy(&size, record + 16, sizeof(size));
+        if (commit != COMMITTED || size < RECORD_HEADER + keyBytes ||
+                        size % 8 != 0 || size > this->bytes - offset)
+        {
+            break;
+        }
+        if (recordHash == hash && keyBytes == key.size() &&
+                std::memcmp(record + RECORD_HEADER, key.data(), keyBytes) == 0)
+        {
+            end = offset + size;
+            return offset;
+        }
+        offset += size;
+    }
+    end = offset;
+    return 0;
+}
+
+bool DerivativeCache::find(const std::string& key, Entry& entry)
+{
+    std::uint64_t keyHash = hash(key);
+    std::size_t end;
+    std::size_t offset = this->scan(keyHash, key, end);
+    if (offset == 0)
+    {
+        // Pick up what other processes appended since the file was mapped
+        std::size_t mapped = this->bytes;
+        struct stat info;
+        if (stat(this->path.c_str(), &info) == 0 && info.st_size != mapped)
+        {
+            this->map();
+            offset = this->scan(keyHash, key, end);
+        }
+    }
+    if (offset == 0)
+    {
+        return false;
+    }
+
+    const char* record = this->data + offset;
+    std::uint32_t keyBytes;
+    std::uint32_t outputBytes;
+    std::uint64_t size;
+    std::uint64_t treeBytes;
+    std::memcpy(&keyBytes, record + 4, sizeof(keyBytes));
+    std::memcpy(&size, record + 16, sizeof(size));
+    std::memcpy(&outputBytes, record + 24, sizeof(outputBytes));
+    std::memcpy(&treeBytes, record + 32, sizeof(treeBytes));
+    std::size_t text = RECORD_HEADER + keyBytes + outputBytes;
+    std::size_t tree = (text + 7) / 8 * 8;
+    if (text > size || treeBytes > size - tree)
+    {
+        throw std::runtime_error("Corrupt derivative cache " + this->path);
+    }
+    entry.output = std::string_view(record + RECORD_HEADER + keyBytes,
+                                                                outputBytes);
+    entry.tree = record + tree;
+    entry.treeBytes = treeBytes;
+    return true;
+}
+
+FlatTree DerivativeCache::derivative(const Entry& entry)
+{
+    TreeArchive archive(entry.tree, entry.treeBytes);
+    return archive.load(0);
+}
+
+void DerivativeCache::insert(const std::string& key,
+                            const std::string& output,
+                            const FlatTree& derivative)
+{
+    std::string tree = TreeArchive::serialize({derivative});
+    std::size_t text = RECORD_HEADER + key.size() + output.size();
+    std::size_t treeOffset = (text + 7) / 8 * 8;
+    std::uint64_t size = treeOffset + (tree.size() + 7) / 8 * 8;
+
+    // The record, then a zeroed commit word that ends the chain
+    std::vector<char> record(size + 8, '\0');
+    std::uint32_t keyBytes = key.size();
+    std::uint64_t keyHash = hash(key);
+    std::uint32_t outputBytes = output.size();
+    std::uint64_t treeBytes = tree.size();
+    std::memcpy(&record[4], &keyBytes, sizeof(keyBytes));
+    std::memcpy(&record[8], &keyHash, sizeof(keyHash));
+    std::memcpy(&record[16], &size, sizeof(size));
+    std::memcpy(&record[24], &outputBytes, sizeof(outputBytes));
+    std::memcpy(&record[32], &treeBytes, sizeof(treeBytes));
+    std::memcpy(&record[RECORD_HEADER], key.data(), key.size());
+    std::memcpy(&record[RECORD_HEADER + key.size()], output.data(),
+                                                            output.size());
+    std::memcpy(&record[treeOffset], tree.data(), tree.size());
+
+    int fd = ::open(this->path.c_str(), O_RDWR);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Cannot open cache " + this->path);
+    }
+    flock(fd, LOCK_EX);
+    bool ok = true;
+    try
+    {
+        this->map();
+        std::size_t end;
+        if (this->scan(keyHash, key, end) == 0)
+        {
+            ok = pwrite(fd, record.data(), record.size(), end) ==
+                                        static_cast<ssize_t>(record.size());
+            ok = ok && pwrite(fd, &COMMITTED, sizeof(COMMITTED), end) ==
+                                                        sizeof(COMMITTED);
+        }
+    }
+    catch (...)
+    {
+        flock(fd, LOCK_UN);
+        ::close(fd);
+        throw;
+    }
+    flock(fd, LOCK_UN);
+    ::close(fd);
+    if (!ok)
+    {
+        throw std::runtime_error("Cannot append to cache " + this->path);
+    }
+    this->map();
+}
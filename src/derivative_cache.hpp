@@ -0,0 +1,93 @@
+#ifndef __DERIVATIVE_CACHE_HPP__
+#define __DERIVATIVE_CACHE_HPP__
+
+#include "flat_tree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Append-only file of finished derivatives shared by processes.
+ *
+ * @details Each record holds a key built from the expression text, the
+ * variable and the output options, the rendered output and the
+ * derivative as a one-tree TreeArchive. Readers map the file and scan it
+ * without taking any lock; writers take an exclusive flock, append the
+ * record followed by a zeroed marker and only then set the record's own
+ * commit marker, so a reader never follows a record that is still being
+ * written. A record left uncommitted by a writer that died is overwritten
+ * by the next writer.
+ */
+class DerivativeCache
+{
+public:
+    static const std::uint32_t VERSION = 1;
+
+    struct Entry
+    {
+        //! Rendered output, valid while the cache is alive
+        std::string_view output;
+        //! Archived derivative, see TreeArchive
+        const char* tree;
+        std::size_t treeBytes;
+    };
+
+    /**
+     * @brief Opens the cache file, creating it when missing.
+     */
+    explicit DerivativeCache(const std::string& path);
+    ~DerivativeCache();
+    DerivativeCache(const DerivativeCache&) = delete;
+    DerivativeCache& operator=(const DerivativeCache&) = delete;
+
+    /**
+     * @brief Builds a lookup key; whitespace in the expression is ignored.
+     *
+     * @details The key is textual: x*y and y*x are different keys. They
+     * are not interchangeable, since the cached steps and output follow
+     * the operand order of the input.
+     */
+    static std::string key(const std::string& expression,
+                        const std::string& variable,
+                        const std::string& options);
+
+    /**
+     * @brief Looks key up, picking up records appended by other processes
+     * since the last lookup.
+     */
+    bool find(const std::string& key, Entry& entry);
+
+    /**
+     * @brief Copies the archived derivative of a found entry.
+     */
+    static FlatTree derivative(const Entry& entry);
+
+    /**
+     * @brief Appends a record, unless another writer already added key.
+     *
+     * @details Remaps the file, so earlier entries are no longer valid.
+     */
+    void insert(const std::string& key, const std::string& output,
+                                                const FlatTree& derivative);
+
+private:
+    std::string path;
+    const char* data;
+    std::size_t bytes;
+
+    void map();
+    void unmap();
+
+    /**
+     * @brief Offset of the committed record for key, 0 if none.
+     *
+     * @param end receives the end of the committed records
+     */
+    std::size_t scan(std::uint64_t hash, const std::string& key,
+                                                std::size_t& end) const;
+    static std::uint64_t hash(const std::string& key);
+};
+
+#endif // __DERIVATIVE_CACHE_HPP__
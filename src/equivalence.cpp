@@ -0,0 +1,338 @@
+#include "equivalence.hpp"
+#include "flat_tree.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+void Equivalence::combine(std::size_t& hash, std::size_t value)
+{
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+}
+
+double Equivalence::numberValue(const nodePtr& node)
+{
+    auto num = std::dynamic_pointer_cast<Number>(node->getToken());
+    double value = num->isInt() ? num->getInt() * 1.0 : num->getDouble();
+    // -0.0 and 0.0 hash the same
+    return value == 0.0 ? 0.0 : value;
+}
+
+bool Equivalence::isCommutative(const nodePtr& node)
+{
+    return node->getType() == TokenType::OPERATOR &&
+                        (node->getStr() == "+" || node->getStr() == "*");
+}
+
+void Equivalence::operands(const nodePtr& node, const std::string& op,
+                                                std::vector<nodePtr>& out)
+{
+    for (const auto& child : {node->getLeft(), node->getRight()})
+    {
+        // A negated chain is a single operand: -(a + b) is not a + b
+        if (child->getType() == TokenType::OPERATOR &&
+                    child->getStr() == op && !child->getToken()->isNegative())
+        {
+            operands(child, op, out);
+        }
+        else
+        {
+            out.push_back(child);
+        }
+    }
+}
+
+std::size_t Equivalence::hash(const nodePtr& node)
+{
+    hashTable table;
+    return hash(node, table);
+}
+
+std::size_t Equivalence::hash(const nodePtr& node, hashTable& table)
+{
+    if (!node)
+    {
+        throw std::runtime_error("Cannot hash an empty subtree");
+    }
+    auto known = table.find(node.get());
+    if (known != table.end())
+    {
+        return known->second;
+    }
+
+    std::size_t out = std::hash<int>()(static_cast<int>(node->getType()));
+    auto token = node->getToken();
+    if (node->getType() == TokenType::NUMBER)
+    {
+        combine(out, std::hash<double>()(numberValue(node)));
+    }
+    else if (node->getType() == TokenType::VARIABLE)
+    {
+        combine(out, std::hash<std::string>()(token->getFullStr()));
+    }
+    else if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        combine(out, std::hash<std::string>()(func->getStr()));
+        combine(out, std::hash<bool>()(func->isNegative()));
+        if (func->getSubscript())
+        {
+            auto base = func->getSubscript();
+            combine(out, std::hash<double>()(base->isInt() ?
+                                base->getInt() * 1.0 : base->getDouble()));
+        }
+        combine(out, hash(func->getSubExprTree(), table));
+    }
+    else if (isCommutative(node))
+    {
+        combine(out, std::hash<std::string>()(node->getStr()));
+        combine(out, std::hash<bool>()(token->isNegative()));
+        std::vector<nodePtr> terms;
+        operands(node, node->getStr(), terms);
+        std::vector<std::size_t> hashes;
+        hashes.reserve(terms.size());
+        for (const auto& term : terms)
+        {
+            hashes.push_back(hash(term, table));
+        }
+        std::sort(hashes.begin(), hashes.end());
+        for (auto value : hashes)
+        {
+            combine(out, value);
+        }
+    }
+    else
+    {
+        combine(out, std::hash<std::string>()(node->getStr()));
+        combine(out, std::hash<bool>()(token->isNegative()));
+        combine(out, hash(node->getLeft(), table));
+        combine(out, hash(node->getRight(), table));
+    }
+    table[node.get()] = out;
+    return out;
+}
+
+bool Equivalence::structurallyEqual(const nodePtr& first,
+                                                    const nodePtr& second)
+{
+    hashTable firstTable;
+    hashTable secondTable;
+    return equal(first, second, firstTable, secondTable);
+}
+
+bool Equivalence::equal(const nodePtr& first, const nodePtr& second,
+                        hashTable& firstTable, hashTable& secondTable)
+{
+    if (first == second)
+    {
+        return true;
+    }
+    if (hash(first, firstTable) != hash(second, secondTable) ||
+                                    first->getType() != second->getType())
+    {
+        return false;
+    }
+    auto firstToken = first->getToken();
+    auto secondToken = second->getToken();
+    if (first->getType() == TokenType::NUMBER)
+    {
+        return numberValue(first) == numberValue(second);
+    }
+    if (first->getType() == TokenType::VARIABLE)
+    {
+        return firstToken->getFullStr() == secondToken->getFullStr();
+    }
+    if (firstToken->isNegative() != secondToken->isNegative() ||
+                                        first->getStr() != second->getStr())
+    {
+        return false;
+    }
+    if (first->getType() == TokenType::FUNCTION)
+    {
+        auto firstFunc = std::dynamic_pointer_cast<Function>(firstToken);
+        auto secondFunc = std::dynamic_pointer_cast<Function>(secondToken);
+        auto firstBase = firstFunc->getSubscript();
+        auto secondBase = secondFunc->getSubscript();
+        if (!firstBase != !secondBase || (firstBase &&
+                firstBase->getFullStr() != secondBase->getFullStr()))
+        {
+            return false;
+        }
+        return equal(firstFunc->getSubExprTree(),
+                    secondFunc->getSubExprTree(), firstTable, secondTable);
+    }
+    if (!isCommutative(first))
+    {
+        return equal(first->getLeft(), second->getLeft(),
+                                                firstTable, secondTable) &&
+                equal(first->getRight(), second->getRight(),
+                                                firstTable, secondTable);
+    }
+
+    // Match every operand with an unused equal one, hashes were equal so
+    // a mismatch is rare
+    std::vector<nodePtr> firstTerms;
+    std::vector<nodePtr> secondTerms;
+    operands(first, first->getStr(), firstTerms);
+    operands(second, second->getStr(), secondTerms);
+    if (firstTerms.size() != secondTerms.size())
+    {
+        return false;
+    }
+    std::vector<bool> used(secondTerms.size(), false);
+    for (const auto& term : firstTerms)
+    {
+        bool matched = false;
+        for (int idx = 0; idx < secondTerms.size() && !matched; idx++)
+        {
+            if (!used[idx] && equal(term, secondTerms[idx],
+                                                firstTable, secondTable))
+            {
+                used[idx] = true;
+                matched = true;
+            }
+        }
+        if (!matched)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::uint64_t Equivalence::ulpDistance(double first, double second)
+{
+    if (first == second)
+    {
+        return 0;
+    }
+    // Map doubles onto integers that are ordered the same way
+    auto ordered = [](double value) {
+        std::int64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? INT64_MIN - bits : bits;
+    };
+    std::int64_t firstBits = ordered(first);
+    std::int64_t secondBits = ordered(second);
+    return firstBits > secondBits ?
+            static_cast<std::uint64_t>(firstBits) - secondBits :
+            static_cast<std::uint64_t>(secondBits) - firstBits;
+}
+
+bool Equivalence::close(double first, double second, std::uint64_t ulps)
+{
+    return ulpDistance(first, second) <= ulps ||
+                    std::fabs(first - second) <= ulps * DBL_EPSILON;
+}
+
+bool Equivalence::equivalent(const nodePtr& first, const nodePtr& second,
+                        int samples, std::uint64_t ulps, std::uint64_t seed)
+{
+    if (samples <= 0)
+    {
+        throw std::invalid_argument("Equivalence needs a positive number "
+                                                            "of samples");
+    }
+    if (structurallyEqual(first, second))
+    {
+        return true;
+    }
+
+    FlatTree firstTree(first);
+    FlatTree secondTree(second);
+    std::vector<std::shared_ptr<Variable>> variables;
+    for (const auto* tree : {&firstTree, &secondTree})
+    {
+        for (const auto& var : tree->getVariables())
+        {
+            bool seen = false;
+            for (const auto& known : variables)
+            {
+                seen = seen || known->equals(var);
+            }
+            if (!seen)
+            {
+                variables.push_back(var);
+            }
+        }
+    }
+    std::vector<int> firstSlots;
+    std::vector<int> secondSlots;
+    for (const auto& var : variables)
+    {
+        firstSlots.push_back(firstTree.getSlot(var));
+        secondSlots.push_back(secondTree.getSlot(var));
+    }
+
+    // Half the points are positive, where ln, sqrt and friends are defined
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> positive(0.1, 3.0);
+    std::uniform_real_distribution<double> anywhere(-3.0, 3.0);
+    std::vector<double> points(samples * variables.size());
+    for (int idx = 0; idx < points.size(); idx++)
+    {
+        points[idx] = (idx / variables.size()) % 2 == 0 ? positive(engine) :
+                                                        anywhere(engine);
+    }
+
+    std::vector<double> firstResults(samples);
+    std::vector<double> secondResults(samples);
+    std::vector<double> firstValues(firstTree.getVariables().size(), 1.0);
+    std::vector<double> secondValues(secondTree.getVariables().size(), 1.0);
+    std::vector<double> scratch;
+    if (variables.size() <= 1)
+    {
+        // One variable: evaluate all points in one batch per tree
+        int firstSweep = variables.empty() ? -1 : firstSlots[0];
+        int secondSweep = variables.empty() ? -1 : secondSlots[0];
+        std::vector<double> sweep = variables.empty() ?
+                                std::vector<double>(samples, 0.0) : points;
+        firstTree.evaluate(firstValues.data(), firstSweep, sweep.data(),
+                                samples, firstResults.data(), scratch);
+        secondTree.evaluate(secondValues.data(), secondSweep, sweep.data(),
+                                samples, secondResults.data(), scratch);
+    }
+    else
+    {
+        for (int sample = 0; sample < samples; sample++)
+        {
+            for (int idx = 0; idx < variables.size(); idx++)
+            {
+                double value = points[sample * variables.size() + idx];
+                if (firstSlots[idx] != -1)
+                {
+                    firstValues[firstSlots[idx]] = value;
+                }
+                if (secondSlots[idx] != -1)
+                {
+                    secondValues[secondSlots[idx]] = value;
+                }
+            }
+            firstResults[sample] = firstTree.evaluate(firstValues.data(),
+                                                                    scratch);
+            secondResults[sample] = secondTree.evaluate(secondValues.data(),
+                                                                    scratch);
+        }
+    }
+
+    int informative = 0;
+    for (int sample = 0; sample < samples; sample++)
+    {
+        bool firstFinite = std::isfinite(firstResults[sample]);
+        bool secondFinite = std::isfinite(secondResults[sample]);
+        if (!firstFinite && !secondFinite)
+        {
+            continue;
+        }
+        if (firstFinite != secondFinite ||
+                !close(firstResults[sample], secondResults[sample], ulps))
+        {
+            return false;
+        }
+        informative++;
+    }
+    return informative * 4 >= samples;
+}
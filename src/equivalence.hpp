@@ -0,0 +1,76 @@
+#ifndef __EQUIVALENCE_HPP__
+#define __EQUIVALENCE_HPP__
+
+#include "expression_node.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Decides whether two expression trees describe the same function.
+ *
+ * @details Trees are first compared structurally, up to reordering the
+ * operands of chains of + and *. Only when that fails are both trees
+ * frozen and evaluated at random points, where results must agree to
+ * within a number of units in the last place. Trees passed in must be
+ * complete, as after TreeFixer::checkTree.
+ */
+class Equivalence
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+public:
+    //! Hash of every node visited, so sub-trees are only hashed once
+    typedef std::unordered_map<const ExpressionNode*, std::size_t> hashTable;
+
+    /**
+     * @brief Canonical structural hash: equal for trees that differ only
+     * in the order of the operands of + and *.
+     */
+    static std::size_t hash(const nodePtr& node);
+    static std::size_t hash(const nodePtr& node, hashTable& table);
+
+    /**
+     * @brief Structural equality up to reordering + and * operands.
+     */
+    static bool structurallyEqual(const nodePtr& first,
+                                                    const nodePtr& second);
+
+    /**
+     * @brief Structural check, then a randomized numeric check.
+     *
+     * @param samples points to evaluate at; at least a quarter of them
+     * must be inside the domain of both trees
+     * @param ulps allowed distance in units in the last place
+     * @param seed seed of the sample points, fixed for reproducible answers
+     * @throws std::invalid_argument unless samples is positive
+     */
+    static bool equivalent(const nodePtr& first, const nodePtr& second,
+                        int samples = 32, std::uint64_t ulps = 1024,
+                        std::uint64_t seed = 0x5eed);
+
+    /**
+     * @brief Number of doubles between first and second.
+     */
+    static std::uint64_t ulpDistance(double first, double second);
+
+    /**
+     * @brief Within ulps of each other, or both within ulps epsilons of
+     * zero, where cancellation leaves no relative precision.
+     */
+    static bool close(double first, double second, std::uint64_t ulps);
+
+private:
+    static void combine(std::size_t& hash, std::size_t value);
+    static bool isCommutative(const nodePtr& node);
+    static void operands(const nodePtr& node, const std::string& op,
+                                            std::vector<nodePtr>& out);
+    static double numberValue(const nodePtr& node);
+    static bool equal(const nodePtr& first, const nodePtr& second,
+                        hashTable& firstTable, hashTable& secondTable);
+};
+
+#endif // __EQUIVALENCE_HPP__
@@ -0,0 +1,522 @@
+#include "eval_optimizer.hpp"
+
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+// Entry builders that fold zeros, ones and double negation
+static bool isConstant(const Program& program, int idx, double value)
+{
+    OpCode code = program.getOpCode(idx);
+    return (code == OpCode::INTEGER || code == OpCode::REAL) &&
+                                            program.getValue(idx) == value;
+}
+
+static int negate(Program& program, int idx)
+{
+    OpCode code = program.getOpCode(idx);
+    if (code == OpCode::INTEGER || code == OpCode::REAL)
+    {
+        return program.constant(-program.getValue(idx));
+    }
+    if (code == OpCode::NEGATE)
+    {
+        return program.getLeft(idx);
+    }
+    return program.apply(OpCode::NEGATE, idx);
+}
+
+static int add(Program& program, int left, int right)
+{
+    if (isConstant(program, left, 0.0))
+    {
+        return right;
+    }
+    if (isConstant(program, right, 0.0))
+    {
+        return left;
+    }
+    return program.apply(OpCode::ADD, left, right);
+}
+
+static int subtract(Program& program, int left, int right)
+{
+    if (isConstant(program, right, 0.0))
+    {
+        return left;
+    }
+    if (isConstant(program, left, 0.0))
+    {
+        return negate(program, right);
+    }
+    return program.apply(OpCode::SUBTRACT, left, right);
+}
+
+static int multiply(Program& program, int left, int right)
+{
+    if (isConstant(program, left, 0.0) || isConstant(program, right, 0.0))
+    {
+        return program.constant(0.0);
+    }
+    if (isConstant(program, left, 1.0))
+    {
+        return right;
+    }
+    if (isConstant(program, right, 1.0))
+    {
+        return left;
+    }
+    if (isConstant(program, left, -1.0))
+    {
+        return negate(program, right);
+    }
+    if (isConstant(program, right, -1.0))
+    {
+        return negate(program, left);
+    }
+    return program.apply(OpCode::MULTIPLY, left, right);
+}
+
+static int divide(Program& program, int left, int right)
+{
+    if (isConstant(program, left, 0.0))
+    {
+        return left;
+    }
+    if (isConstant(program, right, 1.0))
+    {
+        return left;
+    }
+    return program.apply(OpCode::DIVIDE, left, right);
+}
+
+Program EvalOptimizer::compile(const nodePtr& root,
+                                    const std::shared_ptr<Variable>& var)
+{
+    return compile(NaryNode::build(root), var);
+}
+
+Program EvalOptimizer::compile(const naryPtr& root,
+                                    const std::shared_ptr<Variable>& var)
+{
+    Context context;
+    context.var = var;
+    if (var)
+    {
+        context.varNode = NaryNode::variable(var);
+    }
+    context.program.setOutput(emit(root, context));
+    return context.program;
+}
+
+int EvalOptimizer::emit(const naryPtr& node, Context& context)
+{
+    auto found = context.emitted.find(node);
+    if (found != context.emitted.end())
+    {
+        return found->second;
+    }
+    Program& program = context.program;
+    int idx;
+    if (node->isNumber())
+    {
+        idx = program.constant(node->getValue());
+    }
+    else if (node->isVariable())
+    {
+        idx = program.variable(
+                    std::dynamic_pointer_cast<Variable>(node->getToken()));
+    }
+    else if (node->isFunction())
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        int arg = emit(node->getOperands()[0], context);
+        double base = 10.0;
+        if (func->getSubscript())
+        {
+            auto subscript = func->getSubscript();
+            base = subscript->isInt() ? subscript->getInt() * 1.0 :
+                                        subscript->getDouble();
+        }
+        idx = program.apply(FlatTree::getFunctionCode(func->getStr()), arg,
+                                                                -1, base);
+    }
+    else if (node->isPower())
+    {
+        idx = emitPower(node->getOperands()[0], node->getOperands()[1],
+                                                                context);
+    }
+    else if (node->isProduct())
+    {
+        idx = emitProduct(node, context);
+    }
+    else
+    {
+        idx = emitHorner(node, context);
+    }
+    context.emitted.emplace(node, idx);
+    return idx;
+}
+
+int EvalOptimizer::emitPower(const naryPtr& base, const naryPtr& exponent,
+                                                        Context& context)
+{
+    if (exponent->isNumber())
+    {
+        double value = exponent->getValue();
+        if (std::fabs(value) <= MAX_CHAIN_POWER)
+        {
+            if (std::floor(value) == value)
+            {
+                return emitIntegerPower(emit(base, context),
+                                static_cast<long long>(value), context);
+            }
+            // x^(k/2) is sqrt(x)^k
+            if (std::floor(2 * value) == 2 * value)
+            {
+                int root = context.program.apply(OpCode::SQRT,
+                                                    emit(base, context));
+                return emitIntegerPower(root,
+                                static_cast<long long>(2 * value), context);
+            }
+        }
+    }
+    return context.program.apply(OpCode::POWER, emit(base, context),
+                                                emit(exponent, context));
+}
+
+int EvalOptimizer::emitIntegerPower(int base, long long exponent,
+                                                        Context& context)
+{
+    Program& program = context.program;
+    if (exponent == 0)
+    {
+        return program.constant(1.0);
+    }
+    if (exponent < 0)
+    {
+        return program.apply(OpCode::DIVIDE, program.constant(1.0),
+                            emitIntegerPower(base, -exponent, context));
+    }
+    // Repeated squaring, x^5 is x * (x^2)^2
+    int out = -1;
+    int square = base;
+    while (exponent > 0)
+    {
+        if (exponent & 1)
+        {
+            out = out == -1 ? square :
+                        program.apply(OpCode::MULTIPLY, out, square);
+        }
+        exponent >>= 1;
+        if (exponent > 0)
+        {
+            square = program.apply(OpCode::MULTIPLY, square, square);
+        }
+    }
+    return out;
+}
+
+int EvalOptimizer::emitProduct(const naryPtr& node, Context& context)
+{
+    Program& program = context.program;
+    bool negate = false;
+    int numerator = -1;
+    int denominator = -1;
+    for (const auto& factor : node->getOperands())
+    {
+        if (factor->isNumber() && factor->getValue() == -1.0)
+        {
+            negate = true;
+            continue;
+        }
+        bool inverse = factor->isPower() &&
+                        factor->getOperands()[1]->isNumber() &&
+                        factor->getOperands()[1]->getValue() < 0;
+        int& target = inverse ? denominator : numerator;
+        int idx = inverse ? emit(NaryNode::power(factor->getOperands()[0],
+                    NaryNode::number(-factor->getOperands()[1]->getValue())),
+                                                                context) :
+                            emit(factor, context);
+        target = target == -1 ? idx :
+                        program.apply(OpCode::MULTIPLY, target, idx);
+    }
+    int out = numerator == -1 ? program.constant(1.0) : numerator;
+    if (denominator != -1)
+    {
+        out = program.apply(OpCode::DIVIDE, out, denominator);
+    }
+    return negate ? program.apply(OpCode::NEGATE, out) : out;
+}
+
+bool EvalOptimizer::isNegative(const naryPtr& term, naryPtr& positive)
+{
+    bool negative = term->isNumber() ? term->getValue() < 0 :
+                    term->isProduct() &&
+                    term->getOperands()[0]->isNumber() &&
+                    term->getOperands()[0]->getValue() < 0;
+    positive = negative ?
+                NaryNode::product({NaryNode::number(-1.0), term}) : term;
+    return negative;
+}
+
+int EvalOptimizer::emitSum(const std::vector<naryPtr>& terms, int start,
+                                                        Context& context)
+{
+    Program& program = context.program;
+    // Additions first, then the subtractions
+    std::vector<int> subtracted;
+    int out = start;
+    for (const auto& term : terms)
+    {
+        naryPtr positive;
+        bool negative = isNegative(term, positive);
+        int idx = emit(positive, context);
+        if (negative)
+        {
+            subtracted.push_back(idx);
+        }
+        else
+        {
+            out = out == -1 ? idx : program.apply(OpCode::ADD, out, idx);
+        }
+    }
+    for (int idx : subtracted)
+    {
+        out = out == -1 ? program.apply(OpCode::NEGATE, idx) :
+                            program.apply(OpCode::SUBTRACT, out, idx);
+    }
+    return out;
+}
+
+int EvalOptimizer::degree(const naryPtr& term, Context& context,
+                                                    naryPtr& coefficient)
+{
+    const auto& var = context.varNode;
+    auto power = [&var](const naryPtr& factor) {
+        if (factor->equals(*var))
+        {
+            return 1;
+        }
+        if (factor->isPower() && factor->getOperands()[0]->equals(*var) &&
+                                    factor->getOperands()[1]->isNumber())
+        {
+            double exponent = factor->getOperands()[1]->getValue();
+            if (exponent > 0 && std::floor(exponent) == exponent &&
+                                            exponent <= MAX_CHAIN_POWER)
+            {
+                return static_cast<int>(exponent);
+            }
+        }
+        return 0;
+    };
+
+    int out = power(term);
+    if (out > 0)
+    {
+        coefficient = NaryNode::number(1.0);
+        return out;
+    }
+    if (!term->hasVariable(context.var))
+    {
+        coefficient = term;
+        return 0;
+    }
+    if (!term->isProduct())
+    {
+        return -1;
+    }
+    std::vector<naryPtr> others;
+    for (const auto& factor : term->getOperands())
+    {
+        int factorPower = power(factor);
+        if (factorPower > 0 && out == 0)
+        {
+            out = factorPower;
+        }
+        else if (factor->hasVariable(context.var))
+        {
+            return -1;
+        }
+        else
+        {
+            others.push_back(factor);
+        }
+    }
+    coefficient = NaryNode::product(others);
+    return out;
+}
+
+int EvalOptimizer::emitHorner(const naryPtr& node, Context& context)
+{
+    const auto& terms = node->getOperands();
+    if (!context.var)
+    {
+        return emitSum(terms, -1, context);
+    }
+    std::map<int, std::vector<naryPtr>> polynomial;
+    std::vector<naryPtr> others;
+    for (const auto& term : terms)
+    {
+        naryPtr coefficient;
+        int power = degree(term, context, coefficient);
+        if (power == -1)
+        {
+            others.push_back(term);
+        }
+        else
+        {
+            polynomial[power].push_back(coefficient);
+        }
+    }
+    if (polynomial.size() < 2 || polynomial.rbegin()->first < 2)
+    {
+        return emitSum(terms, -1, context);
+    }
+
+    // c_n x^n + ... + c_0 is (((c_n) x^(n - m) + c_m) x^(m - l) + ...)
+    Program& program = context.program;
+    int var = program.variable(context.var);
+    int out = -1;
+    int previous = 0;
+    for (auto group = polynomial.rbegin(); group != polynomial.rend();
+                                                                    group++)
+    {
+        if (out != -1)
+        {
+            out = multiply(program, out,
+                emitIntegerPower(var, previous - group->first, context));
+        }
+        out = emitSum(group->second, out, context);
+        previous = group->first;
+    }
+    if (previous > 0)
+    {
+        out = multiply(program, out,
+                                emitIntegerPower(var, previous, context));
+    }
+    return emitSum(others, out, context);
+}
+
+int EvalOptimizer::differentiate(Program& program, int output,
+                                    const std::shared_ptr<Variable>& var)
+{
+    if (output < 0 || output >= program.size())
+    {
+        throw std::runtime_error("No such entry to differentiate");
+    }
+    int slot = program.getSlot(var);
+    int zero = program.constant(0.0);
+    // Derivative entry of every entry up to the output
+    std::vector<int> derivatives(output + 1, zero);
+    for (int idx = 0; idx <= output; idx++)
+    {
+        OpCode code = program.getOpCode(idx);
+        if (code == OpCode::VARIABLE)
+        {
+            if (program.getSymbol(idx) == slot)
+            {
+                derivatives[idx] = program.constant(1.0);
+            }
+            continue;
+        }
+        int left = program.getLeft(idx);
+        int right = program.getRight(idx);
+        int leftDerivative = left == -1 ? zero : derivatives[left];
+        int rightDerivative = right == -1 ? zero : derivatives[right];
+        if (leftDerivative == zero && rightDerivative == zero)
+        {
+            continue;
+        }
+        int out;
+        switch (code)
+        {
+            case OpCode::NEGATE:
+                out = negate(program, leftDerivative);
+                break;
+            case OpCode::ADD:
+                out = add(program, leftDerivative, rightDerivative);
+                break;
+            case OpCode::SUBTRACT:
+                out = subtract(program, leftDerivative, rightDerivative);
+                break;
+            case OpCode::MULTIPLY:
+                out = add(program, multiply(program, leftDerivative, right),
+                            multiply(program, left, rightDerivative));
+                break;
+            case OpCode::DIVIDE:
+                // (u/v)' = (u' - (u/v)v') / v, reusing the quotient
+                out = divide(program, subtract(program, leftDerivative,
+                            multiply(program, idx, rightDerivative)), right);
+                break;
+            case OpCode::POWER:
+                if (program.getOpCode(right) == OpCode::INTEGER ||
+                        program.getOpCode(right) == OpCode::REAL)
+                {
+                    // u^c' = c u^(c-1) u', defined at u = 0
+                    double exponent = program.getValue(right);
+                    int lowered = exponent == 2.0 ? left :
+                            program.apply(OpCode::POWER, left,
+                                        program.constant(exponent - 1.0));
+                    out = multiply(program, multiply(program,
+                                program.constant(exponent), lowered),
+                                leftDerivative);
+                }
+                else
+                {
+                    // (u^v)' = u^v (v' ln(u) + v u'/u)
+                    out = multiply(program, idx, add(program,
+                        multiply(program, rightDerivative,
+                                    program.apply(OpCode::LN, left)),
+                        divide(program,
+                                multiply(program, right, leftDerivative),
+                                left)));
+                }
+                break;
+            case OpCode::SQRT:
+                out = divide(program, leftDerivative, multiply(program,
+                                                program.constant(2.0), idx));
+                break;
+            case OpCode::SIN:
+                out = multiply(program, program.apply(OpCode::COS, left),
+                                                            leftDerivative);
+                break;
+            case OpCode::COS:
+                out = negate(program, multiply(program,
+                        program.apply(OpCode::SIN, left), leftDerivative));
+                break;
+            case OpCode::TAN:
+                // sec^2 as 1 + tan^2, reusing the tangent
+                out = multiply(program, add(program, program.constant(1.0),
+                            multiply(program, idx, idx)), leftDerivative);
+                break;
+            case OpCode::COT:
+                out = negate(program, multiply(program,
+                            add(program, program.constant(1.0),
+                            multiply(program, idx, idx)), leftDerivative));
+                break;
+            case OpCode::SEC:
+                out = multiply(program, multiply(program, idx,
+                            program.apply(OpCode::TAN, left)), leftDerivative);
+                break;
+            case OpCode::CSC:
+                out = negate(program, multiply(program, multiply(program, idx,
+                            program.apply(OpCode::COT, left)), leftDerivative));
+                break;
+            case OpCode::EXP:
+                out = multiply(program, idx, leftDerivative);
+                break;
+            case OpCode::LN:
+                out = divide(program, leftDerivative, left);
+                break;
+            case OpCode::LOG:
+                out = divide(program, leftDerivative, multiply(program, left,
+                            program.constant(std::log(program.getValue(idx)))));
+                break;
+            default:
+                throw std::runtime_error("Cannot differentiate entry");
+        }
+        derivatives[idx] = out;
+    }
+    return derivatives[output];
+}
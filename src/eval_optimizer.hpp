@@ -0,0 +1,97 @@
+#ifndef __EVAL_OPTIMIZER_HPP__
+#define __EVAL_OPTIMIZER_HPP__
+
+#include "expression_node.hpp"
+#include "nary_node.hpp"
+#include "program.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Compiles an expression into a Program that is cheap to evaluate.
+ *
+ * @details The tree is first made canonical as a NaryNode, which folds
+ * constants and collects like terms and factors. It is then emitted:
+ *  - sums that are polynomials of degree 2 or more in var are put in
+ *    Horner form, with gaps between degrees bridged by one power;
+ *  - integer powers up to MAX_CHAIN_POWER become chains of
+ *    multiplications by repeated squaring, and halves go through sqrt;
+ *  - every product becomes one division at most, and every sum one
+ *    chain of additions followed by one chain of subtractions;
+ *  - identical sub-expressions, wherever they occur, are computed once.
+ * Results match the tree up to rounding. They can differ where the
+ * canonical form cancels something undefined, x/x being 1 at x = 0.
+ */
+class EvalOptimizer
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+    typedef NaryNode::naryPtr naryPtr;
+public:
+    //! Largest integer exponent turned into multiplications
+    static const int MAX_CHAIN_POWER = 64;
+
+    /**
+     * @brief Compiles a complete tree, as after TreeFixer::checkTree.
+     *
+     * @param var the variable polynomials are arranged in, null to skip
+     * Horner form.
+     */
+    static Program compile(const nodePtr& root,
+                                    const std::shared_ptr<Variable>& var);
+    static Program compile(const naryPtr& root,
+                                    const std::shared_ptr<Variable>& var);
+
+    /**
+     * @brief Appends the derivative of an entry with respect to var.
+     *
+     * @details Differentiates the program entry by entry in forward
+     * mode, so the derivative reuses the entries of the function and
+     * adds a bounded number of entries for each one: its size grows
+     * linearly with the program, never with the expanded tree. Zeros
+     * and ones are folded away as they appear.
+     * @return the entry holding the derivative.
+     */
+    static int differentiate(Program& program, int output,
+                                    const std::shared_ptr<Variable>& var);
+
+private:
+    struct Context
+    {
+        Program program;
+        std::shared_ptr<Variable> var;
+        naryPtr varNode;
+        //! Program entry of every node emitted so far, keeping it alive
+        std::unordered_map<naryPtr, int> emitted;
+    };
+
+    static int emit(const naryPtr& node, Context& context);
+    static int emitPower(const naryPtr& base, const naryPtr& exponent,
+                                                        Context& context);
+    static int emitIntegerPower(int base, long long exponent,
+                                                        Context& context);
+    static int emitProduct(const naryPtr& node, Context& context);
+    /**
+     * @brief Adds terms to the entry start, or to nothing if start is -1.
+     */
+    static int emitSum(const std::vector<naryPtr>& terms, int start,
+                                                        Context& context);
+    static int emitHorner(const naryPtr& node, Context& context);
+
+    /**
+     * @brief Whether term carries a negative coefficient, and the term
+     * without it.
+     */
+    static bool isNegative(const naryPtr& term, naryPtr& positive);
+
+    /**
+     * @brief Splits term into coefficient * var^degree.
+     *
+     * @return the degree, -1 if var appears other than as a whole power.
+     */
+    static int degree(const naryPtr& term, Context& context,
+                                                    naryPtr& coefficient);
+};
+
+#endif // __EVAL_OPTIMIZER_HPP__
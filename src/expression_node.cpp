@@ -10,6 +10,7 @@
 #include "token_queue.hpp"
 #include "tree_fixer.hpp"
 #include "latex_converter.hpp"
+#include "limit_guard.hpp"
 
 #include <memory>
 #include <string>
@@ -22,6 +23,7 @@
   */
 ExpressionNode::ExpressionNode()
 {
+    LimitGuard::countNode();
     this->token = nullptr;
     this->leftChild = nullptr;
     this->rightChild = nullptr;
@@ -35,36 +37,19 @@ ExpressionNode::ExpressionNode()
  */
 ExpressionNode::ExpressionNode(std::shared_ptr<Token> token)
 {
-    this->token = token;
+    LimitGuard::countNode();
+    this->token = std::move(token);
     this->leftChild = nullptr;
     this->rightChild = nullptr;
 }
 
 
-/**
- * @brief Gets the parent of the node.
- *
- * @return A weak pointer to the parent node.
- */
-std::weak_ptr<ExpressionNode> ExpressionNode::getParent()
-{
-    return this->parent;
-}
-
-/**
- * @brief Removes the reference to the parent node.
- */
-void ExpressionNode::removeParent()
-{
-    this->parent.reset();
-}
-
 /**
  * @brief Gets the right child of the node.
  *
  * @return A shared pointer to the right child node.
  */
-std::shared_ptr<ExpressionNode> ExpressionNode::getRight()
+const std::shared_ptr<ExpressionNode>& ExpressionNode::getRight() const
 {
     return this->rightChild;
 }
@@ -74,7 +59,7 @@ std::shared_ptr<ExpressionNode> ExpressionNode::getRight()
  *
  * @return A shared pointer to the left child node.
  */
-std::shared_ptr<ExpressionNode> ExpressionNode::getLeft()
+const std::shared_ptr<ExpressionNode>& ExpressionNode::getLeft() const
 {
     return this->leftChild;
 }
@@ -86,14 +71,14 @@ std::shared_ptr<ExpressionNode> ExpressionNode::getLeft()
  */
 void ExpressionNode::setToken(std::shared_ptr<Token> token)
 {
-    this->token = token;
+    this->token = std::move(token);
 }
 /**
  * @brief Gets the token represented by this node.
  *
  * @return A shared pointer to the token.
  */
-std::shared_ptr<Token> ExpressionNode::getToken()
+const std::shared_ptr<Token>& ExpressionNode::getToken() const
 {
     return this->token;
 }
@@ -103,7 +88,7 @@ std::shared_ptr<Token> ExpressionNode::getToken()
  *
  * @return The TokenType of the node's token.
  */
-TokenType ExpressionNode::getType()
+TokenType ExpressionNode::getType() const
 {
     return this->token->getType();
 }
@@ -127,24 +112,11 @@ Associativity ExpressionNode::getAssociativity()
  *
  * @return A string representing the token.
  */
-std::string ExpressionNode::getStr()
+const std::string& ExpressionNode::getStr() const
 {
     return this->token->getStr();
 }
 
-/**
- * @brief Sets the parent node of this node.
- *
- * @param parent A weak pointer to the parent node.
- */
-void ExpressionNode::setParent(std::weak_ptr<ExpressionNode> parent)
-{
-    if(this)
-    {
-        this->parent = parent;
-    }
-}
-
 /**
  * @brief Removes the left child of this node.
  *
@@ -153,7 +125,6 @@ void ExpressionNode::setParent(std::weak_ptr<ExpressionNode> parent)
 std::shared_ptr<ExpressionNode> ExpressionNode::removeLeftChild()
 {
     std::shared_ptr<ExpressionNode> child = this->leftChild;
-    this->leftChild->removeParent();
     this->leftChild = nullptr;
     return child;
 }
@@ -166,7 +137,6 @@ std::shared_ptr<ExpressionNode> ExpressionNode::removeLeftChild()
 std::shared_ptr<ExpressionNode> ExpressionNode::removeRightChild()
 {
     std::shared_ptr<ExpressionNode> child = this->rightChild;
-    this->rightChild->removeParent();
     this->rightChild = nullptr;
     return child;
 }
@@ -181,11 +151,10 @@ std::shared_ptr<ExpressionNode> ExpressionNode::removeRightChild()
  * @return A shared pointer to the newly set left child.
  * @return nullptr if a left child already exists.
  */
-std::shared_ptr<ExpressionNode> ExpressionNode::setLeft(
+const std::shared_ptr<ExpressionNode>& ExpressionNode::setLeft(
                         std::shared_ptr<ExpressionNode> node)
 {
-    this->leftChild = node;
-    this->leftChild->setParent(weak_from_this());
+    this->leftChild = std::move(node);
     return this->leftChild;
 }
 
@@ -199,11 +168,10 @@ std::shared_ptr<ExpressionNode> ExpressionNode::setLeft(
  * @return A shared pointer to the newly set right child.
  * @return nullptr if a right child already exists.
  */
-std::shared_ptr<ExpressionNode> ExpressionNode::setRight(
+const std::shared_ptr<ExpressionNode>& ExpressionNode::setRight(
                             std::shared_ptr<ExpressionNode> node)
 {
-   this->rightChild = node;
-    this->rightChild->setParent(weak_from_this());
+    this->rightChild = std::move(node);
     return this->rightChild;
 }
 
@@ -247,7 +215,7 @@ void ExpressionNode::swapChildren()
      * @return true if the variable is found
      * @return false otherwise
      */
-bool ExpressionNode::hasVariable(const std::shared_ptr<Variable> var)
+bool ExpressionNode::hasVariable(const std::shared_ptr<Variable>& var) const
 {
     if (this->getType() == TokenType::VARIABLE)
     {
@@ -287,10 +255,10 @@ bool ExpressionNode::hasVariable(const std::shared_ptr<Variable> var)
  * @param node A shared pointer to the node to set as the derivative root.
  * @return A shared pointer to the newly set derivative root.
  */
-std::shared_ptr<ExpressionNode> ExpressionNode::setDerivative(
+const std::shared_ptr<ExpressionNode>& ExpressionNode::setDerivative(
                             std::shared_ptr<ExpressionNode> node)
 {
-    this->derivative = node;//TreeFixer::simplify(node);
+    this->derivative = std::move(node);//TreeFixer::simplify(node);
     return this->derivative;
 }
 
@@ -300,13 +268,9 @@ std::shared_ptr<ExpressionNode> ExpressionNode::setDerivative(
  * @return A shared pointer to the derivative root of the node.
  * @return nullptr if it does not exist
  */
-std::shared_ptr<ExpressionNode> ExpressionNode::getDerivative()
+const std::shared_ptr<ExpressionNode>& ExpressionNode::getDerivative() const
 {
-    if(this->derivative)
-    {
-        return this->derivative;
-    }
-    return nullptr;
+    return this->derivative;
 }
 
 /**
@@ -391,6 +355,34 @@ std::shared_ptr<ExpressionNode> ExpressionNode::copyTree()
     }
     return copy;
 }
+std::shared_ptr<ExpressionNode> ExpressionNode::cloneTree()
+{
+    auto copy = std::make_shared<ExpressionNode>(this->token->clone());
+    if (this->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(this->getToken());
+        auto funcCopy = std::dynamic_pointer_cast<Function>(copy->getToken());
+        // Keep the argument shared between the token and the left child
+        if (this->getLeft() && this->getLeft() == func->getSubExprTree())
+        {
+            copy->setLeft(funcCopy->getSubExprTree());
+        }
+        else if (this->getLeft())
+        {
+            copy->setLeft(this->getLeft()->cloneTree());
+        }
+    }
+    else if (this->getLeft())
+    {
+        copy->setLeft(this->getLeft()->cloneTree());
+    }
+    if (this->getRight())
+    {
+        copy->setRight(this->getRight()->cloneTree());
+    }
+    return copy;
+}
+
 void ExpressionNode::copyNode(std::shared_ptr<ExpressionNode> src)
 {
     this->setToken(src->getToken());
@@ -9,10 +9,19 @@
 #define __EXPRESSION_NODE_HPP__
 
 #include "token.hpp"
+#include "result.hpp"
 
 #include <memory>
+#include <string>
 #include <vector>
 
+/**
+ * @brief A node of the expression tree.
+ *
+ * @details Nodes only link to their children. TreeFixer::simplify shares
+ * untouched sub-trees between its input and output, so a node can hang
+ * under several parents and has no single one to point back to.
+ */
 class ExpressionNode : public std::enable_shared_from_this<ExpressionNode>
 {
 public:
@@ -45,6 +54,15 @@ public:
      */
     static std::shared_ptr<ExpressionNode> buildTree(TokenQueue queue);
 
+    /**
+     * @brief Tokenizes, converts and builds the tree for input, then runs
+     * TreeFixer::checkTree on it.
+     *
+     * @return the root, or the SYNTAX error of the step that failed
+     */
+    static Result<std::shared_ptr<ExpressionNode>> tryParse(
+                                                const std::string& input);
+
     /**
      * @brief Adds a child node to this node.
      *
@@ -68,7 +86,7 @@ public:
      * @return A shared pointer to the newly set left child.
      * @return nullptr if a left child already exists.
      */
-    std::shared_ptr<ExpressionNode> setLeft(
+    const std::shared_ptr<ExpressionNode>& setLeft(
                             std::shared_ptr<ExpressionNode> node);
 
     /**
@@ -81,7 +99,7 @@ public:
      * @return A shared pointer to the newly set right child.
      * @return nullptr if a right child already exists.
      */
-    std::shared_ptr<ExpressionNode> setRight(
+    const std::shared_ptr<ExpressionNode>& setRight(
                             std::shared_ptr<ExpressionNode> node);
 
     /**
@@ -90,18 +108,6 @@ public:
      */
     void swapChildren();
 
-    /**
-     * @brief Sets the parent node of this node.
-     *
-     * @param parent A weak pointer to the parent node.
-     */
-    void setParent(std::weak_ptr<ExpressionNode> parent);
-
-    /**
-     * @brief Removes the reference to the parent node.
-     */
-    void removeParent();
-
     /**
      * @brief Removes the left child of this node.
      *
@@ -116,26 +122,21 @@ public:
      */
     std::shared_ptr<ExpressionNode> removeRightChild();
 
-    /**
-     * @brief Gets the parent of the node.
-     *
-     * @return A weak pointer to the parent node.
-     */
-    std::weak_ptr<ExpressionNode> getParent();
-
     /**
      * @brief Gets the right child of the node.
      *
-     * @return A shared pointer to the right child node.
+     * @return A shared pointer to the right child node, valid until the
+     * child is replaced. Copy it to keep the child.
      */
-    std::shared_ptr<ExpressionNode> getRight();
+    const std::shared_ptr<ExpressionNode>& getRight() const;
 
     /**
      * @brief Gets the left child of the node.
      *
-     * @return A shared pointer to the left child node.
+     * @return A shared pointer to the left child node, valid until the
+     * child is replaced. Copy it to keep the child.
      */
-    std::shared_ptr<ExpressionNode> getLeft();
+    const std::shared_ptr<ExpressionNode>& getLeft() const;
     
     /**
      * @brief Set the Token object
@@ -146,9 +147,9 @@ public:
     /**
      * @brief Gets the token represented by this node.
      *
-     * @return A shared pointer to the token.
+     * @return A shared pointer to the token, valid until setToken.
      */
-    std::shared_ptr<Token> getToken();
+    const std::shared_ptr<Token>& getToken() const;
 
     /**
      * @brief Gets the precedence of the token represented by this node.
@@ -163,7 +164,7 @@ public:
      *
      * @return The TokenType of the node's token.
      */
-    TokenType getType();
+    TokenType getType() const;
 
     /**
      * @brief Gets the associativity of the token represented by this node.
@@ -174,9 +175,9 @@ public:
     /**
      * @brief Gets the string representation of the token.
      *
-     * @return A string representing the token.
+     * @return A string representing the token, valid until setToken.
      */
-    std::string getStr();
+    const std::string& getStr() const;
     
     /**
      * @brief checks if subtree of node contains a given variable
@@ -185,7 +186,7 @@ public:
      * @return true if the variable is found
      * @return false otherwise
      */
-    bool hasVariable(const std::shared_ptr<Variable> var);
+    bool hasVariable(const std::shared_ptr<Variable>& var) const;
 
     /**
      * @brief Sets the derivative of this node.
@@ -193,7 +194,7 @@ public:
      * @param node A shared pointer to the node to set as the derivative root.
      * @return A shared pointer to the newly set derivative root.
      */
-    std::shared_ptr<ExpressionNode> setDerivative(
+    const std::shared_ptr<ExpressionNode>& setDerivative(
                             std::shared_ptr<ExpressionNode> node);
     /**
      * @brief Sets the derivative of this node when it is a single token.
@@ -209,7 +210,7 @@ public:
      * @return A shared pointer to the derivative root of the node.
      * @return nullptr if it does not exist
      */
-    std::shared_ptr<ExpressionNode> getDerivative();
+    const std::shared_ptr<ExpressionNode>& getDerivative() const;
     
     /**
      * @brief checks if the node is a leaf node
@@ -224,12 +225,22 @@ public:
     static std::vector<std::shared_ptr<ExpressionNode>>
         getLeaves(std::shared_ptr<ExpressionNode>& root);
     std::shared_ptr<ExpressionNode> copyTree();
+
+    /**
+     * @brief Deep copy of the tree that shares nothing with the original.
+     *
+     * @details Unlike copyTree, tokens (and function subexpression trees)
+     * are copied as well and cached derivatives are dropped, so the copy
+     * can be modified on another thread.
+     *
+     * @return the root of the copy
+     */
+    std::shared_ptr<ExpressionNode> cloneTree();
     void copyNode(std::shared_ptr<ExpressionNode> src);
     void printTree(int depth = 0);
     void printFuncTree(std::shared_ptr<Function> func, int depth);
 protected:
     std::shared_ptr<Token> token;
-    std::weak_ptr<ExpressionNode> parent;
     std::shared_ptr<ExpressionNode> leftChild;
     std::shared_ptr<ExpressionNode> rightChild;
     std::shared_ptr<ExpressionNode> derivative;
@@ -1,6 +1,9 @@
 #include "expression_node.hpp"
 #include "token_queue.hpp"
 #include "lookup.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
 
 #include <stack>
 #include <iostream>
@@ -88,4 +91,22 @@ std::shared_ptr<ExpressionNode> ExpressionNode::buildTree(TokenQueue queue)
     }
     
         return nullptr; // In case the queue was empty
+}
+
+Result<std::shared_ptr<ExpressionNode>> ExpressionNode::tryParse(
+                                                    const std::string& input)
+{
+    Tokenizer parser(input);
+    auto parsed = parser.tryTokenize();
+    if (!parsed.ok())
+    {
+        return parsed.error();
+    }
+    ShuntingYard converter(parsed.value());
+    auto postfix = converter.tryPostfix();
+    if (!postfix.ok())
+    {
+        return postfix.error();
+    }
+    return TreeFixer::tryCheckTree(buildTree(std::move(postfix.value())));
 }
\ No newline at end of file
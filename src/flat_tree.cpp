@@ -0,0 +1,668 @@
+#include "flat_tree.hpp"
+#include "token_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+FlatTree::FlatTree(nodePtr root)
+{
+    if (root)
+    {
+        this->freeze(root);
+    }
+}
+
+int FlatTree::freeze(nodePtr node)
+{
+    if (!node)
+    {
+        throw std::runtime_error("Cannot freeze an empty subtree");
+    }
+    auto token = node->getToken();
+    int idx = -1;
+    if (node->getType() == TokenType::NUMBER)
+    {
+        auto num = std::dynamic_pointer_cast<Number>(token);
+        int symbol = this->addString(num->getFullStr());
+        if (num->isInt())
+        {
+            return this->addEntry(OpCode::INTEGER, -1, -1, -1,
+                                        num->getInt() * 1.0, symbol);
+        }
+        return this->addEntry(OpCode::REAL, -1, -1, -1,
+                                        num->getDouble(), symbol);
+    }
+    else if (node->getType() == TokenType::VARIABLE)
+    {
+        auto var = std::dynamic_pointer_cast<Variable>(token);
+        idx = this->addEntry(OpCode::VARIABLE, -1, -1, -1, 0.0,
+                                                this->addVariable(var));
+    }
+    else if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        int arg = this->freeze(func->getSubExprTree());
+        double base = 10.0;
+        if (func->getSubscript())
+        {
+            auto subscript = func->getSubscript();
+            base = subscript->isInt() ? subscript->getInt() * 1.0 :
+                                        subscript->getDouble();
+        }
+        int subscript = func->getSubscript() ?
+                this->addString(func->getSubscript()->getFullStr()) : -1;
+        idx = this->addEntry(getFunctionCode(func->getStr()), arg, -1,
+                                        this->firsts[arg], base, subscript);
+    }
+    else if (node->getType() == TokenType::OPERATOR)
+    {
+        int left = this->freeze(node->getLeft());
+        int right = this->freeze(node->getRight());
+        OpCode code;
+        std::string op = node->getStr();
+        if (op == "+")
+        {
+            code = OpCode::ADD;
+        }
+        else if (op == "-")
+        {
+            code = OpCode::SUBTRACT;
+        }
+        else if (op == "*")
+        {
+            code = OpCode::MULTIPLY;
+        }
+        else if (op == "/")
+        {
+            code = OpCode::DIVIDE;
+        }
+        else if (op == "^")
+        {
+            code = OpCode::POWER;
+        }
+        else
+        {
+            throw std::runtime_error("Cannot freeze operator " + op);
+        }
+        idx = this->addEntry(code, left, right, this->firsts[left], 0.0, -1);
+    }
+    else
+    {
+        throw std::runtime_error("Cannot freeze token " + node->getStr());
+    }
+
+    if (token->isNegative())
+    {
+        idx = this->addEntry(OpCode::NEGATE, idx, -1, this->firsts[idx],
+                                                                0.0, -1);
+    }
+    return idx;
+}
+
+int FlatTree::addEntry(OpCode code, int left, int right, int first,
+                                                double value, int symbol)
+{
+    int idx = this->opcodes.size();
+    this->opcodes.push_back(code);
+    this->lefts.push_back(left);
+    this->rights.push_back(right);
+    this->firsts.push_back(first == -1 ? idx : first);
+    this->values.push_back(value);
+    this->symbols.push_back(symbol);
+    return idx;
+}
+
+int FlatTree::addString(const std::string& str)
+{
+    this->strings.push_back(str);
+    return this->strings.size() - 1;
+}
+
+int FlatTree::addVariable(std::shared_ptr<Variable> var)
+{
+    int slot = this->getSlot(var);
+    if (slot != -1)
+    {
+        return slot;
+    }
+    // Store an unsigned copy, the sign lives in a NEGATE entry
+    auto copy = std::make_shared<Variable>(var->getStr());
+    copy->setSubscript(var->getSubscript());
+    this->variables.push_back(copy);
+    return this->variables.size() - 1;
+}
+
+int FlatTree::size() const
+{
+    return this->opcodes.size();
+}
+
+int FlatTree::root() const
+{
+    return this->size() - 1;
+}
+
+OpCode FlatTree::getOpCode(int idx) const
+{
+    return this->opcodes[idx];
+}
+
+int FlatTree::getLeft(int idx) const
+{
+    return this->lefts[idx];
+}
+
+int FlatTree::getRight(int idx) const
+{
+    return this->rights[idx];
+}
+
+int FlatTree::getFirst(int idx) const
+{
+    return this->firsts[idx];
+}
+
+double FlatTree::getValue(int idx) const
+{
+    return this->values[idx];
+}
+
+int FlatTree::getSymbol(int idx) const
+{
+    return this->symbols[idx];
+}
+
+std::string FlatTree::getString(int idx) const
+{
+    if (this->opcodes[idx] == OpCode::VARIABLE)
+    {
+        return this->variables[this->symbols[idx]]->getFullStr();
+    }
+    if (this->symbols[idx] == -1)
+    {
+        return "";
+    }
+    return this->strings[this->symbols[idx]];
+}
+
+const std::vector<OpCode>& FlatTree::getOpCodes() const
+{
+    return this->opcodes;
+}
+
+const std::vector<std::int32_t>& FlatTree::getLefts() const
+{
+    return this->lefts;
+}
+
+const std::vector<std::int32_t>& FlatTree::getRights() const
+{
+    return this->rights;
+}
+
+const std::vector<double>& FlatTree::getValues() const
+{
+    return this->values;
+}
+
+const std::vector<std::int32_t>& FlatTree::getSymbols() const
+{
+    return this->symbols;
+}
+
+const std::vector<std::shared_ptr<Variable>>& FlatTree::getVariables() const
+{
+    return this->variables;
+}
+
+int FlatTree::getSlot(const std::shared_ptr<Variable> var) const
+{
+    for (int slot = 0; slot < this->variables.size(); slot++)
+    {
+        if (this->variables[slot]->equals(var))
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+bool FlatTree::hasVariable(const std::shared_ptr<Variable> var) const
+{
+    return this->getSlot(var) != -1;
+}
+
+bool FlatTree::hasVariable(const std::shared_ptr<Variable> var, int idx) const
+{
+    int slot = this->getSlot(var);
+    if (slot == -1)
+    {
+        return false;
+    }
+    for (int current = this->firsts[idx]; current <= idx; current++)
+    {
+        if (this->opcodes[current] == OpCode::VARIABLE &&
+                this->symbols[current] == slot)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+double FlatTree::evaluate(const double* slots) const
+{
+    std::vector<double> scratch;
+    return this->evaluate(slots, scratch);
+}
+
+double FlatTree::evaluate(const double* slots,
+                                    std::vector<double>& scratch) const
+{
+    int count = this->size();
+    if (count == 0)
+    {
+        throw std::runtime_error("Cannot evaluate an empty tree");
+    }
+    scratch.resize(count);
+    return evaluate(count, this->opcodes.data(), this->lefts.data(),
+                    this->rights.data(), this->values.data(),
+                    this->symbols.data(), slots, scratch.data());
+}
+
+double FlatTree::evaluate(int count, const OpCode* codes,
+                        const std::int32_t* left, const std::int32_t* right,
+                        const double* value, const std::int32_t* symbol,
+                        const double* slots, double* out)
+{
+    for (int idx = 0; idx < count; idx++)
+    {
+        switch (codes[idx])
+        {
+            case OpCode::INTEGER:
+            case OpCode::REAL:
+                out[idx] = value[idx];
+                break;
+            case OpCode::VARIABLE:
+                out[idx] = slots[symbol[idx]];
+                break;
+            case OpCode::NEGATE:
+                out[idx] = -out[left[idx]];
+                break;
+            case OpCode::ADD:
+                out[idx] = out[left[idx]] + out[right[idx]];
+                break;
+            case OpCode::SUBTRACT:
+                out[idx] = out[left[idx]] - out[right[idx]];
+                break;
+            case OpCode::MULTIPLY:
+                out[idx] = out[left[idx]] * out[right[idx]];
+                break;
+            case OpCode::DIVIDE:
+                out[idx] = out[left[idx]] / out[right[idx]];
+                break;
+            case OpCode::POWER:
+                out[idx] = std::pow(out[left[idx]], out[right[idx]]);
+                break;
+            default:
+                out[idx] = applyFunction(codes[idx], out[left[idx]],
+                                                                value[idx]);
+                break;
+        }
+    }
+    return out[count - 1];
+}
+
+void FlatTree::evaluate(const double* slots, int sweep, const double* values,
+                int count, double* out, std::vector<double>& scratch) const
+{
+    int entries = this->size();
+    if (entries == 0)
+    {
+        throw std::runtime_error("Cannot evaluate an empty tree");
+    }
+    scratch.resize(static_cast<std::size_t>(entries) * count);
+    const OpCode* codes = this->opcodes.data();
+    const std::int32_t* left = this->lefts.data();
+    const std::int32_t* right = this->rights.data();
+    const double* value = this->values.data();
+    const std::int32_t* symbol = this->symbols.data();
+
+    for (int idx = 0; idx < entries; idx++)
+    {
+        double* row = scratch.data() + static_cast<std::size_t>(idx) * count;
+        const double* first = left[idx] == -1 ? nullptr :
+                scratch.data() + static_cast<std::size_t>(left[idx]) * count;
+        const double* second = right[idx] == -1 ? nullptr :
+                scratch.data() + static_cast<std::size_t>(right[idx]) * count;
+        switch (codes[idx])
+        {
+            case OpCode::INTEGER:
+            case OpCode::REAL:
+                std::fill(row, row + count, value[idx]);
+                break;
+            case OpCode::VARIABLE:
+                if (symbol[idx] == sweep)
+                {
+                    std::copy(values, values + count, row);
+                }
+                else
+                {
+                    std::fill(row, row + count, slots[symbol[idx]]);
+                }
+                break;
+            case OpCode::NEGATE:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = -first[point];
+                }
+                break;
+            case OpCode::ADD:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = first[point] + second[point];
+                }
+                break;
+            case OpCode::SUBTRACT:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = first[point] - second[point];
+                }
+                break;
+            case OpCode::MULTIPLY:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = first[point] * second[point];
+                }
+                break;
+            case OpCode::DIVIDE:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = first[point] / second[point];
+                }
+                break;
+            case OpCode::POWER:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = std::pow(first[point], second[point]);
+                }
+                break;
+            default:
+                for (int point = 0; point < count; point++)
+                {
+                    row[point] = applyFunction(codes[idx], first[point],
+                                                                value[idx]);
+                }
+                break;
+        }
+    }
+    const double* root = scratch.data() +
+                            static_cast<std::size_t>(entries - 1) * count;
+    std::copy(root, root + count, out);
+}
+
+Interval FlatTree::evaluate(const Interval* slots) const
+{
+    std::vector<Interval> scratch;
+    return this->evaluate(slots, scratch);
+}
+
+Interval FlatTree::evaluate(const Interval* slots,
+                                    std::vector<Interval>& scratch) const
+{
+    int count = this->size();
+    if (count == 0)
+    {
+        throw std::runtime_error("Cannot evaluate an empty tree");
+    }
+    scratch.resize(count);
+    Interval* out = scratch.data();
+    const OpCode* codes = this->opcodes.data();
+    const std::int32_t* left = this->lefts.data();
+    const std::int32_t* right = this->rights.data();
+    const double* value = this->values.data();
+    const std::int32_t* symbol = this->symbols.data();
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        switch (codes[idx])
+        {
+            case OpCode::INTEGER:
+            case OpCode::REAL:
+                out[idx] = Interval(value[idx]);
+                break;
+            case OpCode::VARIABLE:
+                out[idx] = slots[symbol[idx]];
+                break;
+            case OpCode::NEGATE:
+                out[idx] = -out[left[idx]];
+                break;
+            case OpCode::ADD:
+                out[idx] = out[left[idx]] + out[right[idx]];
+                break;
+            case OpCode::SUBTRACT:
+                out[idx] = out[left[idx]] - out[right[idx]];
+                break;
+            case OpCode::MULTIPLY:
+                out[idx] = out[left[idx]] * out[right[idx]];
+                break;
+            case OpCode::DIVIDE:
+                out[idx] = out[left[idx]] / out[right[idx]];
+                break;
+            case OpCode::POWER:
+                out[idx] = Interval::pow(out[left[idx]], out[right[idx]]);
+                break;
+            default:
+                out[idx] = applyFunction(codes[idx], out[left[idx]],
+                                                                value[idx]);
+                break;
+        }
+    }
+    return out[count - 1];
+}
+
+std::shared_ptr<ExpressionNode> FlatTree::thaw() const
+{
+    if (this->size() == 0)
+    {
+        return nullptr;
+    }
+    std::vector<nodePtr> nodes(this->size());
+    for (int idx = 0; idx < this->size(); idx++)
+    {
+        OpCode code = this->opcodes[idx];
+        std::shared_ptr<Token> token;
+        if (code == OpCode::INTEGER || code == OpCode::REAL)
+        {
+            token = makeNumber(this->getString(idx), this->values[idx],
+                                                    code == OpCode::INTEGER);
+        }
+        else if (code == OpCode::VARIABLE)
+        {
+            token = this->variables[this->symbols[idx]]->clone();
+        }
+        else if (code == OpCode::NEGATE)
+        {
+            // The child was created for this entry alone, but its token
+            // may be pooled
+            nodes[idx] = nodes[this->lefts[idx]];
+            if (nodes[idx]->getToken()->isPooled())
+            {
+                nodes[idx]->setToken(nodes[idx]->getToken()->clone());
+            }
+            nodes[idx]->getToken()->flipSign();
+            continue;
+        }
+        else if (isFunction(code))
+        {
+            auto func = std::make_shared<Function>(getFunctionName(code));
+            func->setSubExprTree(nodes[this->lefts[idx]]);
+            if (this->symbols[idx] != -1)
+            {
+                std::string base = this->strings[this->symbols[idx]];
+                bool integer = base.find_first_of(".eE") == std::string::npos;
+                func->setSubscript(makeNumber(base, this->values[idx],
+                                                                integer));
+            }
+            token = func;
+        }
+        else
+        {
+            const char* ops = "+-*/^";
+            int op = static_cast<int>(code) - static_cast<int>(OpCode::ADD);
+            token = TokenPool::op(std::string(1, ops[op]));
+        }
+        nodes[idx] = std::make_shared<ExpressionNode>(token);
+        if (code >= OpCode::ADD && code <= OpCode::POWER)
+        {
+            nodes[idx]->setLeft(nodes[this->lefts[idx]]);
+            nodes[idx]->setRight(nodes[this->rights[idx]]);
+        }
+    }
+    return nodes.back();
+}
+
+std::shared_ptr<Number> FlatTree::makeNumber(const std::string& str,
+                                                double value, bool integer)
+{
+    // Number keeps the magnitude and a sign flag
+    std::string digits = (!str.empty() && str[0] == '-') ? str.substr(1) : str;
+    std::shared_ptr<Number> out;
+    if (integer)
+    {
+        out = std::make_shared<Number>(digits,
+                                static_cast<int>(std::fabs(value)));
+    }
+    else
+    {
+        out = std::make_shared<Number>(digits, std::fabs(value));
+    }
+    if (value < 0)
+    {
+        out->flipSign();
+    }
+    return out;
+}
+
+bool FlatTree::equals(const FlatTree& other) const
+{
+    if (this->opcodes != other.opcodes || this->lefts != other.lefts ||
+            this->rights != other.rights || this->values != other.values)
+    {
+        return false;
+    }
+    for (int idx = 0; idx < this->size(); idx++)
+    {
+        if (this->opcodes[idx] != OpCode::VARIABLE)
+        {
+            continue;
+        }
+        auto var = this->variables[this->symbols[idx]];
+        auto otherVar = other.variables[other.symbols[idx]];
+        if (!var->equals(otherVar))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FlatTree::operator==(const FlatTree& other) const
+{
+    return this->equals(other);
+}
+
+bool FlatTree::operator!=(const FlatTree& other) const
+{
+    return !this->equals(other);
+}
+
+bool FlatTree::isFunction(OpCode code)
+{
+    return code >= OpCode::SIN;
+}
+
+OpCode FlatTree::getFunctionCode(const std::string& name)
+{
+    if (name == "sin")
+        return OpCode::SIN;
+    else if (name == "cos")
+        return OpCode::COS;
+    else if (name == "tan")
+        return OpCode::TAN;
+    else if (name == "cot")
+        return OpCode::COT;
+    else if (name == "csc")
+        return OpCode::CSC;
+    else if (name == "sec")
+        return OpCode::SEC;
+    else if (name == "exp")
+        return OpCode::EXP;
+    else if (name == "ln")
+        return OpCode::LN;
+    else if (name == "log")
+        return OpCode::LOG;
+    else if (name == "sqrt")
+        return OpCode::SQRT;
+    throw std::runtime_error("Cannot freeze function " + name);
+}
+
+std::string FlatTree::getFunctionName(OpCode code)
+{
+    switch (code)
+    {
+        case OpCode::SIN:   return "sin";
+        case OpCode::COS:   return "cos";
+        case OpCode::TAN:   return "tan";
+        case OpCode::COT:   return "cot";
+        case OpCode::CSC:   return "csc";
+        case OpCode::SEC:   return "sec";
+        case OpCode::EXP:   return "exp";
+        case OpCode::LN:    return "ln";
+        case OpCode::LOG:   return "log";
+        case OpCode::SQRT:  return "sqrt";
+        default:            return "";
+    }
+}
+
+// Mirrors FunctionDefinition::evaluate without the virtual dispatch
+double FlatTree::applyFunction(OpCode code, double arg, double base)
+{
+    switch (code)
+    {
+        case OpCode::SIN:   return std::sin(arg);
+        case OpCode::COS:   return std::cos(arg);
+        case OpCode::TAN:   return std::tan(arg);
+        case OpCode::COT:   return 1.0 / std::tan(arg);
+        case OpCode::CSC:   return 1.0 / std::sin(arg);
+        case OpCode::SEC:   return 1.0 / std::cos(arg);
+        case OpCode::EXP:   return std::exp(arg);
+        case OpCode::LN:    return std::log(arg);
+        case OpCode::LOG:   return std::log(arg) / std::log(base);
+        case OpCode::SQRT:  return std::sqrt(arg);
+        default:
+            throw std::runtime_error("Not a function opcode");
+    }
+}
+
+// Mirrors the interval overloads of FunctionDefinition::evaluate
+Interval FlatTree::applyFunction(OpCode code, const Interval& arg,
+                                                                double base)
+{
+    switch (code)
+    {
+        case OpCode::SIN:   return Interval::sin(arg);
+        case OpCode::COS:   return Interval::cos(arg);
+        case OpCode::TAN:   return Interval::tan(arg);
+        case OpCode::COT:   return Interval::cot(arg);
+        case OpCode::CSC:   return Interval::csc(arg);
+        case OpCode::SEC:   return Interval::sec(arg);
+        case OpCode::EXP:   return Interval::exp(arg);
+        case OpCode::LN:    return Interval::ln(arg);
+        case OpCode::LOG:   return Interval::log(arg, base);
+        case OpCode::SQRT:  return Interval::sqrt(arg);
+        default:
+            throw std::runtime_error("Not a function opcode");
+    }
+}
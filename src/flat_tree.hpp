@@ -0,0 +1,224 @@
+#ifndef __FLAT_TREE_HPP__
+#define __FLAT_TREE_HPP__
+
+#include "token.hpp"
+#include "expression_node.hpp"
+#include "interval.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Operation stored in each slot of a FlatTree.
+ */
+enum class OpCode : std::uint8_t
+{
+    INTEGER,
+    REAL,
+    VARIABLE,
+    NEGATE,
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    POWER,
+    SIN,
+    COS,
+    TAN,
+    COT,
+    CSC,
+    SEC,
+    EXP,
+    LN,
+    LOG,
+    SQRT
+};
+
+/**
+ * @brief Immutable, cache-friendly copy of a finished expression tree.
+ *
+ * @details The tree is stored as a struct of arrays in post-order, so every
+ * child index is smaller than the index of its parent and the root is the
+ * last entry. Read-only passes can therefore walk the arrays front to back
+ * instead of chasing pointers. Function arguments are stored as the left
+ * child of the function entry, and negative non-number tokens are expanded
+ * into a NEGATE entry so that the sign flag never has to be consulted.
+ */
+class FlatTree
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+public:
+    FlatTree() = default;
+
+    /**
+     * @brief Freezes the tree rooted at root.
+     *
+     * @param root the root of the expression tree to freeze.
+     */
+    FlatTree(nodePtr root);
+
+    /**
+     * @brief Number of entries in the tree.
+     */
+    int size() const;
+
+    /**
+     * @brief Index of the root entry, -1 if the tree is empty.
+     */
+    int root() const;
+
+    OpCode getOpCode(int idx) const;
+    int getLeft(int idx) const;
+    int getRight(int idx) const;
+
+    /**
+     * @brief Index of the first entry of the subtree rooted at idx.
+     *
+     * @details The subtree of idx occupies [getFirst(idx), idx].
+     */
+    int getFirst(int idx) const;
+
+    /**
+     * @brief Numeric payload: the value of a number or the base of a log.
+     */
+    double getValue(int idx) const;
+
+    /**
+     * @brief Symbol payload: the variable slot of a variable entry, the
+     * index of the rendered string of a number entry, or the index of the
+     * rendered subscript of a function entry (-1 without one).
+     */
+    int getSymbol(int idx) const;
+
+    /**
+     * @brief The rendered string of a leaf entry, or the subscript of a
+     * function entry.
+     */
+    std::string getString(int idx) const;
+
+    const std::vector<OpCode>& getOpCodes() const;
+    const std::vector<std::int32_t>& getLefts() const;
+    const std::vector<std::int32_t>& getRights() const;
+    const std::vector<double>& getValues() const;
+    const std::vector<std::int32_t>& getSymbols() const;
+
+    /**
+     * @brief The distinct variables of the tree, indexed by slot.
+     */
+    const std::vector<std::shared_ptr<Variable>>& getVariables() const;
+
+    /**
+     * @brief Finds the slot assigned to a variable.
+     *
+     * @return the slot index, -1 if the variable is not in the tree.
+     */
+    int getSlot(const std::shared_ptr<Variable> var) const;
+
+    /**
+     * @brief checks if the tree contains a given variable
+     */
+    bool hasVariable(const std::shared_ptr<Variable> var) const;
+
+    /**
+     * @brief checks if the subtree rooted at idx contains a given variable
+     */
+    bool hasVariable(const std::shared_ptr<Variable> var, int idx) const;
+
+    /**
+     * @brief Evaluates the tree with one value per variable slot.
+     *
+     * @details Domain errors follow IEEE rules and come back as NaN or
+     * infinity instead of throwing.
+     *
+     * @param slots values indexed by variable slot.
+     * @param scratch buffer reused between calls, resized as needed.
+     * @return the value of the root.
+     */
+    double evaluate(const double* slots, std::vector<double>& scratch) const;
+    double evaluate(const double* slots) const;
+
+    /**
+     * @brief Evaluates the tree at count points that differ only in one
+     * variable.
+     *
+     * @details Entries are evaluated one at a time across all points, so
+     * the opcode dispatch is paid once per entry instead of once per entry
+     * and point. scratch holds size() * count values; keep count small
+     * enough for that to stay in cache.
+     *
+     * @param slots values of the fixed variables, indexed by slot.
+     * @param sweep the slot that takes values[i] at point i, -1 for none.
+     * @param values the swept values.
+     * @param count number of points.
+     * @param out receives the value of the root at each point.
+     * @param scratch buffer reused between calls, resized as needed.
+     */
+    void evaluate(const double* slots, int sweep, const double* values,
+                    int count, double* out, std::vector<double>& scratch) const;
+
+    /**
+     * @brief Bounds the tree with one range per variable slot.
+     *
+     * @details See Interval for how domain errors are reported.
+     */
+    Interval evaluate(const Interval* slots,
+                                    std::vector<Interval>& scratch) const;
+    Interval evaluate(const Interval* slots) const;
+
+    /**
+     * @brief Rebuilds an ExpressionNode tree equal to the frozen one.
+     */
+    nodePtr thaw() const;
+
+    /**
+     * @brief Evaluates a post-order table given as raw arrays.
+     *
+     * @details Shared by evaluate and by read-only views of the same layout
+     * stored elsewhere, such as a memory-mapped TreeArchive.
+     *
+     * @param out scratch of at least count values.
+     */
+    static double evaluate(int count, const OpCode* codes,
+                        const std::int32_t* left, const std::int32_t* right,
+                        const double* value, const std::int32_t* symbol,
+                        const double* slots, double* out);
+
+    /**
+     * @brief Structural equality of two frozen trees.
+     */
+    bool equals(const FlatTree& other) const;
+    bool operator==(const FlatTree& other) const;
+    bool operator!=(const FlatTree& other) const;
+
+    static bool isFunction(OpCode code);
+    static OpCode getFunctionCode(const std::string& name);
+    static std::string getFunctionName(OpCode code);
+    static double applyFunction(OpCode code, double arg, double base);
+    static Interval applyFunction(OpCode code, const Interval& arg,
+                                                            double base);
+
+private:
+    std::vector<OpCode> opcodes;
+    std::vector<std::int32_t> lefts;
+    std::vector<std::int32_t> rights;
+    std::vector<std::int32_t> firsts;
+    std::vector<double> values;
+    std::vector<std::int32_t> symbols;
+
+    std::vector<std::string> strings;
+    std::vector<std::shared_ptr<Variable>> variables;
+
+    int freeze(nodePtr node);
+    int addEntry(OpCode code, int left, int right, int first,
+                                            double value, int symbol);
+    int addString(const std::string& str);
+    int addVariable(std::shared_ptr<Variable> var);
+    static std::shared_ptr<Number> makeNumber(const std::string& str,
+                                                double value, bool integer);
+
+    friend class TreeArchive;
+};
+
+#endif // __FLAT_TREE_HPP__
@@ -1,6 +1,7 @@
 #include "function_defs.hpp"
 #include "arithmetic.hpp"
 #include "operation.hpp"
+#include "token_pool.hpp"
 
 #include <cmath>
 
@@ -17,7 +18,7 @@ void FunctionDefinition::update(std::shared_ptr<ExpressionNode> node)
     this->node = node;
     this->func = std::dynamic_pointer_cast<Function>(this->node->getToken());
     this->subDerivative = this->node->getDerivative();
-    this->subExpr = func->getSubExprTree()->copyTree();
+    this->subExpr = func->getSubExprTree();
 }
 
 std::shared_ptr<ExpressionNode> FunctionDefinition::chain(
@@ -49,6 +50,16 @@ double Sin::evaluate(double arg)
     return std::sin(arg);
 }
 
+Interval Sin::evaluate(const Interval& arg)
+{
+    return Interval::sin(arg);
+}
+
+Series Sin::evaluate(const Series& arg)
+{
+    return Series::sin(arg);
+}
+
 
 // d/dx cos(x) = -sin(x)
 std::shared_ptr<ExpressionNode> Cos::getDerivative()
@@ -66,6 +77,16 @@ double Cos::evaluate(double arg)
     return std::cos(arg);
 }
 
+Interval Cos::evaluate(const Interval& arg)
+{
+    return Interval::cos(arg);
+}
+
+Series Cos::evaluate(const Series& arg)
+{
+    return Series::cos(arg);
+}
+
 
 // d/dx tan(x) = sec^2(x)
 std::shared_ptr<ExpressionNode> Tan::getDerivative()
@@ -74,7 +95,7 @@ std::shared_ptr<ExpressionNode> Tan::getDerivative()
     derivative->setSubExprTree(this->subExpr);
     auto squared = Operation::power(
             std::make_shared<ExpressionNode>(derivative),
-            std::make_shared<ExpressionNode>(std::make_shared<Number>("2",2)));
+            std::make_shared<ExpressionNode>(TokenPool::number(2)));
     return chain(squared);
 }
 
@@ -83,6 +104,16 @@ double Tan::evaluate(double arg)
     return std::tan(arg);
 }
 
+Interval Tan::evaluate(const Interval& arg)
+{
+    return Interval::tan(arg);
+}
+
+Series Tan::evaluate(const Series& arg)
+{
+    return Series::tan(arg);
+}
+
 // d/dx sec(x) = sec(x)tan(x)
 std::shared_ptr<ExpressionNode> Sec::getDerivative()
 {
@@ -105,6 +136,16 @@ double Sec::evaluate(double arg)
     return 1.0 / std::cos(arg);
 }
 
+Interval Sec::evaluate(const Interval& arg)
+{
+    return Interval::sec(arg);
+}
+
+Series Sec::evaluate(const Series& arg)
+{
+    return Series::sec(arg);
+}
+
 // d/dx exp(x) = exp(x)
 std::shared_ptr<ExpressionNode> Exp::getDerivative()
 {
@@ -118,6 +159,16 @@ double Exp::evaluate(double arg)
     return std::exp(arg);
 }
 
+Interval Exp::evaluate(const Interval& arg)
+{
+    return Interval::exp(arg);
+}
+
+Series Exp::evaluate(const Series& arg)
+{
+    return Series::exp(arg);
+}
+
 // d/dx ln(x) = 1/x
 std::shared_ptr<ExpressionNode> Ln::getDerivative()
 {
@@ -133,6 +184,16 @@ double Ln::evaluate(double arg)
     return std::log(arg);
 }
 
+Interval Ln::evaluate(const Interval& arg)
+{
+    return Interval::ln(arg);
+}
+
+Series Ln::evaluate(const Series& arg)
+{
+    return Series::ln(arg);
+}
+
 // d/dx log_a(x) = 1/x
 std::shared_ptr<ExpressionNode> Log::getDerivative()
 {
@@ -141,9 +202,9 @@ std::shared_ptr<ExpressionNode> Log::getDerivative()
     auto numerator = this->subDerivative;
     
     auto derivative = std::make_shared<ExpressionNode>(
-                                    std::make_shared<Operator>("/"));
+                                    TokenPool::op("/"));
     auto denomenator = std::make_shared<ExpressionNode>(
-                                    std::make_shared<Operator>("*"));
+                                    TokenPool::op("*"));
     auto baseFunc = std::make_shared<Function>("ln");
     baseFunc->setSubExpr(this->func->getSubExpr());
     denomenator->setLeft(std::make_shared<ExpressionNode>(baseFunc));
@@ -159,11 +220,13 @@ std::shared_ptr<ExpressionNode> Cot::getDerivative()
     // Create csc^2(x)
     auto squared = Operation::power(
         std::make_shared<ExpressionNode>(derivative),
-        std::make_shared<ExpressionNode>(std::make_shared<Number>("2", 2))
+        std::make_shared<ExpressionNode>(TokenPool::number(2))
     );
     
-    
-    squared->getToken()->flipSign();
+    // The operator token is pooled, negate a copy
+    auto negated = squared->getToken()->clone();
+    negated->flipSign();
+    squared->setToken(negated);
     
     return chain(squared);
 }
@@ -173,6 +236,16 @@ double Cot::evaluate(double arg)
     return 1.0 / std::tan(arg);
 }
 
+Interval Cot::evaluate(const Interval& arg)
+{
+    return Interval::cot(arg);
+}
+
+Series Cot::evaluate(const Series& arg)
+{
+    return Series::cot(arg);
+}
+
 double Log::evaluate(double arg)
 {    
     auto base = this->func->getSubscript();
@@ -183,6 +256,26 @@ double Log::evaluate(double arg)
     return (std::log(arg) / std::log(1.0 * base->getInt()));
 }
 
+Interval Log::evaluate(const Interval& arg)
+{
+    auto base = this->func->getSubscript();
+    if (base->isDouble())
+    {
+        return Interval::log(arg, base->getDouble());
+    }
+    return Interval::log(arg, 1.0 * base->getInt());
+}
+
+Series Log::evaluate(const Series& arg)
+{
+    auto base = this->func->getSubscript();
+    if (base->isDouble())
+    {
+        return Series::log(arg, base->getDouble());
+    }
+    return Series::log(arg, 1.0 * base->getInt());
+}
+
 // d/dx csc(x) = -csc(x)cot(x)
 std::shared_ptr<ExpressionNode> Csc::getDerivative()
 {
@@ -197,8 +290,10 @@ std::shared_ptr<ExpressionNode> Csc::getDerivative()
         std::make_shared<ExpressionNode>(cotFunc)
     );
 
-    // Make the result negative
-    product->getToken()->flipSign();
+    // Make the result negative, on a copy of the pooled operator
+    auto negated = product->getToken()->clone();
+    negated->flipSign();
+    product->setToken(negated);
 
     return chain(product);
 }
@@ -208,12 +303,22 @@ double Csc::evaluate(double arg)
     return 1.0 / std::sin(arg);
 }
 
+Interval Csc::evaluate(const Interval& arg)
+{
+    return Interval::csc(arg);
+}
+
+Series Csc::evaluate(const Series& arg)
+{
+    return Series::csc(arg);
+}
+
 
 // d/dx sqrt(x) = 1 / (2 * sqrt(x))
 std::shared_ptr<ExpressionNode> Sqrt::getDerivative()
 {
     auto two = std::make_shared<ExpressionNode>(
-        std::make_shared<Number>("2", 2)
+        TokenPool::number(2)
     );
 
     auto sqrtFunc = std::make_shared<Function>("sqrt");
@@ -225,7 +330,7 @@ std::shared_ptr<ExpressionNode> Sqrt::getDerivative()
     );
 
     auto numerator = std::make_shared<ExpressionNode>(
-        std::make_shared<Number>("1", 1)
+        TokenPool::number(1)
     );
 
     auto derivative = Operation::divide(numerator, denominator);
@@ -236,3 +341,13 @@ double Sqrt::evaluate(double arg)
 {
     return std::sqrt(arg);
 }
+
+Interval Sqrt::evaluate(const Interval& arg)
+{
+    return Interval::sqrt(arg);
+}
+
+Series Sqrt::evaluate(const Series& arg)
+{
+    return Series::sqrt(arg);
+}
@@ -3,7 +3,8 @@
 
 #include "token.hpp"
 #include "expression_node.hpp"
-#include "expression_node.hpp"
+#include "interval.hpp"
+#include "series.hpp"
 
 #include <memory>
 
@@ -30,6 +31,12 @@ public:
 
     // Method to numerically evaluate the function
     virtual double evaluate(double arg) = 0;
+
+    // Method to bound the function over a range of arguments
+    virtual Interval evaluate(const Interval& arg) = 0;
+
+    // Method to expand the function of a truncated power series
+    virtual Series evaluate(const Series& arg) = 0;
     std::shared_ptr<ExpressionNode> chain(std::shared_ptr<ExpressionNode> node);
     std::shared_ptr<ExpressionNode> chain(std::shared_ptr<Function> node);
     void update(std::shared_ptr<ExpressionNode> node);
@@ -42,6 +49,8 @@ public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
 
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Cos : public FunctionDefinition
@@ -52,6 +61,8 @@ public:
 
     // Numerical evaluation of cos(x)
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Tan : public FunctionDefinition
@@ -62,12 +73,16 @@ public:
 
     // Numerical evaluation of tan(x)
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 class Cot : public FunctionDefinition
 {
 public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Csc : public FunctionDefinition
@@ -75,6 +90,8 @@ class Csc : public FunctionDefinition
 public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Sec : public FunctionDefinition
@@ -82,6 +99,8 @@ class Sec : public FunctionDefinition
 public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Exp : public FunctionDefinition
@@ -89,6 +108,8 @@ class Exp : public FunctionDefinition
 public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Ln : public FunctionDefinition
@@ -96,6 +117,8 @@ class Ln : public FunctionDefinition
 public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Sqrt : public FunctionDefinition
@@ -103,6 +126,8 @@ class Sqrt : public FunctionDefinition
 public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 class Log : public FunctionDefinition
@@ -112,6 +137,8 @@ public:
     std::shared_ptr<ExpressionNode> getDerivative() override;
     // Numerical evaluation of log(x)
     double evaluate(double arg) override;
+    Interval evaluate(const Interval& arg) override;
+    Series evaluate(const Series& arg) override;
 };
 
 #endif // __FUNCTION_DEFS_HPP__
\ No newline at end of file
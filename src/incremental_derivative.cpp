@@ -0,0 +1,310 @@
+#include "incremental_derivative.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+
+#include <functional>
+#include <stdexcept>
+
+IncrementalDerivative::IncrementalDerivative(std::string input,
+                                        std::string wrt) : log(false)
+{
+    log.setInput(input);
+    log.setMode("Derivative");
+    this->diffVar = Derivative::parseVariable(wrt);
+    this->root = parse(input);
+    this->derivative = nullptr;
+    this->reusedNodes = 0;
+    this->dirtyNodes = countNodes(this->root);
+
+    // Index the whole tree once, updates then patch the index
+    hashTable rootHashes;
+    this->hashTree(this->root, rootHashes);
+    std::vector<nodePtr> stack = {this->root};
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        this->index(node, rootHashes.at(node.get()));
+        if (node->getType() == TokenType::FUNCTION)
+        {
+            auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+            stack.push_back(func->getSubExprTree());
+            continue;
+        }
+        if (node->getLeft())
+        {
+            stack.push_back(node->getLeft());
+        }
+        if (node->getRight())
+        {
+            stack.push_back(node->getRight());
+        }
+    }
+}
+
+std::shared_ptr<ExpressionNode> IncrementalDerivative::parse(
+                                                const std::string& input)
+{
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    if (!root)
+    {
+        throw std::runtime_error("Empty expression");
+    }
+    TreeFixer::checkTree(root);
+    root = TreeFixer::simplify(root);
+    return root;
+}
+
+std::shared_ptr<ExpressionNode> IncrementalDerivative::solve()
+{
+    if (!this->derivative)
+    {
+        this->derivative = this->differentiate();
+    }
+    return this->derivative;
+}
+
+std::shared_ptr<ExpressionNode> IncrementalDerivative::update(
+                                                        std::string input)
+{
+    log.setInput(input);
+    auto fresh = parse(input);
+
+    hashTable freshHashes;
+    this->hashTree(fresh, freshHashes);
+    this->used.clear();
+    this->grafted.clear();
+    this->reusedNodes = 0;
+    this->dirtyNodes = 0;
+    auto oldRoot = this->root;
+    this->root = this->graft(fresh, freshHashes);
+
+    // Only the replaced and the new nodes change the index
+    this->unindex(oldRoot);
+    for (const auto& entry : this->grafted)
+    {
+        this->index(entry.first, entry.second);
+    }
+    this->derivative = this->differentiate();
+    return this->derivative;
+}
+
+std::shared_ptr<ExpressionNode> IncrementalDerivative::differentiate()
+{
+    // Operator steps simplify their own derivative as they are built, so
+    // only the sub-trees on the dirty path are touched here.
+    Derivative engine(this->diffVar);
+    engine.log.setEnabled(false);
+    auto out = engine.solve(this->root);
+    if (this->root->getType() == TokenType::FUNCTION)
+    {
+        TreeFixer::checkTree(out);
+        out = TreeFixer::simplify(out);
+    }
+    log.setOutput(out);
+    return out;
+}
+
+std::shared_ptr<ExpressionNode> IncrementalDerivative::graft(nodePtr fresh,
+                                            const hashTable& freshHashes)
+{
+    if (!fresh)
+    {
+        return nullptr;
+    }
+    auto bucket = this->previous.find(freshHashes.at(fresh.get()));
+    if (bucket != this->previous.end())
+    {
+        for (const auto& candidate : bucket->second)
+        {
+            if (this->used.count(candidate.get()) == 0 &&
+                                        sameTree(candidate, fresh))
+            {
+                this->used.insert(candidate.get());
+                this->reusedNodes += countNodes(candidate);
+                return candidate;
+            }
+        }
+    }
+
+    this->dirtyNodes++;
+    this->grafted.emplace_back(fresh, freshHashes.at(fresh.get()));
+    if (fresh->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(fresh->getToken());
+        bool leftIsArgument = fresh->getLeft() == func->getSubExprTree();
+        func->setSubExprTree(this->graft(func->getSubExprTree(),
+                                                            freshHashes));
+        if (leftIsArgument && fresh->getLeft())
+        {
+            fresh->setLeft(func->getSubExprTree());
+        }
+        return fresh;
+    }
+    if (fresh->getLeft())
+    {
+        fresh->setLeft(this->graft(fresh->getLeft(), freshHashes));
+    }
+    if (fresh->getRight())
+    {
+        fresh->setRight(this->graft(fresh->getRight(), freshHashes));
+    }
+    return fresh;
+}
+
+void IncrementalDerivative::index(const nodePtr& node, std::size_t hash)
+{
+    if (this->hashes.emplace(node.get(), hash).second)
+    {
+        this->previous[hash].push_back(node);
+    }
+}
+
+void IncrementalDerivative::unindex(const nodePtr& oldRoot)
+{
+    // Stops at grafted sub-trees, so only the replaced nodes are visited
+    std::vector<nodePtr> stack = {oldRoot};
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        if (!node || this->used.count(node.get()) != 0)
+        {
+            continue;
+        }
+        auto entry = this->hashes.find(node.get());
+        if (entry != this->hashes.end())
+        {
+            auto& bucket = this->previous[entry->second];
+            for (auto it = bucket.begin(); it != bucket.end(); ++it)
+            {
+                if (*it == node)
+                {
+                    bucket.erase(it);
+                    break;
+                }
+            }
+            if (bucket.empty())
+            {
+                this->previous.erase(entry->second);
+            }
+            this->hashes.erase(entry);
+        }
+        if (node->getType() == TokenType::FUNCTION)
+        {
+            auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+            stack.push_back(func->getSubExprTree());
+            continue;
+        }
+        stack.push_back(node->getLeft());
+        stack.push_back(node->getRight());
+    }
+}
+
+double IncrementalDerivative::baseValue(const std::shared_ptr<Number>& base)
+{
+    return base->isInt() ? base->getInt() : base->getDouble();
+}
+
+std::size_t IncrementalDerivative::hashTree(const nodePtr& node,
+                                                        hashTable& table)
+{
+    std::size_t hash = std::hash<int>()(static_cast<int>(node->getType()));
+    auto combine = [&hash](std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        combine(std::hash<std::string>()(func->getStr()));
+        combine(std::hash<bool>()(func->isNegative()));
+        if (func->getSubscript())
+        {
+            combine(std::hash<double>()(baseValue(func->getSubscript())));
+        }
+        combine(this->hashTree(func->getSubExprTree(), table));
+    }
+    else
+    {
+        combine(std::hash<std::string>()(node->getToken()->getFullStr()));
+        if (node->getLeft())
+        {
+            combine(this->hashTree(node->getLeft(), table));
+        }
+        if (node->getRight())
+        {
+            combine(this->hashTree(node->getRight(), table));
+        }
+    }
+    table[node.get()] = hash;
+    return hash;
+}
+
+bool IncrementalDerivative::sameTree(const nodePtr& first,
+                                                    const nodePtr& second)
+{
+    if (!first || !second)
+    {
+        return first == second;
+    }
+    if (first->getType() != second->getType())
+    {
+        return false;
+    }
+    if (first->getType() == TokenType::FUNCTION)
+    {
+        auto firstFunc = std::dynamic_pointer_cast<Function>(
+                                                        first->getToken());
+        auto secondFunc = std::dynamic_pointer_cast<Function>(
+                                                        second->getToken());
+        auto firstBase = firstFunc->getSubscript();
+        auto secondBase = secondFunc->getSubscript();
+        if (!firstBase != !secondBase || (firstBase &&
+                        baseValue(firstBase) != baseValue(secondBase)))
+        {
+            return false;
+        }
+        return firstFunc->getStr() == secondFunc->getStr() &&
+            firstFunc->isNegative() == secondFunc->isNegative() &&
+            sameTree(firstFunc->getSubExprTree(),
+                                        secondFunc->getSubExprTree());
+    }
+    return first->getToken()->getFullStr() ==
+                second->getToken()->getFullStr() &&
+            sameTree(first->getLeft(), second->getLeft()) &&
+            sameTree(first->getRight(), second->getRight());
+}
+
+int IncrementalDerivative::countNodes(const nodePtr& node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        return 1 + countNodes(func->getSubExprTree());
+    }
+    return 1 + countNodes(node->getLeft()) + countNodes(node->getRight());
+}
+
+int IncrementalDerivative::getReusedNodes() const
+{
+    return this->reusedNodes;
+}
+
+int IncrementalDerivative::getDirtyNodes() const
+{
+    return this->dirtyNodes;
+}
+
+int IncrementalDerivative::getIndexedNodes() const
+{
+    return this->hashes.size();
+}
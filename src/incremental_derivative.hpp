@@ -0,0 +1,91 @@
+#ifndef __INCREMENTAL_DERIVATIVE_HPP__
+#define __INCREMENTAL_DERIVATIVE_HPP__
+
+#include "expression_node.hpp"
+#include "log.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Re-differentiates an expression after small edits.
+ *
+ * @details The previous tree is kept together with the derivative cached
+ * on each node. On update, the new input is parsed and every sub-tree that
+ * is structurally identical to one of the previous tree is replaced by the
+ * previous node, so Derivative::solve finds its cached derivative and only
+ * the nodes on the edited path up to the root are differentiated again.
+ * The sub-tree index is patched the same way: grafted sub-trees keep their
+ * entries, the new nodes are added and the replaced ones dropped. Parsing,
+ * hashing and matching the new input still take time linear in its length.
+ */
+class IncrementalDerivative
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+    typedef std::unordered_map<const ExpressionNode*, std::size_t> hashTable;
+private:
+    nodePtr root;
+    nodePtr derivative;
+    std::shared_ptr<Variable> diffVar;
+
+    //! Sub-trees of the previous tree, bucketed by structural hash
+    std::unordered_map<std::size_t, std::vector<nodePtr>> previous;
+    hashTable hashes;
+    std::unordered_set<const ExpressionNode*> used;
+    //! New nodes created by the last graft, with their hashes
+    std::vector<std::pair<nodePtr, std::size_t>> grafted;
+    int reusedNodes;
+    int dirtyNodes;
+
+    static nodePtr parse(const std::string& input);
+    //! Value of a log base, so log_2 and log_2.0 match
+    static double baseValue(const std::shared_ptr<Number>& base);
+    std::size_t hashTree(const nodePtr& node, hashTable& table);
+    static bool sameTree(const nodePtr& first, const nodePtr& second);
+    static int countNodes(const nodePtr& node);
+    nodePtr graft(nodePtr fresh, const hashTable& freshHashes);
+    void index(const nodePtr& node, std::size_t hash);
+    void unindex(const nodePtr& oldRoot);
+    nodePtr differentiate();
+public:
+    Logger log;
+
+    IncrementalDerivative(std::string input, std::string wrt);
+
+    /**
+     * @brief calculates the derivative of the current expression
+     */
+    nodePtr solve();
+
+    /**
+     * @brief replaces the expression and re-differentiates the parts
+     * that changed
+     *
+     * @param input the edited expression
+     * @return the derivative of the edited expression
+     */
+    nodePtr update(std::string input);
+
+    /**
+     * @brief nodes taken over from the previous tree in the last update
+     */
+    int getReusedNodes() const;
+
+    /**
+     * @brief nodes that had to be differentiated again in the last update
+     */
+    int getDirtyNodes() const;
+
+    /**
+     * @brief distinct sub-trees in the index the next update matches
+     * against
+     */
+    int getIndexedNodes() const;
+};
+
+#endif // __INCREMENTAL_DERIVATIVE_HPP__
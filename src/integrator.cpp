@@ -0,0 +1,228 @@
+#include "integrator.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Positive Kronrod nodes and 0, the Gauss nodes are the odd entries and 0
+const double KRONROD_NODES[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.0};
+const double KRONROD_WEIGHTS[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+const double GAUSS_WEIGHTS[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+
+Integrator::Integrator(std::string input, std::string wrt)
+    : maxIntervals(2000)
+{
+    this->wrt = Derivative::parseVariable(wrt);
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    if (!root)
+    {
+        throw std::runtime_error("Empty expression");
+    }
+    TreeFixer::checkTree(root);
+    root = TreeFixer::simplify(root);
+    this->tree = FlatTree(root);
+    this->slots.assign(this->tree.getVariables().size(), 1.0);
+    this->sweep = this->tree.getSlot(this->wrt);
+}
+
+Integrator::Integrator(const FlatTree& tree, std::shared_ptr<Variable> wrt)
+    : tree(tree), wrt(wrt), maxIntervals(2000)
+{
+    this->slots.assign(this->tree.getVariables().size(), 1.0);
+    this->sweep = this->tree.getSlot(this->wrt);
+}
+
+void Integrator::setMaxIntervals(int maxIntervals)
+{
+    if (maxIntervals <= 0)
+    {
+        throw std::runtime_error("Interval limit must be positive");
+    }
+    this->maxIntervals = maxIntervals;
+}
+
+void Integrator::bind(const Bindings& bindings)
+{
+    this->slots = bindings.getSlots(this->tree, this->wrt);
+}
+
+void Integrator::evaluate(Piece& piece) const
+{
+    // Kept per thread so the sampling loop does not allocate
+    thread_local std::vector<double> scratch;
+    double center = piece.lo + (piece.hi - piece.lo) / 2;
+    double half = (piece.hi - piece.lo) / 2;
+    double points[POINTS];
+    double values[POINTS];
+    for (int idx = 0; idx < 7; idx++)
+    {
+        points[2 * idx] = center - half * KRONROD_NODES[idx];
+        points[2 * idx + 1] = center + half * KRONROD_NODES[idx];
+    }
+    points[POINTS - 1] = center;
+    this->tree.evaluate(this->slots.data(), this->sweep, points, POINTS,
+                                                        values, scratch);
+
+    double kronrod = KRONROD_WEIGHTS[7] * values[POINTS - 1];
+    double gauss = GAUSS_WEIGHTS[3] * values[POINTS - 1];
+    for (int idx = 0; idx < 7; idx++)
+    {
+        double pair = values[2 * idx] + values[2 * idx + 1];
+        kronrod += KRONROD_WEIGHTS[idx] * pair;
+        if (idx % 2 == 1)
+        {
+            gauss += GAUSS_WEIGHTS[idx / 2] * pair;
+        }
+    }
+    piece.finite = std::isfinite(kronrod) && std::isfinite(gauss);
+    piece.value = piece.finite ? kronrod * half : 0.0;
+    piece.error = piece.finite ? std::fabs(kronrod - gauss) * half :
+                                    std::numeric_limits<double>::infinity();
+}
+
+Integrator::Result Integrator::integrate(double lo, double hi,
+                                    double tolerance, int threads) const
+{
+    if (!std::isfinite(lo) || !std::isfinite(hi))
+    {
+        throw std::runtime_error("Integration bounds must be finite");
+    }
+    if (!(tolerance > 0) || !std::isfinite(tolerance))
+    {
+        throw std::runtime_error("Integration tolerance must be positive");
+    }
+    if (lo > hi)
+    {
+        Result out = this->integrate(hi, lo, tolerance, threads);
+        out.value = -out.value;
+        return out;
+    }
+    Result out = {0.0, 0.0, 0, 0, true, false};
+    if (lo == hi)
+    {
+        return out;
+    }
+
+    // Fixed variables keep their bound values as point intervals
+    std::vector<Interval> ranges(this->slots.begin(), this->slots.end());
+    if (this->sweep != -1)
+    {
+        ranges[this->sweep] = Interval(lo, hi);
+    }
+    Interval bound = this->tree.evaluate(ranges.data());
+    out.singular = bound.partial || bound.isEmpty();
+
+    ThreadPool pool(threads);
+    std::vector<Piece> pieces(1);
+    pieces[0].lo = lo;
+    pieces[0].hi = hi;
+    this->evaluate(pieces[0]);
+    out.evaluations = POINTS;
+
+    while (true)
+    {
+        out.value = 0.0;
+        out.error = 0.0;
+        for (const auto& piece : pieces)
+        {
+            out.value += piece.value;
+            out.error += piece.error;
+        }
+        double limit = std::max(tolerance, tolerance * std::fabs(out.value));
+        out.converged = out.error <= limit;
+        if (out.converged || pieces.size() >= this->maxIntervals)
+        {
+            break;
+        }
+
+        // Bisect every piece over its share of the tolerance, worst first
+        // when that would exceed the interval budget
+        std::vector<Piece> kept;
+        std::vector<Piece> candidates;
+        for (const auto& piece : pieces)
+        {
+            double share = limit * (piece.hi - piece.lo) / (hi - lo);
+            double middle = piece.lo + (piece.hi - piece.lo) / 2;
+            bool splittable = middle > piece.lo && middle < piece.hi &&
+                            piece.hi - piece.lo > 1e-12 * (hi - lo);
+            if (!splittable && !piece.finite)
+            {
+                out.singular = true;
+                continue;
+            }
+            if (splittable && piece.error > share)
+            {
+                candidates.push_back(piece);
+            }
+            else
+            {
+                kept.push_back(piece);
+            }
+        }
+        if (candidates.empty())
+        {
+            // Only narrow pieces are left, stop unless some were dropped
+            bool dropped = kept.size() != pieces.size();
+            pieces = kept;
+            if (!dropped)
+            {
+                break;
+            }
+            continue;
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                            [](const Piece& first, const Piece& second) {
+            return first.error > second.error;
+        });
+        std::size_t budget = std::max<std::size_t>(1,
+                                    this->maxIntervals - pieces.size());
+        if (candidates.size() > budget)
+        {
+            kept.insert(kept.end(), candidates.begin() + budget,
+                                                        candidates.end());
+            candidates.resize(budget);
+        }
+
+        std::vector<Piece> halves(2 * candidates.size());
+        for (int idx = 0; idx < candidates.size(); idx++)
+        {
+            double middle = candidates[idx].lo +
+                            (candidates[idx].hi - candidates[idx].lo) / 2;
+            halves[2 * idx].lo = candidates[idx].lo;
+            halves[2 * idx].hi = middle;
+            halves[2 * idx + 1].lo = middle;
+            halves[2 * idx + 1].hi = candidates[idx].hi;
+        }
+        int tasks = std::min<int>(halves.size(), 4 * pool.size());
+        pool.parallelFor(tasks, [&](int task) {
+            for (int idx = task; idx < halves.size(); idx += tasks)
+            {
+                this->evaluate(halves[idx]);
+            }
+        });
+        out.evaluations += POINTS * halves.size();
+        kept.insert(kept.end(), halves.begin(), halves.end());
+        pieces = kept;
+    }
+    out.intervals = pieces.size();
+    return out;
+}
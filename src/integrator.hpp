@@ -0,0 +1,96 @@
+#ifndef __INTEGRATOR_HPP__
+#define __INTEGRATOR_HPP__
+
+#include "flat_tree.hpp"
+#include "bindings.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Adaptive Gauss-Kronrod (7-15) integration of an expression.
+ *
+ * @details The integrand is frozen once and each sub-interval is sampled
+ * with one batch evaluation of the FlatTree, reusing a per-thread buffer.
+ * Every round, all sub-intervals whose error estimate exceeds their share
+ * of the tolerance are bisected and the halves are evaluated in parallel.
+ * Kronrod nodes never touch the ends of a sub-interval, so integrable
+ * singularities at an end point (ln(x) or 1/sqrt(x) at 0) are handled by
+ * bisecting towards them. A sub-interval that keeps producing non-finite
+ * samples once it is too narrow to bisect is dropped and the result is
+ * flagged.
+ */
+class Integrator
+{
+public:
+    struct Result
+    {
+        double value;
+        double error;
+        //! Integrand evaluations
+        int evaluations;
+        //! Sub-intervals in the final partition
+        int intervals;
+        //! The error estimate reached the tolerance
+        bool converged;
+        //! The integrand leaves its domain or has a pole on the interval,
+        //! either by interval evaluation or by non-finite samples
+        bool singular;
+    };
+
+    Integrator(std::string input, std::string wrt);
+
+    /**
+     * @brief Integrates a frozen tree.
+     *
+     * @details Variables other than wrt are treated as 1.0 until bind
+     * gives them values.
+     */
+    Integrator(const FlatTree& tree, std::shared_ptr<Variable> wrt);
+
+    /**
+     * @brief Integrates over [lo, hi].
+     *
+     * @param tolerance stop once the error estimate is below
+     * max(tolerance, tolerance * |value|).
+     * @param threads worker threads, 0 uses the hardware concurrency.
+     * @throws std::runtime_error if a bound is not finite or tolerance is
+     * not positive
+     */
+    Result integrate(double lo, double hi, double tolerance = 1e-10,
+                                                    int threads = 0) const;
+
+    //! @throws std::runtime_error unless maxIntervals is positive
+    void setMaxIntervals(int maxIntervals);
+
+    /**
+     * @brief Gives the variables other than wrt their values.
+     *
+     * @throws std::runtime_error if the tree has an unbound variable
+     */
+    void bind(const Bindings& bindings);
+
+private:
+    struct Piece
+    {
+        double lo;
+        double hi;
+        double value;
+        double error;
+        bool finite;
+    };
+
+    //! Kronrod sample points per sub-interval
+    static const int POINTS = 15;
+
+    FlatTree tree;
+    std::shared_ptr<Variable> wrt;
+    std::vector<double> slots;
+    int sweep;
+    int maxIntervals;
+
+    void evaluate(Piece& piece) const;
+};
+
+#endif // __INTEGRATOR_HPP__
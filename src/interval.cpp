@@ -0,0 +1,407 @@
+#include "interval.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const double PI = 3.14159265358979323846;
+const double INF = std::numeric_limits<double>::infinity();
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// 0 * inf is taken as 0: the bound came from an operand that is exactly 0
+double Interval::product(double first, double second)
+{
+    if (first == 0.0 || second == 0.0)
+    {
+        return 0.0;
+    }
+    return first * second;
+}
+
+// Smallest value offset + period * k that is not below start
+double Interval::nextPeriodic(double start, double offset, double period)
+{
+    return offset + period * std::ceil((start - offset) / period);
+}
+
+Interval::Interval() : lo(0.0), hi(0.0), partial(false) {}
+
+Interval::Interval(double value) : lo(value), hi(value), partial(false) {}
+
+Interval::Interval(double lo, double hi, bool partial)
+    : lo(lo), hi(hi), partial(partial) {}
+
+Interval Interval::empty()
+{
+    return Interval(NaN, NaN, true);
+}
+
+Interval Interval::entire(bool partial)
+{
+    return Interval(-INF, INF, partial);
+}
+
+bool Interval::isEmpty() const
+{
+    return std::isnan(this->lo) || std::isnan(this->hi);
+}
+
+bool Interval::isPoint() const
+{
+    return this->lo == this->hi;
+}
+
+bool Interval::contains(double value) const
+{
+    return this->lo <= value && value <= this->hi;
+}
+
+double Interval::width() const
+{
+    if (this->isEmpty())
+    {
+        return 0.0;
+    }
+    return this->hi - this->lo;
+}
+
+Interval Interval::outward(double lo, double hi, bool partial)
+{
+    if (std::isnan(lo) || std::isnan(hi))
+    {
+        return empty();
+    }
+    return Interval(std::nextafter(lo, -INF), std::nextafter(hi, INF),
+                                                                partial);
+}
+
+Interval Interval::operator-() const
+{
+    return Interval(-this->hi, -this->lo, this->partial);
+}
+
+Interval operator+(const Interval& first, const Interval& second)
+{
+    if (first.isEmpty() || second.isEmpty())
+    {
+        return Interval::empty();
+    }
+    return Interval::outward(first.lo + second.lo, first.hi + second.hi,
+                                        first.partial || second.partial);
+}
+
+Interval operator-(const Interval& first, const Interval& second)
+{
+    return first + (-second);
+}
+
+Interval operator*(const Interval& first, const Interval& second)
+{
+    if (first.isEmpty() || second.isEmpty())
+    {
+        return Interval::empty();
+    }
+    double corners[] = {Interval::product(first.lo, second.lo),
+                        Interval::product(first.lo, second.hi),
+                        Interval::product(first.hi, second.lo),
+                        Interval::product(first.hi, second.hi)};
+    return Interval::outward(*std::min_element(corners, corners + 4),
+                            *std::max_element(corners, corners + 4),
+                            first.partial || second.partial);
+}
+
+Interval operator/(const Interval& first, const Interval& second)
+{
+    if (first.isEmpty() || second.isEmpty())
+    {
+        return Interval::empty();
+    }
+    bool partial = first.partial || second.partial;
+    if (!second.contains(0.0))
+    {
+        Interval inverse = Interval::outward(1.0 / second.hi,
+                                                1.0 / second.lo, partial);
+        return first * inverse;
+    }
+
+    // Dividing by zero is outside the domain, only the one-sided
+    // reciprocals of a divisor that touches zero stay bounded on one end
+    if (second.lo == 0.0 && second.hi == 0.0)
+    {
+        return Interval::empty();
+    }
+    if (second.lo == 0.0)
+    {
+        return first * Interval(std::nextafter(1.0 / second.hi, -INF),
+                                                            INF, true);
+    }
+    if (second.hi == 0.0)
+    {
+        return first * Interval(-INF,
+                            std::nextafter(1.0 / second.lo, INF), true);
+    }
+    return Interval::entire(true);
+}
+
+Interval Interval::integerPow(const Interval& base, long exponent)
+{
+    if (exponent == 0)
+    {
+        return Interval(1.0, 1.0, base.partial);
+    }
+    if (exponent < 0)
+    {
+        return Interval(1.0) / integerPow(base, -exponent);
+    }
+    double lo = std::pow(base.lo, exponent);
+    double hi = std::pow(base.hi, exponent);
+    if (exponent % 2 == 1)
+    {
+        return outward(lo, hi, base.partial);
+    }
+    if (base.contains(0.0))
+    {
+        return outward(0.0, std::max(lo, hi), base.partial);
+    }
+    return outward(std::min(lo, hi), std::max(lo, hi), base.partial);
+}
+
+Interval Interval::pow(const Interval& base, const Interval& exponent)
+{
+    if (base.isEmpty() || exponent.isEmpty())
+    {
+        return empty();
+    }
+    if (exponent.isPoint() && std::floor(exponent.lo) == exponent.lo &&
+                                            std::fabs(exponent.lo) < 1e9)
+    {
+        Interval out = integerPow(base, static_cast<long>(exponent.lo));
+        out.partial = out.partial || exponent.partial;
+        return out;
+    }
+
+    // A negative base only has a real power for integer exponents
+    Interval negative = empty();
+    if (base.lo < 0.0)
+    {
+        negative = integerPowers(Interval(base.lo, std::min(base.hi, 0.0),
+                                                    base.partial), exponent);
+        negative.partial = true;
+    }
+    if (base.hi < 0.0)
+    {
+        return negative;
+    }
+    bool partial = base.partial || exponent.partial || base.lo < 0.0;
+    double lo = std::max(base.lo, 0.0);
+    if (lo == 0.0 && exponent.lo < 0.0)
+    {
+        partial = true;
+    }
+    // pow is monotonic in each argument for a non-negative base, so the
+    // extremes lie on the corners
+    double corners[] = {std::pow(lo, exponent.lo),
+                        std::pow(lo, exponent.hi),
+                        std::pow(base.hi, exponent.lo),
+                        std::pow(base.hi, exponent.hi)};
+    Interval out = outward(*std::min_element(corners, corners + 4),
+                            *std::max_element(corners, corners + 4),
+                            partial);
+    out.lo = std::max(out.lo, 0.0);
+    return hull(out, negative);
+}
+
+Interval Interval::integerPowers(const Interval& base,
+                                                const Interval& exponent)
+{
+    double first = std::ceil(exponent.lo);
+    double last = std::floor(exponent.hi);
+    if (first > last)
+    {
+        return empty();
+    }
+    if (std::fabs(first) >= 1e9 || std::fabs(last) >= 1e9)
+    {
+        return entire(true);
+    }
+    // For a fixed base, the powers with exponents of one parity share a
+    // sign and are monotonic in the exponent, so the first and last
+    // exponent of each parity bound them
+    Interval out = empty();
+    for (double power : {first, first + 1, last - 1, last})
+    {
+        if (first <= power && power <= last)
+        {
+            out = hull(out, integerPow(base, static_cast<long>(power)));
+        }
+    }
+    out.partial = out.partial || exponent.partial;
+    return out;
+}
+
+Interval Interval::hull(const Interval& first, const Interval& second)
+{
+    if (first.isEmpty())
+    {
+        return second;
+    }
+    if (second.isEmpty())
+    {
+        return first;
+    }
+    return Interval(std::min(first.lo, second.lo),
+                    std::max(first.hi, second.hi),
+                    first.partial || second.partial);
+}
+
+Interval Interval::sin(const Interval& arg)
+{
+    if (arg.isEmpty())
+    {
+        return empty();
+    }
+    if (!std::isfinite(arg.lo) || !std::isfinite(arg.hi) ||
+                                                arg.width() >= 2 * PI)
+    {
+        return Interval(-1.0, 1.0, arg.partial);
+    }
+    double first = std::sin(arg.lo);
+    double second = std::sin(arg.hi);
+    double lo = std::min(first, second);
+    double hi = std::max(first, second);
+    if (nextPeriodic(arg.lo, PI / 2, 2 * PI) <= arg.hi)
+    {
+        hi = 1.0;
+    }
+    if (nextPeriodic(arg.lo, -PI / 2, 2 * PI) <= arg.hi)
+    {
+        lo = -1.0;
+    }
+    Interval out = outward(lo, hi, arg.partial);
+    out.lo = std::max(out.lo, -1.0);
+    out.hi = std::min(out.hi, 1.0);
+    return out;
+}
+
+Interval Interval::cos(const Interval& arg)
+{
+    if (arg.isEmpty())
+    {
+        return empty();
+    }
+    if (!std::isfinite(arg.lo) || !std::isfinite(arg.hi) ||
+                                                arg.width() >= 2 * PI)
+    {
+        return Interval(-1.0, 1.0, arg.partial);
+    }
+    double first = std::cos(arg.lo);
+    double second = std::cos(arg.hi);
+    double lo = std::min(first, second);
+    double hi = std::max(first, second);
+    if (nextPeriodic(arg.lo, 0.0, 2 * PI) <= arg.hi)
+    {
+        hi = 1.0;
+    }
+    if (nextPeriodic(arg.lo, PI, 2 * PI) <= arg.hi)
+    {
+        lo = -1.0;
+    }
+    Interval out = outward(lo, hi, arg.partial);
+    out.lo = std::max(out.lo, -1.0);
+    out.hi = std::min(out.hi, 1.0);
+    return out;
+}
+
+Interval Interval::tan(const Interval& arg)
+{
+    if (arg.isEmpty())
+    {
+        return empty();
+    }
+    if (!std::isfinite(arg.lo) || !std::isfinite(arg.hi) ||
+            nextPeriodic(arg.lo, PI / 2, PI) <= arg.hi)
+    {
+        return entire(true);
+    }
+    // tan increases between consecutive poles
+    return outward(std::tan(arg.lo), std::tan(arg.hi), arg.partial);
+}
+
+Interval Interval::cot(const Interval& arg)
+{
+    if (arg.isEmpty())
+    {
+        return empty();
+    }
+    if (!std::isfinite(arg.lo) || !std::isfinite(arg.hi) ||
+            nextPeriodic(arg.lo, 0.0, PI) <= arg.hi)
+    {
+        return entire(true);
+    }
+    // cot decreases between consecutive poles
+    return outward(1.0 / std::tan(arg.hi), 1.0 / std::tan(arg.lo),
+                                                            arg.partial);
+}
+
+Interval Interval::csc(const Interval& arg)
+{
+    return Interval(1.0) / sin(arg);
+}
+
+Interval Interval::sec(const Interval& arg)
+{
+    return Interval(1.0) / cos(arg);
+}
+
+Interval Interval::exp(const Interval& arg)
+{
+    if (arg.isEmpty())
+    {
+        return empty();
+    }
+    Interval out = outward(std::exp(arg.lo), std::exp(arg.hi), arg.partial);
+    out.lo = std::max(out.lo, 0.0);
+    return out;
+}
+
+Interval Interval::ln(const Interval& arg)
+{
+    if (arg.isEmpty() || arg.hi <= 0.0)
+    {
+        return empty();
+    }
+    return outward(std::log(std::max(arg.lo, 0.0)), std::log(arg.hi),
+                                            arg.partial || arg.lo <= 0.0);
+}
+
+Interval Interval::log(const Interval& arg, double base)
+{
+    double scale = std::log(base);
+    if (std::isnan(scale) || scale == 0.0)
+    {
+        return empty();
+    }
+    Interval natural = ln(arg);
+    if (natural.isEmpty())
+    {
+        return natural;
+    }
+    if (scale > 0)
+    {
+        return outward(natural.lo / scale, natural.hi / scale,
+                                                        natural.partial);
+    }
+    return outward(natural.hi / scale, natural.lo / scale, natural.partial);
+}
+
+Interval Interval::sqrt(const Interval& arg)
+{
+    if (arg.isEmpty() || arg.hi < 0.0)
+    {
+        return empty();
+    }
+    Interval out = outward(std::sqrt(std::max(arg.lo, 0.0)),
+                            std::sqrt(arg.hi), arg.partial || arg.lo < 0.0);
+    out.lo = std::max(out.lo, 0.0);
+    return out;
+}
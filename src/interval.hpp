@@ -0,0 +1,64 @@
+#ifndef __INTERVAL_HPP__
+#define __INTERVAL_HPP__
+
+/**
+ * @brief Closed range [lo, hi] used to bound an expression over a whole
+ * input range at once.
+ *
+ * @details Every operation returns a range that contains the result for
+ * any choice of inputs inside its arguments, widened outward by one ulp to
+ * absorb rounding. Domain problems never throw: the part of an argument
+ * outside the domain is dropped and partial is set, and an argument that
+ * lies entirely outside the domain gives the empty interval (NaN bounds).
+ * Poles give an unbounded range.
+ */
+struct Interval
+{
+    double lo;
+    double hi;
+    //! Some inputs in the range are outside the domain of the expression
+    bool partial;
+
+    Interval();
+    Interval(double value);
+    Interval(double lo, double hi, bool partial = false);
+
+    static Interval empty();
+    static Interval entire(bool partial = false);
+
+    bool isEmpty() const;
+    bool isPoint() const;
+    bool contains(double value) const;
+    double width() const;
+
+    Interval operator-() const;
+    friend Interval operator+(const Interval& first, const Interval& second);
+    friend Interval operator-(const Interval& first, const Interval& second);
+    friend Interval operator*(const Interval& first, const Interval& second);
+    friend Interval operator/(const Interval& first, const Interval& second);
+
+    static Interval pow(const Interval& base, const Interval& exponent);
+    static Interval sin(const Interval& arg);
+    static Interval cos(const Interval& arg);
+    static Interval tan(const Interval& arg);
+    static Interval cot(const Interval& arg);
+    static Interval csc(const Interval& arg);
+    static Interval sec(const Interval& arg);
+    static Interval exp(const Interval& arg);
+    static Interval ln(const Interval& arg);
+    static Interval log(const Interval& arg, double base);
+    static Interval sqrt(const Interval& arg);
+
+private:
+    static Interval outward(double lo, double hi, bool partial);
+    static Interval integerPow(const Interval& base, long exponent);
+    //! Hull of base^n over the integers n in exponent
+    static Interval integerPowers(const Interval& base,
+                                                const Interval& exponent);
+    //! Smallest interval holding both, empty ones are ignored
+    static Interval hull(const Interval& first, const Interval& second);
+    static double product(double first, double second);
+    static double nextPeriodic(double start, double offset, double period);
+};
+
+#endif // __INTERVAL_HPP__
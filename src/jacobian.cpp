@@ -0,0 +1,203 @@
+#include "jacobian.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "thread_pool.hpp"
+
+#include <functional>
+#include <stdexcept>
+
+Jacobian::Jacobian(std::vector<std::string> inputs,
+                    std::vector<std::string> wrt, int threads)
+{
+    this->threads = threads;
+    for (const auto& input : inputs)
+    {
+        this->roots.push_back(parse(input));
+    }
+    for (const auto& var : wrt)
+    {
+        this->variables.push_back(Derivative::parseVariable(var));
+    }
+}
+
+Jacobian::Jacobian(std::vector<nodePtr> roots, std::vector<varPtr> wrt,
+                                                                int threads)
+{
+    this->threads = threads;
+    for (const auto& root : roots)
+    {
+        auto copy = root->cloneTree();
+        TreeFixer::checkTree(copy);
+        copy = TreeFixer::simplify(copy);
+        this->roots.push_back(copy);
+    }
+    this->variables = wrt;
+}
+
+std::shared_ptr<ExpressionNode> Jacobian::parse(std::string input)
+{
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    if (!root)
+    {
+        throw std::runtime_error("Empty expression in Jacobian");
+    }
+    TreeFixer::checkTree(root);
+    root = TreeFixer::simplify(root);
+    return root;
+}
+
+std::vector<std::vector<std::shared_ptr<ExpressionNode>>> Jacobian::solve()
+{
+    std::vector<std::vector<nodePtr>> columns(this->variables.size());
+    ThreadPool pool(std::min<int>(this->threads > 0 ? this->threads :
+                    std::thread::hardware_concurrency(),
+                    std::max<int>(this->variables.size(), 1)));
+    pool.parallelFor(this->variables.size(), [&](int col) {
+        columns[col] = this->solveColumn(this->variables[col]);
+    });
+
+    std::vector<std::vector<nodePtr>> out(this->roots.size(),
+                            std::vector<nodePtr>(this->variables.size()));
+    for (int col = 0; col < columns.size(); col++)
+    {
+        for (int row = 0; row < this->roots.size(); row++)
+        {
+            out[row][col] = columns[col][row];
+        }
+    }
+    return out;
+}
+
+std::vector<std::shared_ptr<ExpressionNode>> Jacobian::solveColumn(varPtr wrt)
+{
+    // Private copies keep this column independent of the other threads
+    nodeTable seen;
+    std::vector<nodePtr> rows;
+    for (const auto& root : this->roots)
+    {
+        rows.push_back(share(root->cloneTree(), seen));
+    }
+
+    Derivative engine(wrt);
+    engine.log.setEnabled(false);
+    std::vector<nodePtr> out;
+    for (const auto& row : rows)
+    {
+        engine.solve(row);
+    }
+    // Entries may share nodes through the merged rows, simplify leaves
+    // shared nodes alone so no copy is needed
+    for (const auto& row : rows)
+    {
+        out.push_back(TreeFixer::simplify(row->getDerivative()));
+    }
+    return out;
+}
+
+std::vector<std::shared_ptr<ExpressionNode>> Jacobian::gradient(
+            std::string input, std::vector<std::string> wrt, int threads)
+{
+    Jacobian jacobian({input}, wrt, threads);
+    return jacobian.solve()[0];
+}
+
+/**
+ * @brief merges node into an identical, already seen node
+ *
+ * @details Children are merged first, so two nodes are identical exactly
+ * when their tokens match and their children are the same objects.
+ *
+ * @return the node that should be used in place of node
+ */
+std::shared_ptr<ExpressionNode> Jacobian::share(nodePtr node, nodeTable& seen)
+{
+    if (!node)
+    {
+        return nullptr;
+    }
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        bool leftIsArgument = node->getLeft() == func->getSubExprTree();
+        func->setSubExprTree(share(func->getSubExprTree(), seen));
+        if (leftIsArgument && node->getLeft())
+        {
+            node->setLeft(func->getSubExprTree());
+        }
+        else if (node->getLeft())
+        {
+            node->setLeft(share(node->getLeft(), seen));
+        }
+    }
+    else
+    {
+        if (node->getLeft())
+        {
+            node->setLeft(share(node->getLeft(), seen));
+        }
+        if (node->getRight())
+        {
+            node->setRight(share(node->getRight(), seen));
+        }
+    }
+
+    auto& bucket = seen[hashNode(node)];
+    for (const auto& candidate : bucket)
+    {
+        if (sameNode(candidate, node))
+        {
+            return candidate;
+        }
+    }
+    bucket.push_back(node);
+    return node;
+}
+
+std::size_t Jacobian::hashNode(nodePtr node)
+{
+    std::size_t hash = std::hash<int>()(static_cast<int>(node->getType()));
+    auto combine = [&hash](std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+    if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(node->getToken());
+        combine(std::hash<std::string>()(func->getStr()));
+        combine(std::hash<bool>()(func->isNegative()));
+        combine(std::hash<ExpressionNode*>()(func->getSubExprTree().get()));
+    }
+    else
+    {
+        combine(std::hash<std::string>()(node->getToken()->getFullStr()));
+    }
+    combine(std::hash<ExpressionNode*>()(node->getLeft().get()));
+    combine(std::hash<ExpressionNode*>()(node->getRight().get()));
+    return hash;
+}
+
+bool Jacobian::sameNode(nodePtr first, nodePtr second)
+{
+    if (first->getType() != second->getType() ||
+            first->getLeft() != second->getLeft() ||
+            first->getRight() != second->getRight())
+    {
+        return false;
+    }
+    if (first->getType() == TokenType::FUNCTION)
+    {
+        auto firstFunc = std::dynamic_pointer_cast<Function>(
+                                                        first->getToken());
+        auto secondFunc = std::dynamic_pointer_cast<Function>(
+                                                        second->getToken());
+        return firstFunc->getStr() == secondFunc->getStr() &&
+            firstFunc->isNegative() == secondFunc->isNegative() &&
+            firstFunc->getSubscript() == secondFunc->getSubscript() &&
+            firstFunc->getSubExprTree() == secondFunc->getSubExprTree();
+    }
+    return first->getToken()->getFullStr() == second->getToken()->getFullStr();
+}
@@ -0,0 +1,66 @@
+#ifndef __JACOBIAN_HPP__
+#define __JACOBIAN_HPP__
+
+#include "expression_node.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Symbolic Jacobian of a list of expressions against a list of
+ * variables.
+ *
+ * @details Every expression is parsed and simplified once. Each column
+ * (variable) is then solved as one task on a thread pool: the rows are
+ * cloned, identical sub-trees across all rows are merged into a single
+ * node, and one Derivative pass runs over the merged rows. Because
+ * derivatives are memoized per node, a sub-expression that appears in
+ * several entries is only differentiated once per column.
+ */
+class Jacobian
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+    typedef std::shared_ptr<Variable> varPtr;
+    typedef std::unordered_map<std::size_t, std::vector<nodePtr>> nodeTable;
+private:
+    std::vector<nodePtr> roots;
+    std::vector<varPtr> variables;
+    int threads;
+
+    std::vector<nodePtr> solveColumn(varPtr wrt);
+    static nodePtr parse(std::string input);
+    static nodePtr share(nodePtr node, nodeTable& seen);
+    static bool sameNode(nodePtr first, nodePtr second);
+    static std::size_t hashNode(nodePtr node);
+public:
+    /**
+     * @brief Parses the expressions and differentiating variables
+     *
+     * @param inputs the rows of the Jacobian
+     * @param wrt the columns of the Jacobian
+     * @param threads worker threads, 0 uses the hardware concurrency
+     */
+    Jacobian(std::vector<std::string> inputs, std::vector<std::string> wrt,
+                                                            int threads = 0);
+    Jacobian(std::vector<nodePtr> roots, std::vector<varPtr> wrt,
+                                                            int threads = 0);
+
+    /**
+     * @brief calculates every entry of the Jacobian
+     *
+     * @return entries indexed by [expression][variable]. Each entry is an
+     * independent, simplified tree.
+     */
+    std::vector<std::vector<nodePtr>> solve();
+
+    /**
+     * @brief calculates the gradient of a single expression
+     */
+    static std::vector<nodePtr> gradient(std::string input,
+                        std::vector<std::string> wrt, int threads = 0);
+};
+
+#endif // __JACOBIAN_HPP__
@@ -14,7 +14,8 @@ std::string LaTeXConverter::convertToLaTeX(std::shared_ptr<ExpressionNode> root)
     return nodeToLaTeX(root);
 }
 
-std::string LaTeXConverter::nodeToLaTeX(std::shared_ptr<ExpressionNode> node)
+std::string LaTeXConverter::nodeToLaTeX(std::shared_ptr<ExpressionNode> node,
+                                std::shared_ptr<ExpressionNode> exponent)
 {
     if (!node)
         return "";
@@ -53,14 +54,14 @@ std::string LaTeXConverter::nodeToLaTeX(std::shared_ptr<ExpressionNode> node)
         }
         else if (op == "^")  
         {
-            latex << parens(nodeToLaTeX(node->getLeft())) 
+            latex << parens(nodeToLaTeX(node->getLeft(), node->getRight())) 
                     << "^{" << parens(nodeToLaTeX(node->getRight())) << "}";
         }
         out =  latex.str();
     }
     else if (TokenType::FUNCTION == type )
     {
-        out = functionToLaTeX(node);
+        out = functionToLaTeX(node, exponent);
     }
     else
     {
@@ -73,53 +74,127 @@ std::string LaTeXConverter::nodeToLaTeX(std::shared_ptr<ExpressionNode> node)
 
 
 std::string LaTeXConverter::functionToLaTeX(std::shared_ptr<ExpressionNode> 
-                                                                        node)
+                    node, std::shared_ptr<ExpressionNode> exponent)
 {
     auto token = std::dynamic_pointer_cast<Function>(node->getToken());
     if (!token)
         return "";
 
-    std::string funcName = token->getStr();
-    std::string latexFunc;
+    std::string latexFunc = functionName(token->getStr());
+
+    // A function that is the base of an exponent repeats it next to its
+    // name. The caller passes it down, a shared node has no single parent
+    if (exponent)
+    {
+        std::stringstream latex;
+        latex << latexFunc << "^{" << nodeToLaTeX(exponent) << "}";
+        latexFunc = latex.str();
+    }
 
-    
+    // Function's argument inside \left( and \right)
+    std::string argument = nodeToLaTeX(token->getSubExprTree());
+    return latexFunc + "\\left(" + argument + "\\right)";
+}
+
+
+std::string LaTeXConverter::functionName(std::string funcName)
+{
     if (funcName == "sin")
-        latexFunc = "\\sin";
+        return "\\sin";
     else if (funcName == "cos")
-        latexFunc = "\\cos";
+        return "\\cos";
     else if (funcName == "tan")
-        latexFunc = "\\tan";
+        return "\\tan";
     else if (funcName == "cot")
-        latexFunc = "\\cot";
+        return "\\cot";
     else if (funcName == "csc")
-        latexFunc = "\\csc";
+        return "\\csc";
     else if (funcName == "sec")
-        latexFunc = "\\sec";
+        return "\\sec";
     else if (funcName == "exp")
-        latexFunc = "\e^";
+        return "\e^";
     else if (funcName == "ln")
-        latexFunc = "\\ln";
+        return "\\ln";
     else if (funcName == "sqrt")
-        latexFunc = "\\sqrt";
-    else
-        latexFunc = "\\" + funcName;  // Default case, add backslash
+        return "\\sqrt";
+    return "\\" + funcName;  // Default case, add backslash
+}
 
-    // Check if the function has a parent operator that is an exponent
-    auto parent = node->getParent().lock();
-    if (parent && parent->getToken()->getType() == 
-            TokenType::OPERATOR && parent->getToken()->getStr() == "^")
+std::string LaTeXConverter::convertToLaTeX(const FlatTree& tree)
+{
+    if (tree.size() == 0)
+        return "";
+
+    // A function that is the base of an exponent repeats the exponent next
+    // to its name, so each entry needs to know its parent.
+    std::vector<int> parents(tree.size(), -1);
+    for (int idx = 0; idx < tree.size(); idx++)
     {
-        std::stringstream latex;
-        latex << latexFunc << "^{" << nodeToLaTeX(parent->getRight()) << "}";
-        latexFunc = latex.str();
+        if (tree.getLeft(idx) != -1)
+            parents[tree.getLeft(idx)] = idx;
+        if (tree.getRight(idx) != -1)
+            parents[tree.getRight(idx)] = idx;
     }
 
-    // Function's argument inside \left( and \right)
-    std::string argument = nodeToLaTeX(token->getSubExprTree());
-    return latexFunc + "\\left(" + argument + "\\right)";
+    // Children always come before their parent, so one pass is enough
+    std::vector<std::string> out(tree.size());
+    for (int idx = 0; idx < tree.size(); idx++)
+    {
+        OpCode code = tree.getOpCode(idx);
+        int left = tree.getLeft(idx);
+        int right = tree.getRight(idx);
+        std::stringstream latex;
+        switch (code)
+        {
+            case OpCode::INTEGER:
+            case OpCode::REAL:
+            case OpCode::VARIABLE:
+                latex << "{" << tree.getString(idx) << "}";
+                break;
+            case OpCode::NEGATE:
+                if (tree.getFirst(left) == left)
+                {
+                    latex << "{-" << tree.getString(left) << "}";
+                }
+                else
+                {
+                    latex << "-" << parens(out[left]);
+                }
+                break;
+            case OpCode::ADD:
+                latex << parens(out[left]) << " + " << parens(out[right]);
+                break;
+            case OpCode::SUBTRACT:
+                latex << parens(out[left]) << " - " << parens(out[right]);
+                break;
+            case OpCode::MULTIPLY:
+                latex << parens(out[left]) << " \\cdot " << parens(out[right]);
+                break;
+            case OpCode::DIVIDE:
+                latex << "\\dfrac{" << parens(out[left]) << "}"
+                        << "{" << parens(out[right]) << "}";
+                break;
+            case OpCode::POWER:
+                // The exponent is only known now, redo a function base
+                if (FlatTree::isFunction(tree.getOpCode(left)))
+                {
+                    out[left] = functionName(FlatTree::getFunctionName(
+                                                    tree.getOpCode(left)))
+                        + "^{" + out[right] + "}"
+                        + "\\left(" + out[tree.getLeft(left)] + "\\right)";
+                }
+                latex << parens(out[left]) << "^{" << parens(out[right]) << "}";
+                break;
+            default:
+                latex << functionName(FlatTree::getFunctionName(code))
+                        << "\\left(" << out[left] << "\\right)";
+                break;
+        }
+        out[idx] = latex.str();
+    }
+    return out[tree.root()];
 }
 
-
 std::string LaTeXConverter::parens(std::string str)
 {
     return "\\left(" + str + "\\right)";
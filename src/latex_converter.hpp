@@ -2,6 +2,8 @@
 #define __LATEX_CONVERTER_HPP__
 
 #include "expression_node.hpp"
+#include "flat_tree.hpp"
+
 #include <string>
 #include <memory>
 
@@ -11,12 +13,19 @@ public:
     // Converts the entire expression tree into a LaTeX string
     static std::string convertToLaTeX(std::shared_ptr<ExpressionNode> root);
 
+    // Converts a frozen tree into a LaTeX string in a single linear pass
+    static std::string convertToLaTeX(const FlatTree& tree);
+
 private:
-    // Helper function to convert a single node to LaTeX
-    static std::string nodeToLaTeX(std::shared_ptr<ExpressionNode> node);
+    // Helper function to convert a single node to LaTeX, exponent is set
+    // when node is the base of a power
+    static std::string nodeToLaTeX(std::shared_ptr<ExpressionNode> node,
+                        std::shared_ptr<ExpressionNode> exponent = nullptr);
 
     // Function to handle LaTeX formatting for functions like sin, cos, etc.
-    static std::string functionToLaTeX(std::shared_ptr<ExpressionNode> node);
+    static std::string functionToLaTeX(std::shared_ptr<ExpressionNode> node,
+                                    std::shared_ptr<ExpressionNode> exponent);
+    static std::string functionName(std::string funcName);
     static std::string parens(std::string str);
 };
 
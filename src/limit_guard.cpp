@@ -0,0 +1,150 @@
+#include "limit_guard.hpp"
+
+#include <string>
+
+// Per thread: the installed guard, the nesting and the clock countdown
+static thread_local LimitGuard* installed = nullptr;
+static thread_local int nesting = 0;
+static thread_local int ticks = 0;
+
+static std::string describe(LimitExceeded::Limit limit,
+                                                const LimitStats& stats)
+{
+    std::string out;
+    switch (limit)
+    {
+        case LimitExceeded::Limit::NODES:
+            out = "Node limit exceeded";
+            break;
+        case LimitExceeded::Limit::DEPTH:
+            out = "Depth limit exceeded";
+            break;
+        case LimitExceeded::Limit::DEADLINE:
+            out = "Deadline exceeded";
+            break;
+    }
+    return out + ": " + std::to_string(stats.nodes) + " nodes, depth " +
+                std::to_string(stats.depth) + ", " +
+                std::to_string(stats.seconds) + " s";
+}
+
+LimitExceeded::LimitExceeded(Limit limit, const LimitStats& stats)
+    : std::runtime_error(describe(limit, stats)), limit(limit),
+    stats(stats) {}
+
+LimitExceeded::Limit LimitExceeded::getLimit() const
+{
+    return this->limit;
+}
+
+const LimitStats& LimitExceeded::getStats() const
+{
+    return this->stats;
+}
+
+LimitGuard::LimitGuard(const Limits& limits)
+    : limits(limits), start(std::chrono::steady_clock::now()), nodes(0),
+    deepest(0) {}
+
+LimitGuard::Scope::Scope(LimitGuard* guard, int depth)
+    : previous(installed), previousDepth(nesting), active(guard)
+{
+    if (guard)
+    {
+        installed = guard;
+        nesting = depth;
+        // A countdown left by an earlier guard would check the clock on
+        // this one's first node
+        ticks = 0;
+    }
+}
+
+LimitGuard::Scope::~Scope()
+{
+    if (this->active)
+    {
+        installed = this->previous;
+        nesting = this->previousDepth;
+    }
+}
+
+LimitGuard::Level::Level()
+{
+    nesting++;
+    LimitGuard* guard = installed;
+    if (!guard)
+    {
+        return;
+    }
+    int seen = guard->deepest.load(std::memory_order_relaxed);
+    while (nesting > seen && !guard->deepest.compare_exchange_weak(seen,
+                                    nesting, std::memory_order_relaxed))
+    {
+    }
+    if (guard->limits.maxDepth > 0 && nesting > guard->limits.maxDepth)
+    {
+        // The destructor does not run when a constructor throws
+        nesting--;
+        guard->fail(LimitExceeded::Limit::DEPTH);
+    }
+    guard->tick();
+}
+
+LimitGuard::Level::~Level()
+{
+    nesting--;
+}
+
+LimitGuard* LimitGuard::current()
+{
+    return installed;
+}
+
+int LimitGuard::depth()
+{
+    return nesting;
+}
+
+void LimitGuard::countNode()
+{
+    LimitGuard* guard = installed;
+    if (!guard)
+    {
+        return;
+    }
+    long count = guard->nodes.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (guard->limits.maxNodes > 0 && count > guard->limits.maxNodes)
+    {
+        guard->fail(LimitExceeded::Limit::NODES);
+    }
+    guard->tick();
+}
+
+void LimitGuard::tick()
+{
+    if (++ticks < CLOCK_STRIDE)
+    {
+        return;
+    }
+    ticks = 0;
+    if (this->limits.seconds > 0 && this->getStats().seconds >
+                                                        this->limits.seconds)
+    {
+        this->fail(LimitExceeded::Limit::DEADLINE);
+    }
+}
+
+void LimitGuard::fail(LimitExceeded::Limit limit)
+{
+    throw LimitExceeded(limit, this->getStats());
+}
+
+LimitStats LimitGuard::getStats() const
+{
+    LimitStats stats;
+    stats.nodes = this->nodes.load(std::memory_order_relaxed);
+    stats.depth = this->deepest.load(std::memory_order_relaxed);
+    stats.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - this->start).count();
+    return stats;
+}
@@ -0,0 +1,133 @@
+#ifndef __LIMIT_GUARD_HPP__
+#define __LIMIT_GUARD_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+/**
+ * @brief Resource limits for one request, 0 leaves a limit off.
+ */
+struct Limits
+{
+    long maxNodes = 0;      //!< expression nodes created
+    int maxDepth = 0;       //!< nesting of differentiation and simplification
+    double seconds = 0.0;   //!< wall-clock time from the guard's creation
+};
+
+/**
+ * @brief What a guarded request had used by the time it stopped.
+ */
+struct LimitStats
+{
+    long nodes = 0;
+    int depth = 0;          //!< deepest nesting reached
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Thrown by a LimitGuard when one of its limits is exceeded.
+ */
+class LimitExceeded : public std::runtime_error
+{
+public:
+    enum class Limit
+    {
+        NODES,
+        DEPTH,
+        DEADLINE
+    };
+
+    LimitExceeded(Limit limit, const LimitStats& stats);
+
+    Limit getLimit() const;
+    const LimitStats& getStats() const;
+
+private:
+    Limit limit;
+    LimitStats stats;
+};
+
+/**
+ * @brief Enforces Limits on the work done while it is installed.
+ *
+ * @details Checks are cooperative. Every ExpressionNode created counts
+ * against the node budget, and Derivative::solve and TreeFixer::simplify
+ * hold a Level per node they visit, which checks the depth. Both read
+ * the clock every CLOCK_STRIDE calls. The first check that fails throws
+ * LimitExceeded, as does every later one, so the request unwinds fast;
+ * whatever it was building should be dropped.
+ *
+ * A guard is installed per thread by a Scope. The tasks of a parallel
+ * Derivative::solve install their parent's guard, so they share its
+ * budget.
+ */
+class LimitGuard
+{
+public:
+    LimitGuard(const Limits& limits);
+
+    LimitGuard(const LimitGuard&) = delete;
+    LimitGuard& operator=(const LimitGuard&) = delete;
+
+    /**
+     * @brief Installs a guard on the calling thread until destroyed.
+     *
+     * @details Scopes nest, the innermost guard applies. A null guard
+     * leaves the installed one in place.
+     * @param depth the nesting to start from, LimitGuard::depth() of the
+     * thread that handed the work over.
+     */
+    class Scope
+    {
+    public:
+        Scope(LimitGuard* guard, int depth = 0);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LimitGuard* previous;
+        int previousDepth;
+        bool active;
+    };
+
+    /**
+     * @brief One level of nesting on the calling thread.
+     */
+    class Level
+    {
+    public:
+        Level();
+        ~Level();
+
+        Level(const Level&) = delete;
+        Level& operator=(const Level&) = delete;
+    };
+
+    //! Guard installed on the calling thread, null if none
+    static LimitGuard* current();
+
+    //! Nesting on the calling thread
+    static int depth();
+
+    //! Counts a node against the installed guard, if any
+    static void countNode();
+
+    LimitStats getStats() const;
+
+private:
+    //! Nodes and levels between two reads of the clock, per thread
+    static const int CLOCK_STRIDE = 256;
+
+    Limits limits;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<long> nodes;
+    std::atomic<int> deepest;
+
+    void tick();
+    [[noreturn]] void fail(LimitExceeded::Limit limit);
+};
+
+#endif // __LIMIT_GUARD_HPP__
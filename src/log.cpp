@@ -14,6 +14,17 @@ Logger::Logger(bool useLaTeX)
         this->converter = TextConverter::convertToText;
     }
     depth = 0;
+    enabled = true;
+}
+
+void Logger::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+bool Logger::isEnabled() const
+{
+    return this->enabled;
 }
 
 std::string Logger::str(std::string in)
@@ -36,6 +47,10 @@ void Logger::setOutput(nodePtr node)
 
 void Logger::logChainRule(nodePtr function, nodePtr subDerivative)
 {
+    if (!this->enabled)
+    {
+        return;
+    }
     
     std::vector<std::string> step;
     step.emplace_back(str("Rule") + ": " + str("chain") );
@@ -49,6 +64,10 @@ void Logger::logChainRule(nodePtr function, nodePtr subDerivative)
 }
 void Logger::logProductRule(nodePtr node)
 {
+    if (!this->enabled)
+    {
+        return;
+    }
     nodePtr left = node->getLeft();
     nodePtr right = node->getRight();
     std::vector<std::string> step;
@@ -64,6 +83,10 @@ void Logger::logProductRule(nodePtr node)
 }
 void Logger::logQuotientRule(nodePtr node)
 {
+    if (!this->enabled)
+    {
+        return;
+    }
     nodePtr left = node->getLeft();
     nodePtr right = node->getRight();
     std::vector<std::string> step;
@@ -79,6 +102,10 @@ void Logger::logQuotientRule(nodePtr node)
 }
 void Logger::logPowerRule(nodePtr node)
 {
+    if (!this->enabled)
+    {
+        return;
+    }
     nodePtr left = node->getLeft();
     nodePtr right = node->getRight();
     std::vector<std::string> step;
@@ -96,6 +123,10 @@ void Logger::logPowerRule(nodePtr node)
 }
 void Logger::logAddition(nodePtr node)
 {
+    if (!this->enabled)
+    {
+        return;
+    }
     nodePtr left = node->getLeft();
     nodePtr right = node->getRight();
     std::vector<std::string> step;
@@ -111,6 +142,10 @@ void Logger::logAddition(nodePtr node)
 }
 void Logger::logSubtraction(nodePtr node)
 {
+    if (!this->enabled)
+    {
+        return;
+    }
     nodePtr left = node->getLeft();
     nodePtr right = node->getRight();
     std::vector<std::string> step;
@@ -242,7 +277,7 @@ std::string Logger::out()
     {
         this->addLine("approximations",false);
         this->addBrace("[");
-        for (int i = 0; i < tests.size(); i++)
+        for (int i = 0; i < approximations.size(); i++)
         {
             this->outStr += this->indent() + 
                 std::to_string(approximations[i].first) + ": " + 
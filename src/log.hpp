@@ -27,9 +27,13 @@ private:
     void addBrace(std::string c, bool endComma=false);
     std::vector<std::pair<std::string,bool>> tests;
     std::vector<std::pair<double,double>> approximations;
+    bool enabled;
 
 public:
     Logger(bool useLaTeX);
+    //! Disabled loggers skip rendering steps, for batch work
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
     void setInput(std::string input);
     void setMode(std::string input);
     void setOutput(nodePtr node);
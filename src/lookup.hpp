@@ -11,34 +11,143 @@
 #include "token.hpp"
 #include "function_defs.hpp"
 
-#include <unordered_map>
+#include <memory>
+#include <string_view>
 
-struct PairHash
+/**
+ * @brief One row of the symbol table
+ */
+struct SymbolEntry
 {
-    template <class T1, class T2>
-    std::size_t operator() (const std::pair<T1, T2>& pair) const
-    {
-        return std::hash<T1>()(pair.first) ^ std::hash<T2>()(pair.second);
-    }
+    std::string_view name;          //!< Text of the symbol
+    TokenType type;                 //!< Token type the symbol lexes to
+    SymbolProperties properties;    //!< Precedence and associativity
 };
 
 /**
  * @brief class that contains lookup tables and methods to access them
  *
+ * The tables are constexpr, so nothing here runs at program start.
  */
 class Lookup
 {
 public:
-    static std::unordered_map<std::pair<TokenType, TokenType>, bool, PairHash>
-        implicitMultiplication;
-    static std::unordered_map<std::string, std::shared_ptr<FunctionDefinition>>
-        functionLookup;
-    static std::unordered_map<std::string,
-        std::pair<TokenType, SymbolProperties>> symbolTable;
+    //! Number of TokenType values, the side of implicitMultiplication
+    static constexpr int TOKEN_TYPES = static_cast<int>(TokenType::STRING) + 1;
+    //! Number of entries in symbolTable
+    static constexpr int SYMBOL_COUNT = 18;
+
+    //! implicitMultiplication[left][right] is true if a '*' goes between
+    static constexpr bool implicitMultiplication[TOKEN_TYPES][TOKEN_TYPES] = {
+        //         NONE   NUMBER VAR    OP     FUNC   LPAREN RPAREN UNDER  STR
+        /* NONE */ {false, false, false, false, false, false, false, false, false},
+        /* NUM  */ {false, true,  true,  false, true,  true,  false, false, false},
+        /* VAR  */ {false, true,  true,  false, true,  true,  false, false, false},
+        /* OP   */ {false, false, false, false, false, false, false, false, false},
+        /* FUNC */ {false, true,  true,  false, true,  false, false, false, false},
+        /* LPAR */ {false, false, false, false, false, false, false, false, false},
+        /* RPAR */ {false, true,  true,  false, true,  false, false, false, false},
+        /* UNDR */ {false, false, false, false, false, false, false, false, false},
+        /* STR  */ {false, false, false, false, false, false, false, false, false},
+    };
+
+    //! Every operator and function name, sorted by name for findSymbol
+    static constexpr SymbolEntry symbolTable[SYMBOL_COUNT] = {
+        {"(", TokenType::LEFTPAREN, {20, Associativity::NONE, false}},
+        {")", TokenType::RIGHTPAREN, {20, Associativity::NONE, false}},
+        {"*", TokenType::OPERATOR, {11, Associativity::LEFT, true}},
+        {"+", TokenType::OPERATOR, {10, Associativity::LEFT, true}},
+        {"-", TokenType::OPERATOR, {10, Associativity::LEFT, false}},
+        {"/", TokenType::OPERATOR, {11, Associativity::LEFT, false}},
+        {"^", TokenType::OPERATOR, {12, Associativity::RIGHT, false}},
+        {"_", TokenType::UNDERSCORE, {20, Associativity::NONE, false}},
+        {"cos", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"cot", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"csc", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"exp", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"ln", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"log", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"sec", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"sin", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"sqrt", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+        {"tan", TokenType::FUNCTION, {2, Associativity::NONE, false}},
+    };
+
+    /**
+     * @brief Checks whether a '*' is implied between two adjacent tokens
+     * @param left Type of the first token
+     * @param right Type of the token after it
+     * @return true if the tokenizer should insert a multiplication
+     */
+    static constexpr bool isImplicit(TokenType left, TokenType right)
+    {
+        return implicitMultiplication[static_cast<int>(left)]
+                                        [static_cast<int>(right)];
+    }
+
+    /**
+     * @brief Binary searches symbolTable
+     * @param name Text of the symbol
+     * @return The entry, or nullptr if name is not a symbol
+     */
+    static constexpr const SymbolEntry* findSymbol(std::string_view name)
+    {
+        int low = 0;
+        int high = SYMBOL_COUNT;
+        while (low < high)
+        {
+            int mid = (low + high) / 2;
+            if (symbolTable[mid].name < name)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        if (low < SYMBOL_COUNT && symbolTable[low].name == name)
+        {
+            return &symbolTable[low];
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Gets the calling thread's definition of a function
+     *
+     * FunctionDefinition keeps per-call state, so each thread gets its own
+     * set, built the first time that thread asks for one.
+     * @param name Name of the function
+     * @return The definition, or nullptr if there is none (log)
+     */
+    static std::shared_ptr<FunctionDefinition> getFunction(
+                                                    std::string_view name);
     static std::string getTokenType(TokenType type);
 
-};
+    /**
+     * @brief Checks the order findSymbol relies on
+     * @return true if symbolTable is sorted by name
+     */
+    static constexpr bool isSorted()
+    {
+        for (int idx = 1; idx < SYMBOL_COUNT; idx++)
+        {
+            if (!(symbolTable[idx - 1].name < symbolTable[idx].name))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 
+private:
+    static std::shared_ptr<FunctionDefinition> makeFunction(
+                                                    std::string_view name);
+};
 
+static_assert(Lookup::isImplicit(TokenType::RIGHTPAREN, TokenType::VARIABLE),
+                        "implicitMultiplication rows follow TokenType order");
+static_assert(Lookup::isSorted(), "symbolTable must be sorted by name");
 
-#endif // __LOOKUP_HPP__
\ No newline at end of file
+#endif // __LOOKUP_HPP__
@@ -6,14 +6,27 @@
 #include "approx.hpp"
 #include "tokenizer.hpp"
 #include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "code_converter.hpp"
+#include "tabulator.hpp"
+#include "root_finder.hpp"
+#include "integrator.hpp"
+#include "taylor.hpp"
+#include "derivative_cache.hpp"
+#include "equivalence.hpp"
+#include "bindings.hpp"
+#include "eval_optimizer.hpp"
+#include "limit_guard.hpp"
 
 
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <memory>
 #include <utility>
 #include <vector>
 #include <cfloat>
+#include <cmath>
 #include <stdexcept>
 
 #ifndef TEST_VERSION
@@ -27,8 +40,51 @@ struct Options
     std::string variable = "x"; // Default value
     std::string test = "";      // Default value
     double approximateValue = DBL_MAX; // Default value
+    bool codegen = false;       // Print C source instead of the log
+    bool ssa = false;           // Print f and f' as shared assignments
+    std::string range = "";     // start:stop:step grid to tabulate
+    std::string output = "";    // Tabulation file, stdout if empty
+    bool csv = false;           // Tabulate as CSV instead of binary
+    std::string roots = "";     // lo:hi interval to search for roots
+    bool halley = false;        // Use Halley's method for --roots
+    std::string integrate = ""; // lo:hi interval to integrate over
+    double tolerance = 1e-10;   // Tolerance for --integrate
+    double taylorPoint = 0.0;   // Expansion point for --taylor
+    int taylorOrder = -1;       // Order for --taylor, -1 when not set
+    std::string cache = "";     // Derivative cache file, none if empty
+    std::string bind = "";      // a=2,b=3 values for the other variables
+    Limits limits;              // Node, depth and time limits, off if 0
 };
 
+// Reads the lo:hi bounds of --roots and --integrate
+std::pair<double, double> parseInterval(const std::string& option,
+                                                const std::string& text)
+{
+    std::size_t split = text.find(':');
+    std::pair<double, double> out;
+    bool valid = split != std::string::npos;
+    try
+    {
+        std::size_t used = 0;
+        std::string lo = text.substr(0, split);
+        std::string hi = valid ? text.substr(split + 1) : "";
+        out.first = std::stod(lo, &used);
+        valid = valid && used == lo.size();
+        out.second = std::stod(hi, &used);
+        valid = valid && used == hi.size();
+    }
+    catch (const std::exception&)
+    {
+        valid = false;
+    }
+    if (!valid || !std::isfinite(out.first) || !std::isfinite(out.second))
+    {
+        throw std::invalid_argument(option + " expects lo:hi, got \"" +
+                                                                text + "\"");
+    }
+    return out;
+}
+
 Options parseArguments(const std::vector<std::string>& args) {
     Options options;
     bool functionSet = false;  // Track if function was explicitly set
@@ -85,6 +141,186 @@ Options parseArguments(const std::vector<std::string>& args) {
                             "Missing argument for --approximate");
             }
         }
+        else if (args[i] == "-c" || args[i] == "--codegen")
+        {
+            options.codegen = true;
+        }
+        else if (args[i] == "--ssa")
+        {
+            options.ssa = true;
+        }
+        else if (args[i] == "-r" || args[i] == "--range")
+        {
+            if (i + 1 < args.size())
+            {
+                options.range = args[i + 1];
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument("Missing argument for --range");
+            }
+        }
+        else if (args[i] == "-o" || args[i] == "--output")
+        {
+            if (i + 1 < args.size())
+            {
+                options.output = args[i + 1];
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument("Missing argument for --output");
+            }
+        }
+        else if (args[i] == "--csv")
+        {
+            options.csv = true;
+        }
+        else if (args[i] == "--roots")
+        {
+            if (i + 1 < args.size())
+            {
+                options.roots = args[i + 1];
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument("Missing argument for --roots");
+            }
+        }
+        else if (args[i] == "--halley")
+        {
+            options.halley = true;
+        }
+        else if (args[i] == "--integrate")
+        {
+            if (i + 1 < args.size())
+            {
+                options.integrate = args[i + 1];
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument(
+                            "Missing argument for --integrate");
+            }
+        }
+        else if (args[i] == "--taylor")
+        {
+            if (i + 2 < args.size())
+            {
+                options.taylorPoint = std::stod(args[i + 1]);
+                options.taylorOrder = std::stoi(args[i + 2]);
+                if (options.taylorOrder < 0)
+                {
+                    throw std::invalid_argument(
+                            "--taylor order must not be negative");
+                }
+                i += 2;
+            }
+            else
+            {
+                throw std::invalid_argument(
+                            "Missing arguments for --taylor <point> <order>");
+            }
+        }
+        else if (args[i] == "--tolerance")
+        {
+            if (i + 1 < args.size())
+            {
+                options.tolerance = std::stod(args[i + 1]);
+                if (!(options.tolerance > 0) ||
+                                        !std::isfinite(options.tolerance))
+                {
+                    throw std::invalid_argument(
+                            "--tolerance must be positive");
+                }
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument(
+                            "Missing argument for --tolerance");
+            }
+        }
+        else if (args[i] == "--cache")
+        {
+            if (i + 1 < args.size())
+            {
+                options.cache = args[i + 1];
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument("Missing argument for --cache");
+            }
+        }
+        else if (args[i] == "--bind")
+        {
+            if (i + 1 < args.size())
+            {
+                options.bind = args[i + 1];
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument("Missing argument for --bind");
+            }
+        }
+        else if (args[i] == "--max-nodes")
+        {
+            if (i + 1 < args.size())
+            {
+                options.limits.maxNodes = std::stol(args[i + 1]);
+                if (options.limits.maxNodes < 0)
+                {
+                    throw std::invalid_argument(
+                            "--max-nodes must not be negative");
+                }
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument(
+                            "Missing argument for --max-nodes");
+            }
+        }
+        else if (args[i] == "--max-depth")
+        {
+            if (i + 1 < args.size())
+            {
+                options.limits.maxDepth = std::stoi(args[i + 1]);
+                if (options.limits.maxDepth < 0)
+                {
+                    throw std::invalid_argument(
+                            "--max-depth must not be negative");
+                }
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument(
+                            "Missing argument for --max-depth");
+            }
+        }
+        else if (args[i] == "--timeout")
+        {
+            if (i + 1 < args.size())
+            {
+                options.limits.seconds = std::stod(args[i + 1]);
+                if (!(options.limits.seconds >= 0))
+                {
+                    throw std::invalid_argument(
+                            "--timeout must not be negative");
+                }
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument("Missing argument for --timeout");
+            }
+        }
         else if (!functionSet && args[i][0] != '-')
         {
             options.function = args[i];
@@ -102,6 +338,80 @@ Options parseArguments(const std::vector<std::string>& args) {
         throw std::invalid_argument("Function argument is required.");
     }
 
+    // Bad values fail here rather than partway through a mode
+    if (options.range != "")
+    {
+        try
+        {
+            Tabulator::parseRange(options.range);
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw std::invalid_argument(e.what());
+        }
+    }
+    if (options.roots != "")
+    {
+        auto bounds = parseInterval("--roots", options.roots);
+        if (!(bounds.first < bounds.second))
+        {
+            throw std::invalid_argument("--roots needs lo < hi");
+        }
+    }
+    if (options.integrate != "")
+    {
+        parseInterval("--integrate", options.integrate);
+    }
+
+    // run() handles one mode, any other would be silently ignored
+    int modes = (options.range != "") + (options.roots != "") +
+                (options.integrate != "") + (options.taylorOrder >= 0) +
+                options.ssa + options.codegen;
+    if (modes > 1)
+    {
+        throw std::invalid_argument("--range, --roots, --integrate, "
+                        "--taylor, --ssa and --codegen cannot be combined");
+    }
+
+    // Only the modes that evaluate can use the values, the others would
+    // silently print a result that ignores them
+    bool evaluates = options.approximateValue != DBL_MAX ||
+                        options.range != "" || options.roots != "" ||
+                        options.integrate != "";
+    if (options.bind != "" && (!evaluates || options.codegen ||
+                                options.ssa || options.taylorOrder >= 0))
+    {
+        throw std::invalid_argument("--bind needs --approximate, --range, "
+                        "--roots or --integrate, without --codegen, --ssa "
+                        "or --taylor");
+    }
+    // Only plain derivative and --codegen output is cached
+    if (options.cache != "" && (evaluates || options.test != "" ||
+                                options.ssa || options.taylorOrder >= 0))
+    {
+        throw std::invalid_argument("--cache only works for the derivative "
+                        "or --codegen, without --approximate, --test, "
+                        "--range, --roots, --integrate, --ssa or --taylor");
+    }
+    // A hit never differentiates, so the limits could not reject it
+    if (options.cache != "" && (options.limits.maxNodes > 0 ||
+                options.limits.maxDepth > 0 || options.limits.seconds > 0))
+    {
+        throw std::invalid_argument("--cache cannot be combined with "
+                        "--max-nodes, --max-depth or --timeout");
+    }
+    if (options.bind != "")
+    {
+        try
+        {
+            Bindings::parse(options.bind);
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw std::invalid_argument(e.what());
+        }
+    }
+
     return options;
 }
 
@@ -125,74 +435,207 @@ std::shared_ptr<ExpressionNode> getTree(std::string input)
     auto postfix = converter.getPostfix();
     return ExpressionNode::buildTree(postfix);
 }
-int main(int argc, char const* argv[])
+// Runs the mode the options select and returns the exit status
+int run(const Options& options)
 {
+    std::string input = options.function;
+    std::string wrt = options.variable;
+    std::string test_expr = options.test;
+    double value = options.approximateValue;
+    // Every variable but wrt needs a value, none defaults to 1.0
+    Bindings bindings = options.bind != "" ? Bindings::parse(options.bind) :
+                                                                Bindings();
 
+    
+    if (options.taylorOrder >= 0)
+    {
+        Taylor taylor(input, wrt);
+        Logger taylorLog(false);
+        taylorLog.setInput(input);
+        taylorLog.setMode("Taylor");
+        taylorLog.setOutput(taylor.polynomial(options.taylorPoint,
+                                                    options.taylorOrder));
+        std::cout << taylorLog.out() << "\n";
+        return 0;
+    }
 
-    // Set it to false
-    Arithmetic::floatSimplification = false;
-
-
-    //std::string input = "ln(exp(x)-2*(2*x+3)/(5*x^2+x+4))";
+    // Differentiated as a program, never as an expanded tree
+    if (options.ssa)
+    {
+        auto var = std::make_shared<Variable>(wrt);
+        auto root = getTree(input);
+        TreeFixer::checkTree(root);
+        root = TreeFixer::simplify(root);
+        Program program = EvalOptimizer::compile(root, var);
+        program.addOutput(EvalOptimizer::differentiate(program,
+                                                program.getOutput(), var));
+        std::cout << CodeConverter::convertToSSA(program, {"f", "df"});
+        return 0;
+    }
 
+    // parseArguments leaves --cache only on plain derivative and codegen
+    // output, a hit skips tokenizing and differentiating
+    std::unique_ptr<DerivativeCache> cache;
+    std::string cacheKey;
+    if (options.cache != "")
+    {
+        cache = std::make_unique<DerivativeCache>(options.cache);
+        cacheKey = DerivativeCache::key(input, wrt,
+                                    options.codegen ? "codegen" : "log");
+        DerivativeCache::Entry entry;
+        if (cache->find(cacheKey, entry))
+        {
+            std::cout << entry.output;
+            return 0;
+        }
+    }
 
-    std::vector<std::string> args(argv, argv + argc);
-    Options options;
+    Logger log(false);
+    auto derivative = getDerivative(log, input, wrt);
 
-    try
+    if (options.codegen)
     {
-        options = parseArguments(args);
+        FlatTree tree(derivative);
+        auto var = std::make_shared<Variable>(wrt);
+        std::string code = CodeConverter::convertToC(tree,
+                                CodeConverter::getVariables(tree, var));
+        if (cache)
+        {
+            cache->insert(cacheKey, code, tree);
+        }
+        std::cout << code;
+        return 0;
+    }
 
+    if (options.range != "")
+    {
+        auto var = std::make_shared<Variable>(wrt);
+        auto root = getTree(input);
+        TreeFixer::checkTree(root);
+        root = TreeFixer::simplify(root);
+        Tabulator table(FlatTree(root), FlatTree(derivative), var);
+        table.bind(bindings);
+        auto format = options.csv ? Tabulator::Format::CSV :
+                                    Tabulator::Format::BINARY;
+        auto range = Tabulator::parseRange(options.range);
+        if (options.output == "")
+        {
+            table.write(std::cout, range, format);
+        }
+        else
+        {
+            std::ofstream file(options.output, std::ios::binary);
+            if (!file)
+            {
+                std::cerr << "Error: cannot open " << options.output << "\n";
+                return 1;
+            }
+            table.write(file, range, format);
+        }
+        return 0;
     }
-    catch (const std::invalid_argument& e)
+
+    if (options.roots != "")
     {
-        std::cerr << "Error: " << e.what() << "\n";
-        return 1;
+        auto bounds = parseInterval("--roots", options.roots);
+        auto method = options.halley ? RootFinder::Method::HALLEY :
+                                        RootFinder::Method::NEWTON;
+        RootFinder finder(input, wrt, method);
+        finder.bind(bindings);
+        for (const auto& root : finder.solve(bounds.first,
+                                                            bounds.second))
+        {
+            std::cout << root.value << "\tresidual " << root.residual
+                        << "\titerations " << root.iterations << "\n";
+        }
+        return 0;
     }
-    std::string input = options.function;
-    std::string wrt = options.variable;
-    std::string test_expr = options.test;
-    double value = options.approximateValue;
 
-    
-    Logger log(false);
-    auto derivative = getDerivative(log, input, wrt);
+    if (options.integrate != "")
+    {
+        auto bounds = parseInterval("--integrate", options.integrate);
+        Integrator integrator(input, wrt);
+        integrator.bind(bindings);
+        auto result = integrator.integrate(bounds.first, bounds.second,
+                                                        options.tolerance);
+        std::cout.precision(17);
+        std::cout << result.value << "\terror " << result.error
+                    << "\tevaluations " << result.evaluations
+                    << (result.converged ? "" : "\tnot converged")
+                    << (result.singular ? "\tsingular" : "") << "\n";
+        return 0;
+    }
 
     Approx approximator(input, wrt, value);
 
     if (value != DBL_MAX)
     {
-        auto var = std::make_shared<Variable>(wrt);
-        double outValue = Approx::approximate(derivative, var, value);
+        bindings.set(wrt, value);
+        double outValue = Approx::approximate(FlatTree(derivative), bindings);
         log.logApprox(value,outValue);
     }
     if (test_expr != "")
     {
-        
-        auto var = std::make_shared<Variable>(wrt);
         auto testTree = getTree(test_expr);
-        std::vector<double> values = {10,59, 1.1, 2958.0};
-        bool same = true;
-        for (const auto& value : values)
-        {
-            double expected = Approx::approximate(derivative, var, value);
-            double actual = Approx::approximate(testTree, var, value);
-
-            std::cout << value << ":\t" << expected << "\t" << actual << "\n";
-            if (expected != actual)
-            {
-                same = false;
-                
-            }
-        }
-        
-        
+        TreeFixer::checkTree(testTree);
+        bool same = Equivalence::equivalent(derivative, testTree);
         log.logTest(test_expr,same);
     }
     
-    std::cout << log.out() << "\n";
+    std::string out = log.out() + "\n";
+    if (cache)
+    {
+        cache->insert(cacheKey, out, FlatTree(derivative));
+    }
+    std::cout << out;
     //std::cout << values.first << "\t" << values.second << "\n";
 
 
     return 0;
 }
+
+int main(int argc, char const* argv[])
+{
+
+
+    // Set it to false
+    Arithmetic::floatSimplification = false;
+
+
+    //std::string input = "ln(exp(x)-2*(2*x+3)/(5*x^2+x+4))";
+
+
+    std::vector<std::string> args(argv, argv + argc);
+    Options options;
+
+    try
+    {
+        options = parseArguments(args);
+
+    }
+    catch (const std::exception& e)
+    {
+        // std::stod reports out of range numbers as std::out_of_range
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // Every mode runs under the limits, not only differentiation
+    LimitGuard guard(options.limits);
+    LimitGuard::Scope scope(&guard);
+    try
+    {
+        return run(options);
+    }
+    catch (const LimitExceeded& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        // Parse errors, unbound variables, unwritable files
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
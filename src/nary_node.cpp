@@ -0,0 +1,915 @@
+#include "nary_node.hpp"
+#include "token_pool.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+NaryNode::NaryNode(Kind kind, std::shared_ptr<Token> token, double value,
+                                            std::vector<naryPtr> operands)
+    : kind(kind), token(token), value(value), operands(std::move(operands))
+{
+    // Operands are hashed already, so building a node costs O(operands)
+    this->hash = std::hash<int>()(static_cast<int>(kind));
+    auto combine = [this](std::size_t value) {
+        this->hash ^= value + 0x9e3779b97f4a7c15ULL + (this->hash << 6) +
+                                                        (this->hash >> 2);
+    };
+    if (kind == Kind::NUMBER)
+    {
+        combine(std::hash<double>()(value));
+    }
+    else if (kind == Kind::VARIABLE)
+    {
+        combine(std::hash<std::string>()(token->getFullStr()));
+    }
+    else if (kind == Kind::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        combine(std::hash<std::string>()(func->getStr()));
+        if (func->getSubscript())
+        {
+            combine(std::hash<std::string>()(
+                                    func->getSubscript()->getFullStr()));
+        }
+    }
+    for (const auto& operand : this->operands)
+    {
+        combine(operand->hash);
+    }
+}
+
+NaryNode::naryPtr NaryNode::make(Kind kind, std::shared_ptr<Token> token,
+                                            std::vector<naryPtr> operands)
+{
+    return naryPtr(new NaryNode(kind, token, 0.0, std::move(operands)));
+}
+
+NaryNode::naryPtr NaryNode::number(double value)
+{
+    // Number keeps the magnitude and a sign flag
+    value = value == 0.0 ? 0.0 : value;
+    if (std::floor(value) == value && value >= TokenPool::MIN_INTEGER &&
+                                        value <= TokenPool::MAX_INTEGER)
+    {
+        return naryPtr(new NaryNode(Kind::NUMBER,
+                TokenPool::number(static_cast<int>(value)), value, {}));
+    }
+    double magnitude = std::fabs(value);
+    char buffer[32];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), magnitude).ptr;
+    std::string str(buffer, end);
+    std::shared_ptr<Number> num;
+    if (std::floor(magnitude) == magnitude && magnitude < 1e9)
+    {
+        num = std::make_shared<Number>(str, static_cast<int>(magnitude));
+    }
+    else
+    {
+        num = std::make_shared<Number>(str, magnitude);
+    }
+    if (value < 0)
+    {
+        num->flipSign();
+    }
+    return naryPtr(new NaryNode(Kind::NUMBER, num, value, {}));
+}
+
+NaryNode::naryPtr NaryNode::variable(const std::shared_ptr<Variable>& var)
+{
+    auto copy = std::make_shared<Variable>(var->getStr());
+    copy->setSubscript(var->getSubscript());
+    return make(Kind::VARIABLE, copy, {});
+}
+
+NaryNode::naryPtr NaryNode::function(const std::string& name,
+                        naryPtr argument, std::shared_ptr<Number> subscript)
+{
+    auto func = std::make_shared<Function>(name);
+    if (subscript)
+    {
+        func->setSubscript(subscript);
+    }
+    return make(Kind::FUNCTION, func, {argument});
+}
+
+void NaryNode::sort(std::vector<naryPtr>& operands)
+{
+    // Numbers first, the rest in hash order
+    std::sort(operands.begin(), operands.end(),
+                            [](const naryPtr& first, const naryPtr& second) {
+        bool firstNumber = first->isNumber();
+        bool secondNumber = second->isNumber();
+        if (firstNumber != secondNumber)
+        {
+            return firstNumber;
+        }
+        return first->hash < second->hash;
+    });
+}
+
+double NaryNode::coefficient(const naryPtr& term, naryPtr& rest)
+{
+    if (!term->isProduct() || !term->operands[0]->isNumber())
+    {
+        rest = term;
+        return 1.0;
+    }
+    if (term->operands.size() == 2)
+    {
+        rest = term->operands[1];
+    }
+    else
+    {
+        // Still sorted and collected, no need to go through product()
+        rest = make(Kind::PRODUCT, term->token, std::vector<naryPtr>(
+                            term->operands.begin() + 1, term->operands.end()));
+    }
+    return term->operands[0]->value;
+}
+
+NaryNode::naryPtr NaryNode::negate(const naryPtr& node)
+{
+    return product({number(-1.0), node});
+}
+
+NaryNode::naryPtr NaryNode::sum(std::vector<naryPtr> operands)
+{
+    std::vector<naryPtr> terms;
+    for (const auto& operand : operands)
+    {
+        if (operand->isSum())
+        {
+            terms.insert(terms.end(), operand->operands.begin(),
+                                                    operand->operands.end());
+        }
+        else
+        {
+            terms.push_back(operand);
+        }
+    }
+
+    // Collect like terms: c1*t + c2*t is (c1 + c2)*t
+    double constant = 0.0;
+    std::vector<naryPtr> rests;
+    std::vector<double> coefficients;
+    std::unordered_map<std::size_t, std::vector<int>> index;
+    for (const auto& term : terms)
+    {
+        if (term->isNumber())
+        {
+            constant += term->value;
+            continue;
+        }
+        naryPtr rest;
+        double scale = coefficient(term, rest);
+        bool found = false;
+        for (int idx : index[rest->hash])
+        {
+            if (rests[idx]->equals(*rest))
+            {
+                coefficients[idx] += scale;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+        {
+            index[rest->hash].push_back(rests.size());
+            rests.push_back(rest);
+            coefficients.push_back(scale);
+        }
+    }
+
+    std::vector<naryPtr> out;
+    for (int idx = 0; idx < rests.size(); idx++)
+    {
+        if (coefficients[idx] == 1.0)
+        {
+            out.push_back(rests[idx]);
+        }
+        else if (coefficients[idx] != 0.0)
+        {
+            out.push_back(product({number(coefficients[idx]), rests[idx]}));
+        }
+    }
+    if (constant != 0.0 || out.empty())
+    {
+        out.push_back(number(constant));
+    }
+    if (out.size() == 1)
+    {
+        return out[0];
+    }
+    sort(out);
+    return make(Kind::SUM, TokenPool::op("+"), std::move(out));
+}
+
+NaryNode::naryPtr NaryNode::product(std::vector<naryPtr> operands)
+{
+    std::vector<naryPtr> factors;
+    for (const auto& operand : operands)
+    {
+        if (operand->isProduct())
+        {
+            factors.insert(factors.end(), operand->operands.begin(),
+                                                    operand->operands.end());
+        }
+        else
+        {
+            factors.push_back(operand);
+        }
+    }
+
+    // Collect like factors: b^e1 * b^e2 is b^(e1 + e2)
+    double scale = 1.0;
+    std::vector<naryPtr> bases;
+    std::vector<std::vector<naryPtr>> exponents;
+    std::unordered_map<std::size_t, std::vector<int>> index;
+    for (const auto& factor : factors)
+    {
+        if (factor->isNumber())
+        {
+            scale *= factor->value;
+            continue;
+        }
+        naryPtr base = factor->isPower() ? factor->operands[0] : factor;
+        naryPtr exponent = factor->isPower() ? factor->operands[1] :
+                                                                number(1.0);
+        bool found = false;
+        for (int idx : index[base->hash])
+        {
+            if (bases[idx]->equals(*base))
+            {
+                exponents[idx].push_back(exponent);
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+        {
+            index[base->hash].push_back(bases.size());
+            bases.push_back(base);
+            exponents.push_back({exponent});
+        }
+    }
+    if (scale == 0.0)
+    {
+        return number(0.0);
+    }
+
+    std::vector<naryPtr> out;
+    for (int idx = 0; idx < bases.size(); idx++)
+    {
+        naryPtr factor = exponents[idx].size() == 1 ?
+                power(bases[idx], exponents[idx][0]) :
+                power(bases[idx], sum(exponents[idx]));
+        if (factor->isNumber())
+        {
+            scale *= factor->value;
+        }
+        else if (factor->isProduct())
+        {
+            // A distributed power, (x*y)^2 is x^2*y^2
+            for (const auto& inner : factor->operands)
+            {
+                if (inner->isNumber())
+                {
+                    scale *= inner->value;
+                }
+                else
+                {
+                    out.push_back(inner);
+                }
+            }
+        }
+        else
+        {
+            out.push_back(factor);
+        }
+    }
+    if (scale == 0.0)
+    {
+        return number(0.0);
+    }
+    if (scale != 1.0 || out.empty())
+    {
+        out.push_back(number(scale));
+    }
+    if (out.size() == 1)
+    {
+        return out[0];
+    }
+    sort(out);
+    return make(Kind::PRODUCT, TokenPool::op("*"),
+                                                            std::move(out));
+}
+
+NaryNode::naryPtr NaryNode::power(naryPtr base, naryPtr exponent)
+{
+    if (exponent->isNumber())
+    {
+        double exp = exponent->value;
+        bool integer = std::floor(exp) == exp && std::fabs(exp) <= 64;
+        if (exp == 0.0)
+        {
+            return number(1.0);
+        }
+        if (exp == 1.0)
+        {
+            return base;
+        }
+        if (base->isNumber() && integer && exp > 0)
+        {
+            return number(std::pow(base->value, exp));
+        }
+        // (b^m)^n is b^(m n) for whole m and n
+        if (base->isPower() && integer && base->operands[1]->isNumber())
+        {
+            double inner = base->operands[1]->value;
+            if (std::floor(inner) == inner)
+            {
+                return power(base->operands[0], number(inner * exp));
+            }
+        }
+        if (base->isProduct() && integer)
+        {
+            std::vector<naryPtr> factors;
+            for (const auto& factor : base->operands)
+            {
+                factors.push_back(power(factor, exponent));
+            }
+            return product(factors);
+        }
+    }
+    else if (base->isNumber() && base->value == 1.0)
+    {
+        return base;
+    }
+    return make(Kind::POWER, TokenPool::op("^"),
+                                                        {base, exponent});
+}
+
+NaryNode::naryPtr NaryNode::build(nodePtr root)
+{
+    if (!root)
+    {
+        throw std::runtime_error("Cannot convert an empty subtree");
+    }
+    auto token = root->getToken();
+    naryPtr out;
+    if (root->getType() == TokenType::NUMBER)
+    {
+        auto num = std::dynamic_pointer_cast<Number>(token);
+        return number(num->isInt() ? num->getInt() * 1.0 : num->getDouble());
+    }
+    else if (root->getType() == TokenType::VARIABLE)
+    {
+        out = variable(std::dynamic_pointer_cast<Variable>(token));
+    }
+    else if (root->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        out = function(func->getStr(), build(func->getSubExprTree()),
+                                                    func->getSubscript());
+    }
+    else if (root->getType() == TokenType::OPERATOR)
+    {
+        std::string op = root->getStr();
+        std::vector<naryPtr> operands;
+        if (op == "+" || op == "-")
+        {
+            // Gather the whole chain first, collecting terms once
+            collect(root->getLeft(), true, false, operands);
+            collect(root->getRight(), true, op == "-", operands);
+            out = sum(operands);
+        }
+        else if (op == "*" || op == "/")
+        {
+            collect(root->getLeft(), false, false, operands);
+            collect(root->getRight(), false, op == "/", operands);
+            out = product(operands);
+        }
+        else if (op == "^")
+        {
+            out = power(build(root->getLeft()), build(root->getRight()));
+        }
+        else
+        {
+            throw std::runtime_error("Cannot convert operator " + op);
+        }
+    }
+    else
+    {
+        throw std::runtime_error("Cannot convert token " + root->getStr());
+    }
+    return token->isNegative() ? negate(out) : out;
+}
+
+void NaryNode::collect(nodePtr node, bool additive, bool inverted,
+                                            std::vector<naryPtr>& operands)
+{
+    std::string op = node->getStr();
+    bool chained = node->getType() == TokenType::OPERATOR &&
+                    !node->getToken()->isNegative() && (additive ?
+                    op == "+" || op == "-" : op == "*" || op == "/");
+    if (chained)
+    {
+        bool flip = op == "-" || op == "/";
+        collect(node->getLeft(), additive, inverted, operands);
+        collect(node->getRight(), additive, inverted != flip, operands);
+        return;
+    }
+    naryPtr operand = build(node);
+    if (inverted)
+    {
+        operand = additive ? negate(operand) :
+                                        power(operand, number(-1.0));
+    }
+    operands.push_back(operand);
+}
+
+NaryNode::naryPtr NaryNode::differentiate(
+                                const std::shared_ptr<Variable>& var) const
+{
+    if (!this->hasVariable(var))
+    {
+        return number(0.0);
+    }
+    if (this->isVariable())
+    {
+        return number(1.0);
+    }
+    if (this->isSum())
+    {
+        std::vector<naryPtr> terms;
+        for (const auto& operand : this->operands)
+        {
+            terms.push_back(operand->differentiate(var));
+        }
+        return sum(terms);
+    }
+    if (this->isProduct())
+    {
+        // (f1 ... fk)' is the sum of P(i-1) fi' S(i+1), where the prefix
+        // products P and the suffix products S are built once and shared,
+        // so the derivative has O(k) new nodes. They are held nested as
+        // they are, product() would copy k factors into each of them
+        const std::vector<naryPtr>& factors = this->operands;
+        std::size_t count = factors.size();
+        std::vector<naryPtr> prefix(count);
+        std::vector<naryPtr> suffix(count);
+        prefix[0] = factors[0];
+        suffix[count - 1] = factors[count - 1];
+        for (std::size_t idx = 1; idx < count; idx++)
+        {
+            prefix[idx] = make(Kind::PRODUCT, TokenPool::op("*"),
+                                            {prefix[idx - 1], factors[idx]});
+            suffix[count - 1 - idx] = make(Kind::PRODUCT, TokenPool::op("*"),
+                            {factors[count - 1 - idx], suffix[count - idx]});
+        }
+        std::vector<naryPtr> terms;
+        for (std::size_t idx = 0; idx < count; idx++)
+        {
+            if (!factors[idx]->hasVariable(var))
+            {
+                continue;
+            }
+            std::vector<naryPtr> term;
+            if (idx > 0)
+            {
+                term.push_back(prefix[idx - 1]);
+            }
+            naryPtr derivative = factors[idx]->differentiate(var);
+            if (!derivative->isNumber() || derivative->value != 1.0)
+            {
+                term.push_back(derivative);
+            }
+            if (idx + 1 < count)
+            {
+                term.push_back(suffix[idx + 1]);
+            }
+            terms.push_back(term.size() == 1 ? term[0] :
+                        make(Kind::PRODUCT, TokenPool::op("*"), term));
+        }
+        return sum(terms);
+    }
+    if (this->isPower())
+    {
+        const naryPtr& base = this->operands[0];
+        const naryPtr& exponent = this->operands[1];
+        if (!exponent->hasVariable(var))
+        {
+            return product({exponent,
+                    power(base, sum({exponent, number(-1.0)})),
+                    base->differentiate(var)});
+        }
+        // (b^e)' = b^e (e' ln(b) + e b' / b)
+        return product({shared_from_this(), sum({
+            product({exponent->differentiate(var), function("ln", base)}),
+            product({exponent, base->differentiate(var),
+                                            power(base, number(-1.0))})})});
+    }
+    return this->chainRule(var);
+}
+
+NaryNode::naryPtr NaryNode::chainRule(
+                                const std::shared_ptr<Variable>& var) const
+{
+    const naryPtr& arg = this->operands[0];
+    std::string name = this->token->getStr();
+    naryPtr outer;
+    if (name == "sin")
+    {
+        outer = function("cos", arg);
+    }
+    else if (name == "cos")
+    {
+        outer = negate(function("sin", arg));
+    }
+    else if (name == "tan")
+    {
+        outer = power(function("sec", arg), number(2.0));
+    }
+    else if (name == "cot")
+    {
+        outer = negate(power(function("csc", arg), number(2.0)));
+    }
+    else if (name == "sec")
+    {
+        outer = product({shared_from_this(), function("tan", arg)});
+    }
+    else if (name == "csc")
+    {
+        outer = negate(product({shared_from_this(), function("cot", arg)}));
+    }
+    else if (name == "exp")
+    {
+        outer = shared_from_this();
+    }
+    else if (name == "ln")
+    {
+        outer = power(arg, number(-1.0));
+    }
+    else if (name == "log")
+    {
+        auto func = std::dynamic_pointer_cast<Function>(this->token);
+        double base = 10.0;
+        if (func->getSubscript())
+        {
+            auto subscript = func->getSubscript();
+            base = subscript->isInt() ? subscript->getInt() * 1.0 :
+                                        subscript->getDouble();
+        }
+        outer = power(product({arg, function("ln", number(base))}),
+                                                            number(-1.0));
+    }
+    else if (name == "sqrt")
+    {
+        outer = product({number(0.5), power(shared_from_this(),
+                                                        number(-1.0))});
+    }
+    else
+    {
+        throw std::runtime_error("Cannot differentiate function " + name);
+    }
+    return product({outer, arg->differentiate(var)});
+}
+
+NaryNode::nodePtr NaryNode::balanced(const std::vector<nodePtr>& nodes,
+                                    std::size_t begin, std::size_t end,
+                                    const std::string& op)
+{
+    if (end - begin == 1)
+    {
+        return nodes[begin];
+    }
+    std::size_t middle = begin + (end - begin) / 2;
+    auto out = std::make_shared<ExpressionNode>(
+                                            TokenPool::op(op));
+    out->setLeft(balanced(nodes, begin, middle, op));
+    out->setRight(balanced(nodes, middle, end, op));
+    return out;
+}
+
+void NaryNode::fraction(std::vector<naryPtr>& numerator,
+                                    std::vector<naryPtr>& denominator) const
+{
+    for (const auto& factor : this->operands)
+    {
+        if (factor->isPower() && factor->operands[1]->isNumber() &&
+                                        factor->operands[1]->value < 0)
+        {
+            denominator.push_back(power(factor->operands[0],
+                                    number(-factor->operands[1]->value)));
+        }
+        else
+        {
+            numerator.push_back(factor);
+        }
+    }
+}
+
+NaryNode::nodePtr NaryNode::toBinary() const
+{
+    if (this->isNumber() || this->isVariable())
+    {
+        return std::make_shared<ExpressionNode>(this->token->clone());
+    }
+    if (this->isFunction())
+    {
+        auto original = std::dynamic_pointer_cast<Function>(this->token);
+        auto func = std::make_shared<Function>(original->getStr());
+        if (original->getSubscript())
+        {
+            func->setSubscript(original->getSubscript());
+        }
+        func->setSubExprTree(this->operands[0]->toBinary());
+        return std::make_shared<ExpressionNode>(func);
+    }
+    if (this->isPower())
+    {
+        bool reciprocal = this->operands[1]->isNumber() &&
+                                            this->operands[1]->value < 0;
+        auto out = std::make_shared<ExpressionNode>(
+                        TokenPool::op(reciprocal ? "/" : "^"));
+        if (reciprocal)
+        {
+            out->setLeft(number(1.0)->toBinary());
+            out->setRight(power(this->operands[0],
+                        number(-this->operands[1]->value))->toBinary());
+        }
+        else
+        {
+            out->setLeft(this->operands[0]->toBinary());
+            out->setRight(this->operands[1]->toBinary());
+        }
+        return out;
+    }
+    if (this->isSum())
+    {
+        std::vector<nodePtr> positive;
+        std::vector<nodePtr> negative;
+        for (const auto& term : this->operands)
+        {
+            naryPtr rest;
+            double scale = term->isNumber() ? term->value :
+                                                coefficient(term, rest);
+            if (scale < 0)
+            {
+                negative.push_back(negate(term)->toBinary());
+            }
+            else
+            {
+                positive.push_back(term->toBinary());
+            }
+        }
+        if (negative.empty())
+        {
+            return balanced(positive, 0, positive.size(), "+");
+        }
+        auto subtracted = balanced(negative, 0, negative.size(), "+");
+        auto out = std::make_shared<ExpressionNode>(
+                    TokenPool::op(positive.empty() ? "*" : "-"));
+        out->setLeft(positive.empty() ? number(-1.0)->toBinary() :
+                                balanced(positive, 0, positive.size(), "+"));
+        out->setRight(subtracted);
+        return out;
+    }
+
+    std::vector<naryPtr> numerator;
+    std::vector<naryPtr> denominator;
+    this->fraction(numerator, denominator);
+    std::vector<nodePtr> top;
+    std::vector<nodePtr> bottom;
+    for (const auto& factor : numerator)
+    {
+        top.push_back(factor->toBinary());
+    }
+    for (const auto& factor : denominator)
+    {
+        bottom.push_back(factor->toBinary());
+    }
+    if (top.empty())
+    {
+        top.push_back(number(1.0)->toBinary());
+    }
+    auto out = balanced(top, 0, top.size(), "*");
+    if (bottom.empty())
+    {
+        return out;
+    }
+    auto quotient = std::make_shared<ExpressionNode>(
+                                            TokenPool::op("/"));
+    quotient->setLeft(out);
+    quotient->setRight(balanced(bottom, 0, bottom.size(), "*"));
+    return quotient;
+}
+
+std::string NaryNode::parenthesized() const
+{
+    bool symbol = this->isVariable() || this->isFunction() ||
+                                    (this->isNumber() && this->value >= 0);
+    return symbol ? this->toString() : "(" + this->toString() + ")";
+}
+
+std::string NaryNode::toString() const
+{
+    if (this->isNumber() || this->isVariable())
+    {
+        return this->token->getFullStr();
+    }
+    if (this->isFunction())
+    {
+        auto func = std::dynamic_pointer_cast<Function>(this->token);
+        std::string name = func->getStr();
+        if (func->getSubscript())
+        {
+            name += "_" + func->getSubscript()->getFullStr();
+        }
+        return name + "(" + this->operands[0]->toString() + ")";
+    }
+    if (this->isPower())
+    {
+        return this->operands[0]->parenthesized() + "^" +
+                                    this->operands[1]->parenthesized();
+    }
+    if (this->isSum())
+    {
+        std::string out = this->operands[0]->toString();
+        for (int idx = 1; idx < this->operands.size(); idx++)
+        {
+            const naryPtr& term = this->operands[idx];
+            naryPtr rest;
+            double scale = term->isNumber() ? term->value :
+                                                coefficient(term, rest);
+            out += scale < 0 ? " - " + negate(term)->toString() :
+                                " + " + term->toString();
+        }
+        return out;
+    }
+
+    std::vector<naryPtr> numerator;
+    std::vector<naryPtr> denominator;
+    this->fraction(numerator, denominator);
+    std::string out;
+    for (const auto& factor : numerator)
+    {
+        if (out == "" && factor->isNumber() && factor->value == -1.0 &&
+                                                    numerator.size() > 1)
+        {
+            out = "-";
+            continue;
+        }
+        if (out != "" && out != "-")
+        {
+            out += "*";
+        }
+        out += factor->isSum() ? "(" + factor->toString() + ")" :
+                                                    factor->toString();
+    }
+    if (out == "")
+    {
+        out = "1";
+    }
+    if (denominator.empty())
+    {
+        return out;
+    }
+    std::string below;
+    for (const auto& factor : denominator)
+    {
+        below += (below == "" ? "" : "*") + (factor->isSum() ?
+                        "(" + factor->toString() + ")" : factor->toString());
+    }
+    bool single = denominator.size() == 1 && !denominator[0]->isSum();
+    return out + "/" + (single ? below : "(" + below + ")");
+}
+
+bool NaryNode::isNumber() const
+{
+    return this->kind == Kind::NUMBER;
+}
+
+bool NaryNode::isVariable() const
+{
+    return this->kind == Kind::VARIABLE;
+}
+
+bool NaryNode::isFunction() const
+{
+    return this->kind == Kind::FUNCTION;
+}
+
+bool NaryNode::isSum() const
+{
+    return this->kind == Kind::SUM;
+}
+
+bool NaryNode::isProduct() const
+{
+    return this->kind == Kind::PRODUCT;
+}
+
+bool NaryNode::isPower() const
+{
+    return this->kind == Kind::POWER;
+}
+
+double NaryNode::getValue() const
+{
+    return this->value;
+}
+
+std::shared_ptr<Token> NaryNode::getToken() const
+{
+    return this->token;
+}
+
+const std::vector<NaryNode::naryPtr>& NaryNode::getOperands() const
+{
+    return this->operands;
+}
+
+std::size_t NaryNode::getHash() const
+{
+    return this->hash;
+}
+
+bool NaryNode::hasVariable(const std::shared_ptr<Variable>& var) const
+{
+    if (this->isVariable())
+    {
+        return std::dynamic_pointer_cast<Variable>(this->token)->equals(var);
+    }
+    for (const auto& operand : this->operands)
+    {
+        if (operand->hasVariable(var))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NaryNode::equals(const NaryNode& other) const
+{
+    if (this == &other)
+    {
+        return true;
+    }
+    if (this->kind != other.kind || this->hash != other.hash ||
+                        this->operands.size() != other.operands.size())
+    {
+        return false;
+    }
+    if (this->isNumber())
+    {
+        return this->value == other.value;
+    }
+    if (this->token->getFullStr() != other.token->getFullStr())
+    {
+        return false;
+    }
+    if (this->isFunction())
+    {
+        auto first = std::dynamic_pointer_cast<Function>(this->token);
+        auto second = std::dynamic_pointer_cast<Function>(other.token);
+        if (!first->getSubscript() != !second->getSubscript() ||
+                (first->getSubscript() && first->getSubscript()->getFullStr()
+                                    != second->getSubscript()->getFullStr()))
+        {
+            return false;
+        }
+    }
+    for (int idx = 0; idx < this->operands.size(); idx++)
+    {
+        if (!this->operands[idx]->equals(*other.operands[idx]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int NaryNode::depth() const
+{
+    int deepest = 0;
+    for (const auto& operand : this->operands)
+    {
+        deepest = std::max(deepest, operand->depth());
+    }
+    return deepest + 1;
+}
+
+std::size_t NaryNode::size() const
+{
+    std::size_t out = 1;
+    for (const auto& operand : this->operands)
+    {
+        out += operand->size();
+    }
+    return out;
+}
@@ -0,0 +1,135 @@
+#ifndef __NARY_NODE_HPP__
+#define __NARY_NODE_HPP__
+
+#include "expression_node.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Immutable expression node with n-ary sums and products.
+ *
+ * @details A chain of binary + (or *) nodes becomes a single node holding
+ * all of its operands, sorted into a canonical order. The factories keep
+ * every node canonical as it is built: nested sums and products are
+ * flattened, numbers are folded, like terms are collected (2*x + x is
+ * 3*x) and repeated factors become powers (x*x is x^2). Subtraction is a
+ * sum with a -1 coefficient and division a product with a -1 power, so
+ * the only node kinds are numbers, variables, functions, sums, products
+ * and powers.
+ *
+ * Nodes never change once built, so sub-trees are shared freely. The
+ * product rule builds each prefix and suffix product of the factors once
+ * and shares them between its terms, so the derivative of k factors has
+ * O(k) new nodes; those partial products are held as nested products,
+ * canonical in everything but the nesting. toBinary converts back to a
+ * balanced ExpressionNode tree for the existing converters and
+ * evaluators, with depth logarithmic in the number of operands instead
+ * of linear.
+ *
+ * Derivative and TreeFixer keep binary, order-preserving trees: there
+ * TreeFixer::simplify collects like terms within a chain and balances
+ * long ones, and the binary product rule over a balanced product is the
+ * divide and conquer form of the rule above.
+ */
+class NaryNode : public std::enable_shared_from_this<NaryNode>
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+public:
+    typedef std::shared_ptr<const NaryNode> naryPtr;
+
+    /**
+     * @brief Converts a binary tree, which must be complete as after
+     * TreeFixer::checkTree.
+     */
+    static naryPtr build(nodePtr root);
+
+    static naryPtr number(double value);
+    static naryPtr variable(const std::shared_ptr<Variable>& var);
+    static naryPtr function(const std::string& name, naryPtr argument,
+                                std::shared_ptr<Number> subscript = nullptr);
+    static naryPtr sum(std::vector<naryPtr> operands);
+    static naryPtr product(std::vector<naryPtr> operands);
+    static naryPtr power(naryPtr base, naryPtr exponent);
+
+    /**
+     * @brief Derivative with respect to var, canonical like any other node.
+     */
+    naryPtr differentiate(const std::shared_ptr<Variable>& var) const;
+
+    /**
+     * @brief Balanced binary tree: sums become a - b with every negative
+     * term on the right, products a / b with every negative power below.
+     */
+    nodePtr toBinary() const;
+
+    /**
+     * @brief Flat rendering, "3*x^2 + 2*x - 1".
+     */
+    std::string toString() const;
+
+    bool isNumber() const;
+    bool isVariable() const;
+    bool isFunction() const;
+    bool isSum() const;
+    bool isProduct() const;
+    bool isPower() const;
+
+    //! The value of a number node
+    double getValue() const;
+    std::shared_ptr<Token> getToken() const;
+    const std::vector<naryPtr>& getOperands() const;
+    std::size_t getHash() const;
+
+    bool hasVariable(const std::shared_ptr<Variable>& var) const;
+    bool equals(const NaryNode& other) const;
+
+    //! Longest path from this node to a leaf, counting both ends
+    int depth() const;
+    //! Number of nodes, counting shared sub-trees every time they appear
+    std::size_t size() const;
+
+private:
+    enum class Kind
+    {
+        NUMBER,
+        VARIABLE,
+        FUNCTION,
+        POWER,
+        PRODUCT,
+        SUM
+    };
+
+    Kind kind;
+    std::shared_ptr<Token> token;
+    double value;
+    std::vector<naryPtr> operands;
+    std::size_t hash;
+
+    NaryNode(Kind kind, std::shared_ptr<Token> token, double value,
+                                            std::vector<naryPtr> operands);
+    static naryPtr make(Kind kind, std::shared_ptr<Token> token,
+                                            std::vector<naryPtr> operands);
+    static void sort(std::vector<naryPtr>& operands);
+
+    //! Splits a term into its numeric coefficient and the rest
+    static double coefficient(const naryPtr& term, naryPtr& rest);
+    static naryPtr negate(const naryPtr& node);
+    //! Operands of a chain of + and - (or * and /) in a binary tree
+    static void collect(nodePtr node, bool additive, bool inverted,
+                                            std::vector<naryPtr>& operands);
+    naryPtr chainRule(const std::shared_ptr<Variable>& var) const;
+
+    static nodePtr balanced(const std::vector<nodePtr>& nodes,
+                            std::size_t begin, std::size_t end,
+                            const std::string& op);
+    //! toString, in parentheses unless the node is a single symbol
+    std::string parenthesized() const;
+    //! Splits a product into numerator and denominator factors
+    void fraction(std::vector<naryPtr>& numerator,
+                                    std::vector<naryPtr>& denominator) const;
+};
+
+#endif // __NARY_NODE_HPP__
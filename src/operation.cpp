@@ -1,9 +1,10 @@
 #include "operation.hpp"
 #include "token.hpp"
+#include "token_pool.hpp"
 
 std::shared_ptr<ExpressionNode> Operation::times(nodePtr left, nodePtr right)
 {
-    auto opToken = std::make_shared<Operator>("*");
+    auto opToken = TokenPool::op("*");
     auto node = std::make_shared<ExpressionNode>(opToken);
     node->setLeft(left);
     node->setRight(right);
@@ -12,7 +13,7 @@ std::shared_ptr<ExpressionNode> Operation::times(nodePtr left, nodePtr right)
 }
 std::shared_ptr<ExpressionNode> Operation::divide(nodePtr left, nodePtr right)
 {
-    auto opToken = std::make_shared<Operator>("/");
+    auto opToken = TokenPool::op("/");
     auto node = std::make_shared<ExpressionNode>(opToken);
     node->setLeft(left);
     node->setRight(right);
@@ -21,7 +22,7 @@ std::shared_ptr<ExpressionNode> Operation::divide(nodePtr left, nodePtr right)
 }
 std::shared_ptr<ExpressionNode> Operation::add(nodePtr left, nodePtr right)
 {
-    auto opToken = std::make_shared<Operator>("+");
+    auto opToken = TokenPool::op("+");
     auto node = std::make_shared<ExpressionNode>(opToken);
     node->setLeft(left);
     node->setRight(right);
@@ -31,7 +32,7 @@ std::shared_ptr<ExpressionNode> Operation::add(nodePtr left, nodePtr right)
 std::shared_ptr<ExpressionNode> Operation::subtract(nodePtr left,
                                                             nodePtr right)
 {
-    auto opToken = std::make_shared<Operator>("-");
+    auto opToken = TokenPool::op("-");
     auto node = std::make_shared<ExpressionNode>(opToken);
     node->setLeft(left);
     node->setRight(right);
@@ -41,7 +42,7 @@ std::shared_ptr<ExpressionNode> Operation::subtract(nodePtr left,
 std::shared_ptr<ExpressionNode> Operation::power(nodePtr left,
                                                             nodePtr right)
 {
-    auto opToken = std::make_shared<Operator>("^");
+    auto opToken = TokenPool::op("^");
     auto node = std::make_shared<ExpressionNode>(opToken);
     node->setLeft(left);
     node->setRight(right);
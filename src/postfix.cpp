@@ -3,21 +3,28 @@
 #include <stdexcept>
 
 
-ShuntingYard::ShuntingYard(TokenContainer input)
-{
-    this->input = TokenVector(input.getVector());
-}
+ShuntingYard::ShuntingYard(const TokenContainer& input)
+    : input(input.getVector()) {}
 
 
 
 
 TokenQueue ShuntingYard::getPostfix()
 {
-    this->convert(this->input);
-    return this->output;
+    return this->tryPostfix().orThrow();
 }
 
-void ShuntingYard::convert(TokenVector expression)
+Result<TokenQueue> ShuntingYard::tryPostfix()
+{
+    this->convert();
+    if (!this->error.empty())
+    {
+        return Error{Error::Code::SYNTAX, this->error};
+    }
+    return std::move(this->output);
+}
+
+void ShuntingYard::convert()
 {
     for (int idx = 0; idx < this->input.size(); idx++)
     {
@@ -35,9 +42,14 @@ void ShuntingYard::convert(TokenVector expression)
         {
             auto func = std::dynamic_pointer_cast<Function>(this->currentToken);
             ShuntingYard postfixInput(func->getSubExpr()->getVector());
-            auto subExpr =
-                std::make_shared<TokenQueue>(postfixInput.getPostfix());
-            func->setSubExpr(subExpr);
+            auto subPostfix = postfixInput.tryPostfix();
+            if (!subPostfix.ok())
+            {
+                this->error = subPostfix.error().message;
+                return;
+            }
+            func->setSubExpr(
+                    std::make_shared<TokenQueue>(subPostfix.value()));
 
             // Push function onto the operator stack (but treat it with high precedence)
             output.push(this->currentToken);
@@ -52,17 +64,15 @@ void ShuntingYard::convert(TokenVector expression)
         }
         else if (this->currentType() == TokenType::RIGHTPAREN)
         {
-            while (operators.top()->getType() != TokenType::LEFTPAREN)
+            while (operators.size() > 0 &&
+                        operators.top()->getType() != TokenType::LEFTPAREN)
             {
-                if (operators.size() == 0)
-                {
-                    throw std::runtime_error("Mismatched parentheses");
-                }
                 this->popToOutput();
             }
             if (operators.size() == 0)
             {
-                throw std::runtime_error("Mismatched parentheses");
+                this->error = "Mismatched parentheses";
+                return;
             }
             operators.pop(); // Pop the left parenthesis
 
@@ -79,7 +89,8 @@ void ShuntingYard::convert(TokenVector expression)
     {
         if (operators.top()->getType() == TokenType::LEFTPAREN)
         {
-            throw std::runtime_error("Mismatched parentheses");
+            this->error = "Mismatched parentheses";
+            return;
         }
         this->popToOutput();
     }
@@ -6,6 +6,7 @@
 #include "token_vector.hpp"
 #include "token_stack.hpp"
 #include "expression_node.hpp"
+#include "result.hpp"
 
 #include <vector>
 #include <stack>
@@ -17,14 +18,29 @@
 class ShuntingYard
 {
 public:
-    ShuntingYard(TokenContainer input);
+    ShuntingYard(const TokenContainer& input);
+
+    /**
+     * @brief Converts the input and hands over the result, so it is called
+     * once per converter, as is tryPostfix.
+     * @throws std::runtime_error on mismatched parentheses
+     */
     TokenQueue getPostfix();
+
+    /**
+     * @brief getPostfix() that returns a SYNTAX error instead of throwing.
+     */
+    Result<TokenQueue> tryPostfix();
 private:
     TokenVector input;
     TokenQueue output;
     TokenStack operators;
     std::shared_ptr<Token> currentToken;
-    void convert(TokenVector expression);
+
+    //! Empty unless convert failed
+    std::string error;
+
+    void convert();
     void handleOperator();
 
 
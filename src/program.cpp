@@ -0,0 +1,192 @@
+#include "program.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+int Program::size() const
+{
+    return this->opcodes.size();
+}
+
+int Program::add(OpCode code, int left, int right, double value, int symbol)
+{
+    // NaN is never equal to itself, so it cannot be a map key
+    bool shared = !std::isnan(value);
+    Key key(code, left, right, value, symbol);
+    if (shared)
+    {
+        auto found = this->entries.find(key);
+        if (found != this->entries.end())
+        {
+            return found->second;
+        }
+    }
+    int idx = this->opcodes.size();
+    this->opcodes.push_back(code);
+    this->lefts.push_back(left);
+    this->rights.push_back(right);
+    this->values.push_back(value);
+    this->symbols.push_back(symbol);
+    if (shared)
+    {
+        this->entries.emplace(key, idx);
+    }
+    return idx;
+}
+
+int Program::constant(double value)
+{
+    bool integer = std::floor(value) == value;
+    return this->add(integer ? OpCode::INTEGER : OpCode::REAL, -1, -1,
+                                                                value, -1);
+}
+
+int Program::variable(const std::shared_ptr<Variable>& var)
+{
+    int slot = this->getSlot(var);
+    if (slot == -1)
+    {
+        auto copy = std::make_shared<Variable>(var->getStr());
+        copy->setSubscript(var->getSubscript());
+        this->variables.push_back(copy);
+        slot = this->variables.size() - 1;
+    }
+    return this->add(OpCode::VARIABLE, -1, -1, 0.0, slot);
+}
+
+int Program::apply(OpCode code, int left, int right, double value)
+{
+    if (left < 0 || left >= this->size() || right >= this->size())
+    {
+        throw std::runtime_error("Program operands must already exist");
+    }
+    if (code != OpCode::LOG)
+    {
+        value = 0.0;
+    }
+    // Order the operands of commutative operations, so b*a shares a*b
+    if ((code == OpCode::ADD || code == OpCode::MULTIPLY) && right < left)
+    {
+        std::swap(left, right);
+    }
+    return this->add(code, left, right, value, -1);
+}
+
+void Program::setOutput(int idx)
+{
+    this->outputs.assign(1, idx);
+}
+
+int Program::addOutput(int idx)
+{
+    this->outputs.push_back(idx);
+    return this->outputs.size() - 1;
+}
+
+int Program::getOutput(int position) const
+{
+    return position < this->outputs.size() ? this->outputs[position] : -1;
+}
+
+int Program::getOutputCount() const
+{
+    return this->outputs.size();
+}
+
+OpCode Program::getOpCode(int idx) const
+{
+    return this->opcodes[idx];
+}
+
+int Program::getLeft(int idx) const
+{
+    return this->lefts[idx];
+}
+
+int Program::getRight(int idx) const
+{
+    return this->rights[idx];
+}
+
+double Program::getValue(int idx) const
+{
+    return this->values[idx];
+}
+
+int Program::getSymbol(int idx) const
+{
+    return this->symbols[idx];
+}
+
+int Program::count(OpCode code) const
+{
+    int out = 0;
+    for (OpCode entry : this->opcodes)
+    {
+        if (entry == code)
+        {
+            out++;
+        }
+    }
+    return out;
+}
+
+const std::vector<std::shared_ptr<Variable>>& Program::getVariables() const
+{
+    return this->variables;
+}
+
+int Program::getSlot(const std::shared_ptr<Variable>& var) const
+{
+    for (int slot = 0; slot < this->variables.size(); slot++)
+    {
+        if (this->variables[slot]->equals(var))
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+double Program::evaluate(const double* slots) const
+{
+    std::vector<double> scratch;
+    return this->evaluate(slots, scratch);
+}
+
+double Program::evaluate(const double* slots,
+                                    std::vector<double>& scratch) const
+{
+    if (this->outputs.empty())
+    {
+        throw std::runtime_error("Program has no output");
+    }
+    // Entries after the output are not needed for it
+    int count = this->outputs[0] + 1;
+    scratch.resize(count);
+    FlatTree::evaluate(count, this->opcodes.data(), this->lefts.data(),
+                    this->rights.data(), this->values.data(),
+                    this->symbols.data(), slots, scratch.data());
+    return scratch[this->outputs[0]];
+}
+
+void Program::evaluate(const double* slots, std::vector<double>& scratch,
+                                                    double* results) const
+{
+    if (this->outputs.empty())
+    {
+        throw std::runtime_error("Program has no output");
+    }
+    int count = *std::max_element(this->outputs.begin(),
+                                                this->outputs.end()) + 1;
+    scratch.resize(count);
+    FlatTree::evaluate(count, this->opcodes.data(), this->lefts.data(),
+                    this->rights.data(), this->values.data(),
+                    this->symbols.data(), slots, scratch.data());
+    for (int position = 0; position < this->outputs.size(); position++)
+    {
+        results[position] = scratch[this->outputs[position]];
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef __PROGRAM_HPP__
+#define __PROGRAM_HPP__
+
+#include "token.hpp"
+#include "flat_tree.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief Straight-line program: a FlatTree whose entries may be shared.
+ *
+ * @details Entries use the FlatTree layout and opcodes, and every operand
+ * comes before its user, so FlatTree's raw evaluate runs it unchanged.
+ * Unlike a FlatTree it is a DAG: adding an entry that already exists
+ * (same opcode, operands and payload) returns the existing index, so
+ * each distinct sub-expression is computed once. Operands of additions
+ * and multiplications are ordered, so a*b and b*a share an entry.
+ */
+class Program
+{
+public:
+    Program() = default;
+
+    int size() const;
+
+    /**
+     * @brief The entry holding value.
+     */
+    int constant(double value);
+
+    /**
+     * @brief The entry reading var, which gets a slot on first use.
+     */
+    int variable(const std::shared_ptr<Variable>& var);
+
+    /**
+     * @brief The entry applying code to earlier entries.
+     *
+     * @param value the base of a LOG entry, unused otherwise.
+     */
+    int apply(OpCode code, int left, int right = -1, double value = 0.0);
+
+    /**
+     * @brief Makes idx the only output, the one evaluate returns.
+     */
+    void setOutput(int idx);
+
+    /**
+     * @brief Adds another output, computed by the same run.
+     *
+     * @return its position among the outputs.
+     */
+    int addOutput(int idx);
+    int getOutput(int position = 0) const;
+    int getOutputCount() const;
+
+    OpCode getOpCode(int idx) const;
+    int getLeft(int idx) const;
+    int getRight(int idx) const;
+    double getValue(int idx) const;
+    int getSymbol(int idx) const;
+
+    /**
+     * @brief Number of entries with the given opcode.
+     */
+    int count(OpCode code) const;
+
+    /**
+     * @brief The distinct variables, indexed by slot.
+     */
+    const std::vector<std::shared_ptr<Variable>>& getVariables() const;
+
+    /**
+     * @brief Finds the slot assigned to a variable, -1 if it is unused.
+     */
+    int getSlot(const std::shared_ptr<Variable>& var) const;
+
+    /**
+     * @brief Runs the program with one value per variable slot.
+     *
+     * @param scratch buffer reused between calls, resized as needed.
+     */
+    double evaluate(const double* slots, std::vector<double>& scratch) const;
+    double evaluate(const double* slots) const;
+
+    /**
+     * @brief Runs the program once, writing every output to results.
+     */
+    void evaluate(const double* slots, std::vector<double>& scratch,
+                                                    double* results) const;
+
+private:
+    typedef std::tuple<OpCode, int, int, double, int> Key;
+
+    std::vector<OpCode> opcodes;
+    std::vector<std::int32_t> lefts;
+    std::vector<std::int32_t> rights;
+    std::vector<double> values;
+    std::vector<std::int32_t> symbols;
+    std::vector<std::shared_ptr<Variable>> variables;
+    //! Entries by content, for sharing
+    std::map<Key, int> entries;
+    std::vector<int> outputs;
+
+    int add(OpCode code, int left, int right, double value, int symbol);
+};
+
+#endif // __PROGRAM_HPP__
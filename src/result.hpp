@@ -0,0 +1,92 @@
+#ifndef __RESULT_HPP__
+#define __RESULT_HPP__
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+
+/**
+ * @brief Why an input was rejected.
+ */
+struct Error
+{
+    enum class Code
+    {
+        SYNTAX,     //!< the input does not parse into a complete tree
+        DOMAIN,     //!< a value is undefined, such as 1/0, 0^0 or ln(-1)
+        UNBOUND     //!< a variable has no value to evaluate with
+    };
+
+    Code code;
+    std::string message;
+};
+
+/**
+ * @brief A value, or the Error that prevented it.
+ *
+ * @details The try* functions return one where the plain function would
+ * throw, so a batch that expects bad inputs pays no unwinding for them.
+ * The plain functions are orThrow() of their try* form and throw
+ * std::runtime_error with the same message as before.
+ */
+template <class Value>
+class Result
+{
+public:
+    Result(Value value) : state(std::move(value)) {}
+    Result(Error error) : state(std::move(error)) {}
+
+    bool ok() const
+    {
+        return this->state.index() == 0;
+    }
+
+    explicit operator bool() const
+    {
+        return this->ok();
+    }
+
+    //! Only valid when ok()
+    const Value& value() const
+    {
+        return std::get<0>(this->state);
+    }
+    Value& value()
+    {
+        return std::get<0>(this->state);
+    }
+
+    //! Only valid when !ok()
+    const Error& error() const
+    {
+        return std::get<1>(this->state);
+    }
+
+    /**
+     * @brief The value.
+     *
+     * @throws std::runtime_error with the error's message if !ok()
+     */
+    const Value& orThrow() const &
+    {
+        if (!this->ok())
+        {
+            throw std::runtime_error(this->error().message);
+        }
+        return this->value();
+    }
+    Value orThrow() &&
+    {
+        if (!this->ok())
+        {
+            throw std::runtime_error(this->error().message);
+        }
+        return std::move(std::get<0>(this->state));
+    }
+
+private:
+    std::variant<Value, Error> state;
+};
+
+#endif // __RESULT_HPP__
@@ -0,0 +1,283 @@
+#include "root_finder.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+RootFinder::RootFinder(std::string input, std::string wrt, Method method)
+    : method(method), tolerance(1e-12), maxIterations(100)
+{
+    this->wrt = Derivative::parseVariable(wrt);
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    if (!root)
+    {
+        throw std::runtime_error("Empty expression");
+    }
+    TreeFixer::checkTree(root);
+    root = TreeFixer::simplify(root);
+    this->build(root);
+}
+
+RootFinder::RootFinder(nodePtr root, std::shared_ptr<Variable> wrt,
+                                                            Method method)
+    : wrt(wrt), method(method), tolerance(1e-12), maxIterations(100)
+{
+    // checkTree normalizes in place, and copyTree would share function
+    // arguments with the caller
+    auto copy = root->cloneTree();
+    TreeFixer::checkTree(copy);
+    copy = TreeFixer::simplify(copy);
+    this->build(copy);
+}
+
+void RootFinder::build(nodePtr root)
+{
+    Derivative first(root, this->wrt);
+    first.log.setEnabled(false);
+    auto derivative = first.solve();
+    this->trees[0] = FlatTree(root);
+    this->trees[1] = FlatTree(derivative);
+    if (this->method == Method::HALLEY)
+    {
+        Derivative second(derivative, this->wrt);
+        second.log.setEnabled(false);
+        this->trees[2] = FlatTree(second.solve());
+    }
+    for (int order = 0; order < 3; order++)
+    {
+        this->sweeps[order] = this->trees[order].getSlot(this->wrt);
+        this->slots[order].assign(
+                        this->trees[order].getVariables().size(), 1.0);
+    }
+}
+
+void RootFinder::bind(const Bindings& bindings)
+{
+    for (int order = 0; order < 3; order++)
+    {
+        this->slots[order] = bindings.getSlots(this->trees[order], this->wrt);
+    }
+}
+
+void RootFinder::setTolerance(double tolerance)
+{
+    this->tolerance = tolerance;
+}
+
+void RootFinder::setMaxIterations(int maxIterations)
+{
+    this->maxIterations = maxIterations;
+}
+
+double RootFinder::evaluate(int order, double value, Workspace& space) const
+{
+    auto& slots = space.slots[order];
+    if (this->sweeps[order] != -1)
+    {
+        slots[this->sweeps[order]] = value;
+    }
+    return this->trees[order].evaluate(slots.data(), space.scratch);
+}
+
+// Newton step f/f', or Halley step 2ff'/(2f'^2 - ff'') when available
+double RootFinder::step(double value, double fx, Workspace& space) const
+{
+    double first = this->evaluate(1, value, space);
+    if (this->method == Method::HALLEY)
+    {
+        double second = this->evaluate(2, value, space);
+        double denominator = 2 * first * first - fx * second;
+        if (denominator != 0 && std::isfinite(denominator))
+        {
+            return 2 * fx * first / denominator;
+        }
+    }
+    return fx / first;
+}
+
+bool RootFinder::bracketed(double lo, double hi, double flo, Root& out,
+                                                    Workspace& space) const
+{
+    double value = lo + (hi - lo) / 2;
+    // The last two step lengths, the first being the bisection to value
+    double last = (hi - lo) / 2;
+    double before = hi - lo;
+    int iterations = 0;
+    bool converged = false;
+    while (iterations < this->maxIterations)
+    {
+        iterations++;
+        double fx = this->evaluate(0, value, space);
+        if (fx == 0)
+        {
+            converged = true;
+            break;
+        }
+        if ((fx < 0) == (flo < 0))
+        {
+            lo = value;
+            flo = fx;
+        }
+        else
+        {
+            hi = value;
+        }
+        double scale = this->tolerance * (1 + std::fabs(value));
+        double next = value - this->step(value, fx, space);
+        bool inside = std::isfinite(next) && next > lo && next < hi;
+        if (inside && std::fabs(next - value) <= scale)
+        {
+            value = next;
+            converged = true;
+            break;
+        }
+        // Steps that do not halve every other iteration are slower than
+        // bisection, as when f' is small or wrong
+        if (!inside || std::fabs(next - value) > before / 2)
+        {
+            next = lo + (hi - lo) / 2;
+        }
+        before = last;
+        last = std::fabs(next - value);
+        value = next;
+        if (hi - lo <= scale)
+        {
+            converged = true;
+            break;
+        }
+    }
+    out = {value, std::fabs(this->evaluate(0, value, space)), iterations, 1};
+    return converged;
+}
+
+bool RootFinder::unbracketed(double lo, double hi, Root& out,
+                                                    Workspace& space) const
+{
+    double value = lo + (hi - lo) / 2;
+    for (int iterations = 1; iterations <= this->maxIterations; iterations++)
+    {
+        double fx = this->evaluate(0, value, space);
+        if (!std::isfinite(fx))
+        {
+            return false;
+        }
+        if (fx == 0)
+        {
+            out = {value, 0.0, iterations, 1};
+            return true;
+        }
+        double next = value - this->step(value, fx, space);
+        // Leaving the sub-interval means another one owns the root
+        if (!std::isfinite(next) || next < lo || next > hi)
+        {
+            return false;
+        }
+        if (std::fabs(next - value) <= this->tolerance *
+                                                (1 + std::fabs(value)))
+        {
+            out = {next, std::fabs(this->evaluate(0, next, space)),
+                                                            iterations, 1};
+            return true;
+        }
+        value = next;
+    }
+    return false;
+}
+
+bool RootFinder::search(double lo, double hi, Root& out) const
+{
+    Workspace space;
+    std::vector<Interval> ranges(this->slots[0].begin(),
+                                                    this->slots[0].end());
+    if (this->sweeps[0] != -1)
+    {
+        ranges[this->sweeps[0]] = Interval(lo, hi);
+    }
+    Interval bound = this->trees[0].evaluate(ranges.data());
+    if (bound.isEmpty() || (!bound.partial && !bound.contains(0.0)))
+    {
+        return false;
+    }
+
+    for (int order = 0; order < 3; order++)
+    {
+        space.slots[order] = this->slots[order];
+    }
+    double flo = this->evaluate(0, lo, space);
+    double fhi = this->evaluate(0, hi, space);
+    if (flo == 0 || fhi == 0)
+    {
+        out = {flo == 0 ? lo : hi, 0.0, 0, 1};
+        return true;
+    }
+    if (std::isfinite(flo) && std::isfinite(fhi) && (flo < 0) != (fhi < 0))
+    {
+        // A sign change across a pole converges to the pole, where |f|
+        // grows instead of shrinking
+        return this->bracketed(lo, hi, flo, out, space) &&
+                    out.residual <= std::min(std::fabs(flo), std::fabs(fhi));
+    }
+    return this->unbracketed(lo, hi, out, space);
+}
+
+std::vector<RootFinder::Root> RootFinder::solve(double lo, double hi,
+                                            int starts, int threads) const
+{
+    if (!(lo < hi) || starts <= 0)
+    {
+        throw std::runtime_error("Invalid root search interval");
+    }
+    std::vector<Root> found(starts);
+    std::vector<char> success(starts, 0);
+    double width = (hi - lo) / starts;
+    ThreadPool pool(std::min(threads > 0 ? threads :
+                    static_cast<int>(std::thread::hardware_concurrency()),
+                    starts));
+    pool.parallelFor(starts, [&](int idx) {
+        double first = lo + idx * width;
+        double last = idx == starts - 1 ? hi : lo + (idx + 1) * width;
+        success[idx] = this->search(first, last, found[idx]);
+    });
+
+    std::vector<Root> roots;
+    for (int idx = 0; idx < starts; idx++)
+    {
+        if (success[idx])
+        {
+            roots.push_back(found[idx]);
+        }
+    }
+    std::sort(roots.begin(), roots.end(), [](const Root& a, const Root& b) {
+        return a.value < b.value;
+    });
+
+    // Iterations stop at tolerance, but roots of higher multiplicity only
+    // converge to about its square root
+    std::vector<Root> out;
+    double merge = std::sqrt(this->tolerance);
+    for (const auto& root : roots)
+    {
+        if (!out.empty() && std::fabs(root.value - out.back().value) <=
+                                    merge * (1 + std::fabs(root.value)))
+        {
+            Root& kept = out.back();
+            int hits = kept.hits + root.hits;
+            if (root.residual < kept.residual)
+            {
+                kept = root;
+            }
+            kept.hits = hits;
+            continue;
+        }
+        out.push_back(root);
+    }
+    return out;
+}
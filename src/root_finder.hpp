@@ -0,0 +1,98 @@
+#ifndef __ROOT_FINDER_HPP__
+#define __ROOT_FINDER_HPP__
+
+#include "flat_tree.hpp"
+#include "bindings.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Finds the real roots of an expression on an interval.
+ *
+ * @details f', and f'' for Halley's method, are taken from Derivative once
+ * and frozen together with f. The search interval is cut into equal
+ * sub-intervals that are searched in parallel: interval evaluation skips
+ * the ones where f provably has no root, a sign change is refined by
+ * Newton or Halley steps that fall back to bisection whenever a step would
+ * leave the bracket or fails to halve it, and any other sub-interval gets
+ * plain iterations from its midpoint, which also catches roots of even
+ * multiplicity. Searches that do not reach the tolerance within the
+ * iteration limit report nothing. Roots found from several sub-intervals
+ * are merged.
+ */
+class RootFinder
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+public:
+    enum class Method
+    {
+        NEWTON,
+        HALLEY
+    };
+
+    struct Root
+    {
+        double value;
+        //! |f(value)|
+        double residual;
+        //! Iterations the search that produced value needed
+        int iterations;
+        //! Number of sub-intervals that converged to this root
+        int hits;
+    };
+
+    RootFinder(std::string input, std::string wrt,
+                                            Method method = Method::NEWTON);
+    RootFinder(nodePtr root, std::shared_ptr<Variable> wrt,
+                                            Method method = Method::NEWTON);
+
+    /**
+     * @brief Searches [lo, hi].
+     *
+     * @param starts number of sub-intervals, each searched once.
+     * @param threads worker threads, 0 uses the hardware concurrency.
+     * @return the distinct roots in increasing order.
+     */
+    std::vector<Root> solve(double lo, double hi, int starts = 64,
+                                                    int threads = 0) const;
+
+    void setTolerance(double tolerance);
+    void setMaxIterations(int maxIterations);
+
+    /**
+     * @brief Gives the variables other than wrt their values.
+     *
+     * @throws std::runtime_error if f, f' or f'' has an unbound variable
+     */
+    void bind(const Bindings& bindings);
+
+private:
+    //! Per-search buffers, so a RootFinder can be shared between threads
+    struct Workspace
+    {
+        std::vector<double> slots[3];
+        std::vector<double> scratch;
+    };
+
+    FlatTree trees[3];
+    int sweeps[3];
+    //! Values of the other variables, 1.0 until bind() is called
+    std::vector<double> slots[3];
+    std::shared_ptr<Variable> wrt;
+    Method method;
+    double tolerance;
+    int maxIterations;
+
+    void build(nodePtr root);
+    double evaluate(int order, double value, Workspace& space) const;
+    double step(double value, double fx, Workspace& space) const;
+    bool search(double lo, double hi, Root& out) const;
+    bool bracketed(double lo, double hi, double flo, Root& out,
+                                                    Workspace& space) const;
+    bool unbracketed(double lo, double hi, Root& out,
+                                                    Workspace& space) const;
+};
+
+#endif // __ROOT_FINDER_HPP__
@@ -0,0 +1,276 @@
+#include "series.hpp"
+
+#include <cmath>
+#include <limits>
+
+Series::Series(int order, double value) : coefficients(order + 1, 0.0)
+{
+    this->coefficients[0] = value;
+}
+
+Series Series::variable(int order, double value)
+{
+    Series out(order, value);
+    if (order > 0)
+    {
+        out[1] = 1.0;
+    }
+    return out;
+}
+
+int Series::order() const
+{
+    return static_cast<int>(this->coefficients.size()) - 1;
+}
+
+double Series::operator[](int idx) const
+{
+    return this->coefficients[idx];
+}
+
+double& Series::operator[](int idx)
+{
+    return this->coefficients[idx];
+}
+
+bool Series::isConstant(const Series& series)
+{
+    for (int idx = 1; idx <= series.order(); idx++)
+    {
+        if (series[idx] != 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Series Series::operator-() const
+{
+    Series out = *this;
+    for (auto& coefficient : out.coefficients)
+    {
+        coefficient = -coefficient;
+    }
+    return out;
+}
+
+Series operator+(const Series& first, const Series& second)
+{
+    Series out = first;
+    for (int idx = 0; idx <= out.order(); idx++)
+    {
+        out[idx] += second[idx];
+    }
+    return out;
+}
+
+Series operator-(const Series& first, const Series& second)
+{
+    Series out = first;
+    for (int idx = 0; idx <= out.order(); idx++)
+    {
+        out[idx] -= second[idx];
+    }
+    return out;
+}
+
+Series operator*(const Series& first, const Series& second)
+{
+    Series out(first.order(), 0.0);
+    for (int idx = 0; idx <= out.order(); idx++)
+    {
+        double sum = 0.0;
+        for (int inner = 0; inner <= idx; inner++)
+        {
+            sum += first[inner] * second[idx - inner];
+        }
+        out[idx] = sum;
+    }
+    return out;
+}
+
+// q = u / v  =>  q_k = (u_k - sum_{j=1..k} v_j q_{k-j}) / v_0
+Series operator/(const Series& first, const Series& second)
+{
+    Series out(first.order(), 0.0);
+    for (int idx = 0; idx <= out.order(); idx++)
+    {
+        double sum = first[idx];
+        for (int inner = 1; inner <= idx; inner++)
+        {
+            sum -= second[inner] * out[idx - inner];
+        }
+        out[idx] = sum / second[0];
+    }
+    return out;
+}
+
+// p = a^r  =>  k a_0 p_k = sum_{j=1..k} (r j - (k - j)) a_j p_{k-j}
+Series Series::constantPow(const Series& base, double exponent)
+{
+    int order = base.order();
+    int shift = 0;
+    while (shift <= order && base[shift] == 0.0)
+    {
+        shift++;
+    }
+    if (shift > order)
+    {
+        return Series(order, std::pow(0.0, exponent));
+    }
+    if (shift > 0)
+    {
+        // a = h^m b with b_0 != 0, so a^r = h^(m r) b^r when m r is a
+        // whole number
+        double leading = shift * exponent;
+        if (leading < 0 || std::floor(leading) != leading)
+        {
+            return Series(order, std::numeric_limits<double>::quiet_NaN());
+        }
+        Series reduced(order, 0.0);
+        for (int idx = shift; idx <= order; idx++)
+        {
+            reduced[idx - shift] = base[idx];
+        }
+        Series powered = constantPow(reduced, exponent);
+        Series out(order, 0.0);
+        for (int idx = static_cast<int>(leading); idx <= order; idx++)
+        {
+            out[idx] = powered[idx - static_cast<int>(leading)];
+        }
+        return out;
+    }
+
+    Series out(order, std::pow(base[0], exponent));
+    for (int idx = 1; idx <= order; idx++)
+    {
+        double sum = 0.0;
+        for (int inner = 1; inner <= idx; inner++)
+        {
+            sum += (exponent * inner - (idx - inner)) * base[inner] *
+                                                        out[idx - inner];
+        }
+        out[idx] = sum / (idx * base[0]);
+    }
+    return out;
+}
+
+Series Series::pow(const Series& base, const Series& exponent)
+{
+    if (isConstant(exponent))
+    {
+        return constantPow(base, exponent[0]);
+    }
+    return exp(exponent * ln(base));
+}
+
+// s' = c a', c' = -s a'
+void Series::sinCos(const Series& arg, Series& sin, Series& cos)
+{
+    int order = arg.order();
+    sin = Series(order, std::sin(arg[0]));
+    cos = Series(order, std::cos(arg[0]));
+    for (int idx = 1; idx <= order; idx++)
+    {
+        double sinSum = 0.0;
+        double cosSum = 0.0;
+        for (int inner = 1; inner <= idx; inner++)
+        {
+            sinSum += inner * arg[inner] * cos[idx - inner];
+            cosSum += inner * arg[inner] * sin[idx - inner];
+        }
+        sin[idx] = sinSum / idx;
+        cos[idx] = -cosSum / idx;
+    }
+}
+
+Series Series::sin(const Series& arg)
+{
+    Series sin;
+    Series cos;
+    sinCos(arg, sin, cos);
+    return sin;
+}
+
+Series Series::cos(const Series& arg)
+{
+    Series sin;
+    Series cos;
+    sinCos(arg, sin, cos);
+    return cos;
+}
+
+Series Series::tan(const Series& arg)
+{
+    Series sin;
+    Series cos;
+    sinCos(arg, sin, cos);
+    return sin / cos;
+}
+
+Series Series::cot(const Series& arg)
+{
+    Series sin;
+    Series cos;
+    sinCos(arg, sin, cos);
+    return cos / sin;
+}
+
+Series Series::csc(const Series& arg)
+{
+    return Series(arg.order(), 1.0) / sin(arg);
+}
+
+Series Series::sec(const Series& arg)
+{
+    return Series(arg.order(), 1.0) / cos(arg);
+}
+
+// e' = e a'  =>  k e_k = sum_{j=1..k} j a_j e_{k-j}
+Series Series::exp(const Series& arg)
+{
+    Series out(arg.order(), std::exp(arg[0]));
+    for (int idx = 1; idx <= arg.order(); idx++)
+    {
+        double sum = 0.0;
+        for (int inner = 1; inner <= idx; inner++)
+        {
+            sum += inner * arg[inner] * out[idx - inner];
+        }
+        out[idx] = sum / idx;
+    }
+    return out;
+}
+
+// a l' = a'  =>  l_k = (a_k - sum_{j=1..k-1} j l_j a_{k-j} / k) / a_0
+Series Series::ln(const Series& arg)
+{
+    Series out(arg.order(), std::log(arg[0]));
+    for (int idx = 1; idx <= arg.order(); idx++)
+    {
+        double sum = 0.0;
+        for (int inner = 1; inner < idx; inner++)
+        {
+            sum += inner * out[inner] * arg[idx - inner];
+        }
+        out[idx] = (arg[idx] - sum / idx) / arg[0];
+    }
+    return out;
+}
+
+Series Series::log(const Series& arg, double base)
+{
+    Series out = ln(arg);
+    double scale = std::log(base);
+    for (auto& coefficient : out.coefficients)
+    {
+        coefficient /= scale;
+    }
+    return out;
+}
+
+Series Series::sqrt(const Series& arg)
+{
+    return constantPow(arg, 0.5);
+}
@@ -0,0 +1,58 @@
+#ifndef __SERIES_HPP__
+#define __SERIES_HPP__
+
+#include <vector>
+
+/**
+ * @brief Truncated power series c0 + c1 h + ... + cn h^n.
+ *
+ * @details Operations keep the order of their arguments and use the usual
+ * recurrences, so every operation costs O(n^2). Domain errors are not
+ * thrown: as with FlatTree evaluation they come back as NaN or infinite
+ * coefficients.
+ */
+struct Series
+{
+    std::vector<double> coefficients;
+
+    Series() = default;
+
+    /**
+     * @brief The constant value, to the given order.
+     */
+    Series(int order, double value);
+
+    /**
+     * @brief value + h, the series of the expansion variable itself.
+     */
+    static Series variable(int order, double value);
+
+    int order() const;
+    double operator[](int idx) const;
+    double& operator[](int idx);
+
+    Series operator-() const;
+    friend Series operator+(const Series& first, const Series& second);
+    friend Series operator-(const Series& first, const Series& second);
+    friend Series operator*(const Series& first, const Series& second);
+    friend Series operator/(const Series& first, const Series& second);
+
+    static Series pow(const Series& base, const Series& exponent);
+    static Series sin(const Series& arg);
+    static Series cos(const Series& arg);
+    static Series tan(const Series& arg);
+    static Series cot(const Series& arg);
+    static Series csc(const Series& arg);
+    static Series sec(const Series& arg);
+    static Series exp(const Series& arg);
+    static Series ln(const Series& arg);
+    static Series log(const Series& arg, double base);
+    static Series sqrt(const Series& arg);
+
+private:
+    static Series constantPow(const Series& base, double exponent);
+    static void sinCos(const Series& arg, Series& sin, Series& cos);
+    static bool isConstant(const Series& series);
+};
+
+#endif // __SERIES_HPP__
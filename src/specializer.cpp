@@ -0,0 +1,153 @@
+#include "specializer.hpp"
+#include "tree_fixer.hpp"
+#include "token_pool.hpp"
+#include "lookup.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+std::shared_ptr<ExpressionNode> Specializer::specialize(const nodePtr& root,
+                                                    const Bindings& bindings)
+{
+    if (!root)
+    {
+        throw std::runtime_error("Cannot specialize an empty tree");
+    }
+    return TreeFixer::simplify(substitute(root, bindings));
+}
+
+FlatTree Specializer::compile(const nodePtr& root, const Bindings& bindings)
+{
+    return FlatTree(specialize(root, bindings));
+}
+
+std::shared_ptr<ExpressionNode> Specializer::makeNumber(double value)
+{
+    if (std::trunc(value) == value &&
+                        std::fabs(value) <= std::numeric_limits<int>::max())
+    {
+        return std::make_shared<ExpressionNode>(
+                            TokenPool::number(static_cast<int>(value)));
+    }
+    // Number keeps the magnitude and a sign flag
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer),
+                                                        std::fabs(value));
+    auto num = std::make_shared<Number>(std::string(buffer, result.ptr),
+                                                        std::fabs(value));
+    if (std::signbit(value) && !std::isnan(value))
+    {
+        num->flipSign();
+    }
+    return std::make_shared<ExpressionNode>(num);
+}
+
+bool Specializer::getConstant(const nodePtr& node, double& value)
+{
+    if (node->getType() != TokenType::NUMBER)
+    {
+        return false;
+    }
+    auto num = std::dynamic_pointer_cast<Number>(node->getToken());
+    value = num->isInt() ? num->getInt() * 1.0 : num->getDouble();
+    return true;
+}
+
+std::shared_ptr<ExpressionNode> Specializer::substitute(const nodePtr& node,
+                                                    const Bindings& bindings)
+{
+    auto token = node->getToken();
+    double result = 0.0;
+    if (node->getType() == TokenType::VARIABLE)
+    {
+        int idx = bindings.find(std::dynamic_pointer_cast<Variable>(token));
+        if (idx == -1)
+        {
+            return node;
+        }
+        result = bindings.getValue(idx);
+    }
+    else if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        auto arg = substitute(func->getSubExprTree(), bindings);
+        double value;
+        if (!getConstant(arg, value))
+        {
+            if (arg == func->getSubExprTree())
+            {
+                return node;
+            }
+            auto copy = std::dynamic_pointer_cast<Function>(func->clone());
+            copy->setSubExprTree(arg);
+            return std::make_shared<ExpressionNode>(copy);
+        }
+        auto definition = Lookup::getFunction(func->getStr());
+        if (definition)
+        {
+            result = definition->evaluate(value);
+        }
+        else
+        {
+            double base = 10.0;
+            if (func->getSubscript())
+            {
+                auto subscript = func->getSubscript();
+                base = subscript->isInt() ? subscript->getInt() * 1.0 :
+                                            subscript->getDouble();
+            }
+            result = FlatTree::applyFunction(
+                    FlatTree::getFunctionCode(func->getStr()), value, base);
+        }
+    }
+    else if (node->getType() == TokenType::OPERATOR)
+    {
+        auto left = substitute(node->getLeft(), bindings);
+        auto right = substitute(node->getRight(), bindings);
+        double leftValue;
+        double rightValue;
+        if (getConstant(left, leftValue) && getConstant(right, rightValue))
+        {
+            std::string op = node->getStr();
+            if (op == "+")
+            {
+                result = leftValue + rightValue;
+            }
+            else if (op == "-")
+            {
+                result = leftValue - rightValue;
+            }
+            else if (op == "*")
+            {
+                result = leftValue * rightValue;
+            }
+            else if (op == "/")
+            {
+                result = leftValue / rightValue;
+            }
+            else
+            {
+                result = std::pow(leftValue, rightValue);
+            }
+        }
+        else
+        {
+            if (left == node->getLeft() && right == node->getRight())
+            {
+                return node;
+            }
+            // Operator tokens may be pooled, the new node shares the token
+            auto copy = std::make_shared<ExpressionNode>(token);
+            copy->setLeft(left);
+            copy->setRight(right);
+            return copy;
+        }
+    }
+    else
+    {
+        return node;
+    }
+    return makeNumber(token->isNegative() ? -result : result);
+}
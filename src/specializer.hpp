@@ -0,0 +1,53 @@
+#ifndef __SPECIALIZER_HPP__
+#define __SPECIALIZER_HPP__
+
+#include "expression_node.hpp"
+#include "flat_tree.hpp"
+#include "bindings.hpp"
+
+#include <memory>
+
+/**
+ * @brief Partial evaluation of an expression for fixed parameter values.
+ *
+ * @details Bound variables are replaced by their values, then every
+ * operator and function whose operands have become numbers is folded,
+ * and TreeFixer::simplify drops the identities this leaves behind
+ * (a*0, x^1, ...). Folding is done in double precision, as evaluation
+ * would, regardless of Arithmetic::floatSimplification, so 1/0 or ln(-1)
+ * become an infinite or NaN number instead of throwing. Like simplify, the result shares every
+ * untouched subtree with the input, which is not changed.
+ */
+class Specializer
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+public:
+    /**
+     * @brief The smaller tree left once bindings are substituted.
+     *
+     * @details Variables without a value stay symbolic.
+     */
+    static nodePtr specialize(const nodePtr& root, const Bindings& bindings);
+
+    /**
+     * @brief specialize, then freeze the result for evaluation.
+     *
+     * @details Meant to be called once per batch: the returned tree only
+     * has slots for the variables that were left unbound.
+     */
+    static FlatTree compile(const nodePtr& root, const Bindings& bindings);
+
+    /**
+     * @brief A number node for value, pooled when it is a small integer.
+     *
+     * @details Non-integers keep the shortest string that reads back as
+     * the same double, so printed and generated code loses nothing.
+     */
+    static nodePtr makeNumber(double value);
+
+private:
+    static nodePtr substitute(const nodePtr& node, const Bindings& bindings);
+    static bool getConstant(const nodePtr& node, double& value);
+};
+
+#endif // __SPECIALIZER_HPP__
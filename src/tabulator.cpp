@@ -0,0 +1,239 @@
+#include "tabulator.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+Tabulator::Tabulator(std::string input, std::string wrt)
+{
+    auto var = Derivative::parseVariable(wrt);
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    if (!root)
+    {
+        throw std::runtime_error("Empty expression");
+    }
+    TreeFixer::checkTree(root);
+    root = TreeFixer::simplify(root);
+
+    Derivative engine(root, var);
+    engine.log.setEnabled(false);
+    this->function = FlatTree(root);
+    this->derivative = FlatTree(engine.solve());
+    this->setSlots(var);
+}
+
+Tabulator::Tabulator(const FlatTree& function, const FlatTree& derivative,
+                                            std::shared_ptr<Variable> wrt)
+    : function(function), derivative(derivative)
+{
+    this->setSlots(wrt);
+}
+
+void Tabulator::setSlots(std::shared_ptr<Variable> wrt)
+{
+    this->functionSlots.assign(this->function.getVariables().size(), 1.0);
+    this->derivativeSlots.assign(this->derivative.getVariables().size(), 1.0);
+    this->functionSweep = this->function.getSlot(wrt);
+    this->derivativeSweep = this->derivative.getSlot(wrt);
+    this->wrt = wrt;
+}
+
+void Tabulator::bind(const Bindings& bindings)
+{
+    this->functionSlots = bindings.getSlots(this->function, this->wrt);
+    this->derivativeSlots = bindings.getSlots(this->derivative, this->wrt);
+}
+
+std::size_t Tabulator::Range::count() const
+{
+    double steps = (this->stop - this->start) / this->step;
+    if (!std::isfinite(steps) || steps < 0)
+    {
+        throw std::runtime_error("Invalid range: step does not reach stop");
+    }
+    // Allow for rounding in the division so stop itself is included
+    return static_cast<std::size_t>(std::floor(steps + 1e-9)) + 1;
+}
+
+double Tabulator::Range::at(std::size_t idx) const
+{
+    // Computed from the index so errors do not accumulate along the grid
+    return this->start + idx * this->step;
+}
+
+Tabulator::Range Tabulator::parseRange(const std::string& range)
+{
+    std::vector<double> parts;
+    std::size_t begin = 0;
+    while (true)
+    {
+        std::size_t end = range.find(':', begin);
+        std::string part = range.substr(begin, end == std::string::npos ?
+                                        std::string::npos : end - begin);
+        std::size_t used = 0;
+        try
+        {
+            parts.push_back(std::stod(part, &used));
+        }
+        catch (const std::exception&)
+        {
+            used = 0;
+        }
+        if (used == 0 || used != part.size())
+        {
+            throw std::runtime_error("Invalid range \"" + range +
+                                        "\", expected start:stop:step");
+        }
+        if (end == std::string::npos)
+        {
+            break;
+        }
+        begin = end + 1;
+    }
+    if (parts.size() != 3 || parts[2] == 0.0)
+    {
+        throw std::runtime_error("Invalid range \"" + range +
+                                        "\", expected start:stop:step");
+    }
+    Range out = {parts[0], parts[1], parts[2]};
+    // Rejects a step that points away from stop
+    out.count();
+    return out;
+}
+
+void Tabulator::fill(const Range& range, std::size_t first, int count,
+                                                        double* out) const
+{
+    std::vector<double> xs(count);
+    std::vector<double> values(count);
+    std::vector<double> derivatives(count);
+    std::vector<double> scratch;
+    for (int idx = 0; idx < count; idx++)
+    {
+        xs[idx] = range.at(first + idx);
+    }
+    this->function.evaluate(this->functionSlots.data(), this->functionSweep,
+                            xs.data(), count, values.data(), scratch);
+    this->derivative.evaluate(this->derivativeSlots.data(),
+                            this->derivativeSweep, xs.data(), count,
+                            derivatives.data(), scratch);
+    for (int idx = 0; idx < count; idx++)
+    {
+        out[3 * idx] = xs[idx];
+        out[3 * idx + 1] = values[idx];
+        out[3 * idx + 2] = derivatives[idx];
+    }
+}
+
+void Tabulator::tabulate(const Range& range, double* out, int threads) const
+{
+    std::size_t points = range.count();
+    std::size_t chunks = (points + CHUNK - 1) / CHUNK;
+    ThreadPool pool(threads);
+    pool.parallelFor(chunks, [&](int chunk) {
+        std::size_t first = static_cast<std::size_t>(chunk) * CHUNK;
+        int count = std::min<std::size_t>(CHUNK, points - first);
+        this->fill(range, first, count, out + 3 * first);
+    });
+}
+
+void Tabulator::write(std::ostream& out, const Range& range, Format format,
+                                                            int threads) const
+{
+    // Longest shortest-round-trip double plus a separator
+    const int FIELD = 26;
+    std::size_t points = range.count();
+    ThreadPool pool(threads);
+    std::size_t block = static_cast<std::size_t>(pool.size()) *
+                                                CHUNKS_PER_THREAD * CHUNK;
+    block = std::min(block, points);
+    int chunks = (block + CHUNK - 1) / CHUNK;
+
+    std::vector<double> rows(3 * block);
+    std::vector<char> text;
+    std::vector<std::size_t> lengths;
+    if (format == Format::CSV)
+    {
+        text.resize(block * 3 * FIELD);
+        lengths.resize(chunks);
+        out << "x,f,df\n";
+    }
+
+    for (std::size_t first = 0; first < points; first += block)
+    {
+        std::size_t count = std::min(block, points - first);
+        int used = (count + CHUNK - 1) / CHUNK;
+        pool.parallelFor(used, [&](int chunk) {
+            std::size_t offset = static_cast<std::size_t>(chunk) * CHUNK;
+            int size = std::min<std::size_t>(CHUNK, count - offset);
+            double* dest = rows.data() + 3 * offset;
+            this->fill(range, first + offset, size, dest);
+            if (format == Format::CSV)
+            {
+                lengths[chunk] = formatCSV(dest, size,
+                                        text.data() + offset * 3 * FIELD);
+            }
+            else
+            {
+                toLittleEndian(dest, 3 * size);
+            }
+        });
+
+        if (format == Format::CSV)
+        {
+            for (int chunk = 0; chunk < used; chunk++)
+            {
+                out.write(text.data() + chunk * CHUNK * 3 * FIELD,
+                                                        lengths[chunk]);
+            }
+        }
+        else
+        {
+            out.write(reinterpret_cast<const char*>(rows.data()),
+                                            3 * count * sizeof(double));
+        }
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write tabulated values");
+        }
+    }
+}
+
+std::size_t Tabulator::formatCSV(const double* rows, int count, char* buffer)
+{
+    char* current = buffer;
+    for (int idx = 0; idx < 3 * count; idx++)
+    {
+        // Large enough for any double, see FIELD in write
+        current = std::to_chars(current, current + 25, rows[idx]).ptr;
+        *current++ = (idx % 3 == 2) ? '\n' : ',';
+    }
+    return current - buffer;
+}
+
+void Tabulator::toLittleEndian(double* values, std::size_t count)
+{
+    const std::uint16_t probe = 1;
+    if (*reinterpret_cast<const unsigned char*>(&probe) == 1)
+    {
+        return;
+    }
+    for (std::size_t idx = 0; idx < count; idx++)
+    {
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &values[idx], sizeof(double));
+        std::reverse(bytes, bytes + sizeof(double));
+        std::memcpy(&values[idx], bytes, sizeof(double));
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef __TABULATOR_HPP__
+#define __TABULATOR_HPP__
+
+#include "flat_tree.hpp"
+#include "bindings.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Samples a function and its derivative on an evenly spaced grid.
+ *
+ * @details Both trees are frozen once. The grid is cut into chunks small
+ * enough for one chunk of every entry to stay in cache, chunks are
+ * evaluated in parallel with FlatTree's batch evaluate, and finished
+ * blocks of chunks are streamed to the output in order, so memory use does
+ * not grow with the number of points. Nothing is logged per point.
+ */
+class Tabulator
+{
+public:
+    enum class Format
+    {
+        //! x, f(x), f'(x) per point as little-endian doubles
+        BINARY,
+        //! "x,f,df" header followed by one line per point
+        CSV
+    };
+
+    /**
+     * @brief Grid start, start + step, ... up to and including stop.
+     */
+    struct Range
+    {
+        double start;
+        double stop;
+        double step;
+
+        std::size_t count() const;
+        double at(std::size_t idx) const;
+    };
+
+    /**
+     * @brief Parses and differentiates input.
+     */
+    Tabulator(std::string input, std::string wrt);
+
+    /**
+     * @brief Tabulates trees that are already frozen.
+     *
+     * @details Variables other than wrt are treated as 1.0 until bind
+     * gives them values.
+     */
+    Tabulator(const FlatTree& function, const FlatTree& derivative,
+                                            std::shared_ptr<Variable> wrt);
+
+    /**
+     * @brief Gives the variables other than wrt their values.
+     *
+     * @throws std::runtime_error if either tree has an unbound variable
+     */
+    void bind(const Bindings& bindings);
+
+    /**
+     * @brief Parses "start:stop:step".
+     */
+    static Range parseRange(const std::string& range);
+
+    /**
+     * @brief Evaluates the grid into memory.
+     *
+     * @param out receives 3 * range.count() values: x, f(x), f'(x) per
+     * point.
+     * @param threads worker threads, 0 uses the hardware concurrency
+     */
+    void tabulate(const Range& range, double* out, int threads = 0) const;
+
+    /**
+     * @brief Evaluates the grid and streams it to out.
+     */
+    void write(std::ostream& out, const Range& range, Format format,
+                                                    int threads = 0) const;
+
+private:
+    //! Points per chunk
+    static const int CHUNK = 256;
+    //! Chunks evaluated per thread before a block is written
+    static const int CHUNKS_PER_THREAD = 16;
+
+    FlatTree function;
+    FlatTree derivative;
+    std::vector<double> functionSlots;
+    std::vector<double> derivativeSlots;
+    int functionSweep;
+    int derivativeSweep;
+    std::shared_ptr<Variable> wrt;
+
+    void setSlots(std::shared_ptr<Variable> wrt);
+    void fill(const Range& range, std::size_t first, int count,
+                                                        double* out) const;
+    static std::size_t formatCSV(const double* rows, int count, char* buffer);
+    static void toLittleEndian(double* values, std::size_t count);
+};
+
+#endif // __TABULATOR_HPP__
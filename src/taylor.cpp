@@ -0,0 +1,241 @@
+#include "taylor.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "lookup.hpp"
+#include "operation.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+Taylor::Taylor(std::string input, std::string wrt)
+{
+    this->wrt = Derivative::parseVariable(wrt);
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    this->root = ExpressionNode::buildTree(converter.getPostfix());
+    if (!this->root)
+    {
+        throw std::runtime_error("Empty expression");
+    }
+    TreeFixer::checkTree(this->root);
+    this->root = TreeFixer::simplify(this->root);
+}
+
+Taylor::Taylor(nodePtr root, std::shared_ptr<Variable> wrt) : wrt(wrt)
+{
+    // checkTree normalizes in place, and copyTree would share function
+    // arguments with the caller
+    this->root = root->cloneTree();
+    TreeFixer::checkTree(this->root);
+    this->root = TreeFixer::simplify(this->root);
+}
+
+Series Taylor::expand(nodePtr node, const Series& variable) const
+{
+    if (!node)
+    {
+        throw std::runtime_error("Cannot expand an empty tree");
+    }
+    int order = variable.order();
+    auto token = node->getToken();
+    Series out;
+    if (node->getType() == TokenType::NUMBER)
+    {
+        auto num = std::dynamic_pointer_cast<Number>(token);
+        return Series(order, num->isInt() ? num->getInt() * 1.0 :
+                                                        num->getDouble());
+    }
+    else if (node->getType() == TokenType::VARIABLE)
+    {
+        out = this->wrt->equals(token) ? variable : Series(order, 1.0);
+    }
+    else if (node->getType() == TokenType::FUNCTION)
+    {
+        auto func = std::dynamic_pointer_cast<Function>(token);
+        auto arg = this->expand(func->getSubExprTree(), variable);
+        auto definition = Lookup::getFunction(func->getStr());
+        if (definition)
+        {
+            out = definition->evaluate(arg);
+        }
+        else if (func->getStr() == "log")
+        {
+            double base = 10.0;
+            if (func->getSubscript())
+            {
+                auto subscript = func->getSubscript();
+                base = subscript->isInt() ? subscript->getInt() * 1.0 :
+                                            subscript->getDouble();
+            }
+            out = Series::log(arg, base);
+        }
+        else
+        {
+            throw std::runtime_error("Cannot expand function " +
+                                                            func->getStr());
+        }
+    }
+    else if (node->getType() == TokenType::OPERATOR)
+    {
+        auto left = this->expand(node->getLeft(), variable);
+        auto right = this->expand(node->getRight(), variable);
+        std::string op = node->getStr();
+        if (op == "+")
+        {
+            out = left + right;
+        }
+        else if (op == "-")
+        {
+            out = left - right;
+        }
+        else if (op == "*")
+        {
+            out = left * right;
+        }
+        else if (op == "/")
+        {
+            out = left / right;
+        }
+        else if (op == "^")
+        {
+            out = Series::pow(left, right);
+        }
+        else
+        {
+            throw std::runtime_error("Cannot expand operator " + op);
+        }
+    }
+    else
+    {
+        throw std::runtime_error("Cannot expand token " + node->getStr());
+    }
+    return token->isNegative() ? -out : out;
+}
+
+std::vector<double> Taylor::coefficients(double point, int order)
+{
+    if (order < 0)
+    {
+        throw std::runtime_error("Taylor order must not be negative");
+    }
+    auto cached = this->cache.find(point);
+    if (cached == this->cache.end() || cached->second.order() < order)
+    {
+        Series expansion = this->expand(this->root,
+                                        Series::variable(order, point));
+        cached = this->cache.insert_or_assign(point, expansion).first;
+    }
+    const auto& all = cached->second.coefficients;
+    std::vector<double> out(all.begin(), all.begin() + order + 1);
+    // A pole or branch point at point, as for 1/x at 0, leaves inf or nan
+    for (double coefficient : out)
+    {
+        if (!std::isfinite(coefficient))
+        {
+            char buffer[32];
+            auto end = std::to_chars(buffer, buffer + sizeof(buffer),
+                                                                point).ptr;
+            throw std::domain_error("No Taylor expansion at " +
+                    std::string(buffer, end) + ", outside the domain");
+        }
+    }
+    return out;
+}
+
+std::vector<double> Taylor::derivatives(double point, int order)
+{
+    auto out = this->coefficients(point, order);
+    double factorial = 1.0;
+    for (int idx = 1; idx <= order; idx++)
+    {
+        factorial *= idx;
+        out[idx] *= factorial;
+    }
+    return out;
+}
+
+std::shared_ptr<ExpressionNode> Taylor::number(double value)
+{
+    // Number keeps the magnitude and a sign flag
+    double magnitude = std::fabs(value);
+    char buffer[32];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), magnitude).ptr;
+    std::string str(buffer, end);
+    std::shared_ptr<Number> num;
+    if (std::floor(magnitude) == magnitude && magnitude < 1e9)
+    {
+        num = std::make_shared<Number>(str, static_cast<int>(magnitude));
+    }
+    else
+    {
+        num = std::make_shared<Number>(str, magnitude);
+    }
+    if (value < 0)
+    {
+        num->flipSign();
+    }
+    return std::make_shared<ExpressionNode>(num);
+}
+
+std::shared_ptr<ExpressionNode> Taylor::polynomial(double point, int order)
+{
+    auto coefficients = this->coefficients(point, order);
+    nodePtr out = nullptr;
+    for (int idx = 0; idx <= order; idx++)
+    {
+        double coefficient = coefficients[idx];
+        if (coefficient == 0.0)
+        {
+            continue;
+        }
+        bool negative = out && coefficient < 0;
+        if (negative)
+        {
+            coefficient = -coefficient;
+        }
+
+        nodePtr term = nullptr;
+        if (idx > 0)
+        {
+            term = std::make_shared<ExpressionNode>(
+                                std::make_shared<Variable>(*this->wrt));
+            if (point != 0.0)
+            {
+                term = point > 0 ? Operation::subtract(term, number(point)) :
+                                    Operation::add(term, number(-point));
+            }
+            if (idx > 1)
+            {
+                term = Operation::power(term, number(idx));
+            }
+        }
+        if (!term)
+        {
+            term = number(coefficient);
+        }
+        else if (coefficient != 1.0)
+        {
+            term = Operation::times(number(coefficient), term);
+        }
+
+        if (!out)
+        {
+            out = term;
+        }
+        else
+        {
+            out = negative ? Operation::subtract(out, term) :
+                            Operation::add(out, term);
+        }
+    }
+    if (!out)
+    {
+        out = number(0.0);
+    }
+    return out;
+}
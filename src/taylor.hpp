@@ -0,0 +1,62 @@
+#ifndef __TAYLOR_HPP__
+#define __TAYLOR_HPP__
+
+#include "expression_node.hpp"
+#include "series.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Taylor expansion of an expression around a point.
+ *
+ * @details Instead of differentiating symbolically order after order, a
+ * truncated power series is propagated through the tree: the expansion
+ * variable becomes point + h, and each operator and FunctionDefinition
+ * maps the series of its arguments to its own in O(order^2). The
+ * coefficients of the root are the Taylor coefficients f^(k)(point) / k!.
+ * Expansions are cached per point, so asking for a lower order again, or
+ * for the derivative tower at the same point, does not re-walk the tree.
+ */
+class Taylor
+{
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+private:
+    nodePtr root;
+    std::shared_ptr<Variable> wrt;
+    std::map<double, Series> cache;
+
+    Series expand(nodePtr node, const Series& variable) const;
+    static nodePtr number(double value);
+public:
+    Taylor(std::string input, std::string wrt);
+
+    /**
+     * @brief Expands a tree owned by the caller, variables other than wrt
+     * are treated as 1.0.
+     */
+    Taylor(nodePtr root, std::shared_ptr<Variable> wrt);
+
+    /**
+     * @brief the coefficients c_k of (wrt - point)^k for k <= order
+     *
+     * @throws std::domain_error if a coefficient is not finite, when f is
+     * singular at point
+     */
+    std::vector<double> coefficients(double point, int order);
+
+    /**
+     * @brief the derivatives f^(k)(point) for k <= order
+     */
+    std::vector<double> derivatives(double point, int order);
+
+    /**
+     * @brief the truncated Taylor polynomial as an expression tree, for
+     * the existing converters
+     */
+    nodePtr polynomial(double point, int order);
+};
+
+#endif // __TAYLOR_HPP__
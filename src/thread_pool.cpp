@@ -0,0 +1,91 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(int threads) : stopping(false)
+{
+    if (threads <= 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads <= 0)
+    {
+        threads = 1;
+    }
+    for (int idx = 0; idx < threads; idx++)
+    {
+        this->workers.emplace_back([this]() { this->work(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->available.notify_all();
+    for (auto& worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const
+{
+    return this->workers.size();
+}
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->available.wait(guard, [this]() {
+                return this->stopping || !this->tasks.empty();
+            });
+            if (this->tasks.empty())
+            {
+                return;
+            }
+            task = std::move(this->tasks.front());
+            this->tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& body)
+{
+    std::vector<std::future<void>> results;
+    results.reserve(count);
+    for (int idx = 0; idx < count; idx++)
+    {
+        results.emplace_back(this->submit([&body, idx]() { body(idx); }));
+    }
+    // Wait for every task before rethrowing, body must outlive them
+    for (auto& result : results)
+    {
+        result.wait();
+    }
+    for (auto& result : results)
+    {
+        result.get();
+    }
+}
+
+bool ThreadPool::runPending()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (this->tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(this->tasks.front());
+        this->tasks.pop();
+    }
+    task();
+    return true;
+}
@@ -0,0 +1,104 @@
+#ifndef __THREAD_POOL_HPP__
+#define __THREAD_POOL_HPP__
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads fed from a shared task queue.
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex lock;
+    std::condition_variable available;
+    bool stopping;
+
+    void work();
+public:
+    /**
+     * @brief Starts the workers.
+     *
+     * @param threads number of workers, 0 uses the hardware concurrency.
+     */
+    ThreadPool(int threads = 0);
+
+    /**
+     * @brief Finishes the queued tasks and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const;
+
+    /**
+     * @brief Queues a task.
+     *
+     * @return a future for the result of the task. Exceptions thrown by the
+     * task are rethrown by future::get.
+     */
+    template <class Task>
+    std::future<typename std::invoke_result<Task>::type> submit(Task task)
+    {
+        typedef typename std::invoke_result<Task>::type result;
+        auto packaged = std::make_shared<std::packaged_task<result()>>(
+                                                            std::move(task));
+        std::future<result> out = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        this->available.notify_one();
+        return out;
+    }
+
+    /**
+     * @brief Runs body(idx) for every idx in [0, count) and waits for all
+     * of them, rethrowing the first exception.
+     */
+    void parallelFor(int count, const std::function<void(int)>& body);
+
+    /**
+     * @brief Waits for a task of this pool, running queued tasks meanwhile.
+     *
+     * @details This is what lets tasks wait for tasks they submitted
+     * (fork-join) without deadlocking: a waiting worker keeps draining the
+     * queue, and only blocks once every queued task has been taken, so
+     * the one it waits for is already running.
+     * @return the result of the task, exceptions are rethrown.
+     */
+    template <class Result>
+    Result join(std::future<Result>& result)
+    {
+        while (result.wait_for(std::chrono::seconds(0)) !=
+                                                std::future_status::ready)
+        {
+            if (!this->runPending())
+            {
+                result.wait();
+            }
+        }
+        return result.get();
+    }
+
+    /**
+     * @brief Runs one queued task on the calling thread.
+     *
+     * @return false if the queue was empty.
+     */
+    bool runPending();
+};
+
+#endif // __THREAD_POOL_HPP__
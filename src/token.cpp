@@ -12,6 +12,7 @@
 #include "token.hpp"
 #include "lookup.hpp"
 #include "token_queue.hpp"
+#include "expression_node.hpp"
 
 #include <stdexcept>
 
@@ -20,26 +21,34 @@
   * @param t The type of the token.
   * @param s The string representation of the token.
   */
-Token::Token(TokenType type, const std::string& str) : type(type), str(str)
+Token::Token(TokenType type, std::string str) : type(type),
+    str(std::move(str))
 {
-    if (Lookup::symbolTable.find(str) != Lookup::symbolTable.end())
+    const SymbolEntry* entry = Lookup::findSymbol(this->str);
+    if (entry)
     {
-        properties = Lookup::symbolTable[str].second;
+        properties = entry->properties;
     }
     else
     {
         properties = SymbolProperties(0, Associativity::NONE, false);
     }
+    this->pooled = false;
     this->setNegative(false);
 }
 
+Token::Token(const Token& other) : type(other.type), str(other.str),
+    properties(other.properties), negative(other.negative), pooled(false)
+{
+}
+
 
 TokenType Token::getType() const
 {
     return this->type;
 }
 
-std::string Token::getStr() const
+const std::string& Token::getStr() const
 {
     return this->str;
 }
@@ -78,6 +87,11 @@ bool Token::isCommutative()
  */
 void Token::setNegative(bool value)
 {
+    if (this->pooled && value != this->negative)
+    {
+        throw std::runtime_error("Cannot change the sign of shared token " +
+                                                                this->str);
+    }
     this->negative = value;
 }
 
@@ -95,40 +109,29 @@ void Token::flipSign()
     this->setNegative(!this->isNegative());
 }
 
-/**
- * @brief Default constructor for SymbolProperties.
- * Initializes precedence to -1 and associativity to LEFT.
- */
-SymbolProperties::SymbolProperties()
+bool Token::isPooled() const
 {
-    this->precedence = -1;
-    this->associativity = Associativity::LEFT;
-    this->commutative = false;
+    return this->pooled;
 }
 
-/**
- * @brief Constructs SymbolProperties with specified precedence and associativity.
- * @param precedence The precedence of the operator.
- * @param associativity The associativity of the operator.
- */
-SymbolProperties::SymbolProperties(int precedence, Associativity associativity,
-                bool commutative) : 
-    precedence(precedence), associativity(associativity), 
-        commutative(commutative) {}
-
-
-
-
-
+std::shared_ptr<Token> Token::clone() const
+{
+    return std::make_shared<Token>(*this);
+}
 
 /**
  * @brief Constructs an Operator with a specified string and properties.
  * @param str The string representation of the operator.
  */
-Operator::Operator(const std::string& str) :
-    Token(TokenType::OPERATOR, str)
+Operator::Operator(std::string str) :
+    Token(TokenType::OPERATOR, std::move(str))
 {
-    properties = Lookup::symbolTable[str].second;
+    const SymbolEntry* entry = Lookup::findSymbol(this->str);
+    if (!entry)
+    {
+        throw std::runtime_error("Operator not found!");
+    }
+    properties = entry->properties;
 }
 
 
@@ -138,16 +141,23 @@ Operator::Operator(const std::string& str) :
  * @brief Constructs a Function with a specified string and properties.
  * @param str The string representation of the function.
  */
-Function::Function(const std::string& str) :
-    Token(TokenType::FUNCTION, str) 
+std::shared_ptr<Token> Operator::clone() const
+{
+    return std::make_shared<Operator>(*this);
+}
+
+
+Function::Function(std::string str) :
+    Token(TokenType::FUNCTION, std::move(str)) 
 {
     this->subExpr = nullptr;
     this->subExprTree = nullptr;
     this->exponent = nullptr;
     this->subscript = nullptr;
-    if (Lookup::symbolTable.find(str) != Lookup::symbolTable.end())
+    const SymbolEntry* entry = Lookup::findSymbol(this->str);
+    if (entry)
     {
-        this->properties =  Lookup::symbolTable[str].second;
+        this->properties = entry->properties;
     }
     else
     {
@@ -162,12 +172,13 @@ void Function::setSubscript(std::shared_ptr<Number> base)
     {
         throw std::runtime_error( "Only log function can use subscripts");
     } 
+    this->subscript = std::move(base);
 }
 void Function::setExponent(std::shared_ptr<TokenQueue> exponent)
 {
-    this->exponent = exponent;
+    this->exponent = std::move(exponent);
 }
-std::shared_ptr<TokenQueue> Function::getExponent()
+const std::shared_ptr<TokenQueue>& Function::getExponent() const
 {
     return this->exponent;
 }
@@ -178,29 +189,43 @@ std::shared_ptr<TokenQueue> Function::getExponent()
  */
 void Function::setSubExpr(std::shared_ptr<TokenQueue> queue)
 {
-    this->subExpr = queue;
+    this->subExpr = std::move(queue);
 }
 
 void Function::setSubExprTree(std::shared_ptr<ExpressionNode> tree)
 {
-    this->subExprTree = tree;
+    this->subExprTree = std::move(tree);
 }
 
-std::shared_ptr<Number> Function::getSubscript()
+const std::shared_ptr<Number>& Function::getSubscript() const
 {
     return this->subscript;
 }
 
-std::shared_ptr<TokenQueue> Function::getSubExpr()
+const std::shared_ptr<TokenQueue>& Function::getSubExpr() const
 {
     return this->subExpr;
 }
-std::shared_ptr<ExpressionNode> Function::getSubExprTree()
+const std::shared_ptr<ExpressionNode>& Function::getSubExprTree() const
 {
     return this->subExprTree;
 }
 
 
+/**
+ * @brief Copies the function, including a deep copy of its subexpression
+ * tree so the copy can be simplified independently.
+ */
+std::shared_ptr<Token> Function::clone() const
+{
+    auto copy = std::make_shared<Function>(*this);
+    if (this->subExprTree)
+    {
+        copy->subExprTree = this->subExprTree->cloneTree();
+    }
+    return copy;
+}
+
 std::string Function::getFullStr()
 {
     std::string out = this->isNegative() ? "-" : "";
@@ -227,15 +252,16 @@ std::string Function::getFullStr()
  * @param str The string representation of the number.
  * @param value The numeric value (double).
  */
-Number::Number(const std::string& str, double value) :
-    Token(TokenType::NUMBER, str), value(value), type(NumberType::DOUBLE) 
+Number::Number(std::string str, double value) :
+    Token(TokenType::NUMBER, std::move(str)), value(value),
+    type(NumberType::DOUBLE) 
 {
     if (value < 0)
     {
         this->flipSign();
-        if (!str.empty())
+        if (!this->str.empty())
         {
-            if (str[0] == '-')
+            if (this->str[0] == '-')
             {
                 this->str.erase(0,1);
             
@@ -249,15 +275,16 @@ Number::Number(const std::string& str, double value) :
  * @param str The string representation of the number.
  * @param value The numeric value (integer).
  */
-Number::Number(const std::string& str, int value) :
-    Token(TokenType::NUMBER, str), value(value), type(NumberType::INTEGER) {
+Number::Number(std::string str, int value) :
+    Token(TokenType::NUMBER, std::move(str)), value(value),
+    type(NumberType::INTEGER) {
         
     if (value < 0)
     {
         this->flipSign();
-        if (!str.empty())
+        if (!this->str.empty())
         {
-            if (str[0] == '-')
+            if (this->str[0] == '-')
             {
                 this->str.erase(0,1);
             
@@ -317,19 +344,39 @@ double Number::getDouble() const
 void Number::flipSign() {
     this->setNegative(!this->isNegative());
 }
+
+std::shared_ptr<Token> Number::clone() const
+{
+    return std::make_shared<Number>(*this);
+}
 LeftParenthesis::LeftParenthesis() : Token(TokenType::LEFTPAREN, "(") {};
 
+std::shared_ptr<Token> LeftParenthesis::clone() const
+{
+    return std::make_shared<LeftParenthesis>(*this);
+}
 
 RightParenthesis::RightParenthesis() : Token(TokenType::RIGHTPAREN, ")") {};
 
-Variable::Variable(const std::string& str) : Token(TokenType::VARIABLE, str) {};
+std::shared_ptr<Token> RightParenthesis::clone() const
+{
+    return std::make_shared<RightParenthesis>(*this);
+}
+
+Variable::Variable(std::string str) :
+    Token(TokenType::VARIABLE, std::move(str)) {};
+
+std::shared_ptr<Token> Variable::clone() const
+{
+    return std::make_shared<Variable>(*this);
+}
 
 void Variable::setSubscript(std::string substr)
 {
-    this->subscript = substr;
+    this->subscript = std::move(substr);
 }
 
-std::string Variable::getSubscript()
+const std::string& Variable::getSubscript() const
 {
     return this->subscript;
 }
@@ -349,13 +396,13 @@ std::string Variable::getFullStr()
 }
 
 
-bool Variable::equals(std::shared_ptr<Token> other)
+bool Variable::equals(const std::shared_ptr<Token>& other) const
 {
     if (other->getType() != TokenType::VARIABLE)
     {
         return false;
     }
-    auto otherVar = std::dynamic_pointer_cast<Variable>(other);
+    auto otherVar = dynamic_cast<const Variable*>(other.get());
     bool same = (this->getStr() == otherVar->getStr());
     if (same)
     {
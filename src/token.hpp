@@ -59,15 +59,18 @@ public:
     /**
      * @brief Default constructor for SymbolProperties.
      */
-    SymbolProperties();
+    constexpr SymbolProperties() : precedence(-1),
+        associativity(Associativity::LEFT), commutative(false) {}
 
     /**
      * @brief Constructs SymbolProperties with a precedence and associativity.
      * @param precedence The precedence of the operator.
      * @param associativity The associativity of the operator.
      */
-    SymbolProperties(int precedence, Associativity associativity, 
-                                                    bool commutative);
+    constexpr SymbolProperties(int precedence, Associativity associativity,
+                                                    bool commutative) :
+        precedence(precedence), associativity(associativity),
+        commutative(commutative) {}
 
     int precedence;                 //!< The precedence of the operator
     Associativity associativity;    //!< Associativity of the operator
@@ -87,14 +90,25 @@ protected:
     //! Properties of the token
     SymbolProperties properties;
     bool negative; 
+    //! Set for tokens handed out by TokenPool, which must never change
+    bool pooled;
+
+    friend class TokenPool;
 
 public:
     /**
      * @brief Constructs a Token with a type and a string representation.
      * @param type The type of the token.
-     * @param str The string representation of the token.
+     * @param str The string representation of the token, moved in.
+     */
+    Token(TokenType type, std::string str);
+
+    /**
+     * @brief Copies the token. The copy is never pooled, so clones of
+     * shared tokens can be changed freely.
      */
-    Token(TokenType type, const std::string& str);
+    Token(const Token& other);
+    Token& operator=(const Token& other) = default;
 
     virtual ~Token() = default;
 
@@ -106,9 +120,10 @@ public:
 
     /**
      * @brief Returns the string representation of the token.
-     * @return The string representation of the token.
+     * @return The string representation of the token, valid while the
+     * token lives.
      */
-    std::string getStr() const;
+    const std::string& getStr() const;
 
     /**
      * @brief Returns the complete string representation of the token.
@@ -143,6 +158,7 @@ public:
      * @brief sets the isNegative flag to indicate this token represents a 
      * negative value.
      * @param value The value to set isNegative to.
+     * @throws std::runtime_error if the token is shared through TokenPool
      */
     void setNegative(bool value);
 
@@ -153,6 +169,15 @@ public:
     bool isNegative() const;
 
     void flipSign();
+
+    //! Whether the token is shared through TokenPool
+    bool isPooled() const;
+
+    /**
+     * @brief Creates an independent copy of the token.
+     * @return A new token of the same dynamic type.
+     */
+    virtual std::shared_ptr<Token> clone() const;
 };
 
 
@@ -171,8 +196,8 @@ public:
      * and properties.
      * @param str The string representation of the operator.
      */
-    Operator(const std::string& str);
-    
+    Operator(std::string str);
+    std::shared_ptr<Token> clone() const override;
 };
 
 
@@ -190,11 +215,12 @@ public:
      * @param str The string representation of the function.
      * @param properties The properties of the function.
      */
-    Variable(const std::string& str);
+    Variable(std::string str);
     void setSubscript(std::string substr);
-    std::string getSubscript();
+    const std::string& getSubscript() const;
     std::string getFullStr() override;
-    bool equals(std::shared_ptr<Token> other);
+    bool equals(const std::shared_ptr<Token>& other) const;
+    std::shared_ptr<Token> clone() const override;
 };
 
 /**
@@ -216,7 +242,7 @@ public:
      * @param str The string representation of the number.
      * @param value The double value of the number.
      */
-    Number(const std::string& str, double value);
+    Number(std::string str, double value);
 
     /**
      * @brief Constructs a Number with a string representation and
@@ -224,7 +250,7 @@ public:
      * @param str The string representation of the number.
      * @param value The integer value of the number.
      */
-    Number(const std::string& str, int value);
+    Number(std::string str, int value);
 
     //! Checks if the number token is an integer.
     bool isInt() const;
@@ -249,6 +275,7 @@ public:
 
     bool equals(int other);
     bool equals(double other);
+    std::shared_ptr<Token> clone() const override;
 
     
 
@@ -276,21 +303,20 @@ public:
      * @brief Constructs a Function with a string representation and properties.
      * @param str The string representation of the function.
      */
-    Function(const std::string& str);
+    Function(std::string str);
     void setSubscript(std::shared_ptr<Number> base);
 
     void setSubExpr(std::shared_ptr<TokenQueue> queue);
     void setSubExprTree(std::shared_ptr<ExpressionNode> root);
     void setExponent(std::shared_ptr<TokenQueue> queue);
     
-    std::shared_ptr<Number> getSubscript();
-    std::shared_ptr<TokenQueue> getExponent();
+    const std::shared_ptr<Number>& getSubscript() const;
+    const std::shared_ptr<TokenQueue>& getExponent() const;
     
-    std::shared_ptr<TokenQueue> getSubExpr();
-    std::shared_ptr<ExpressionNode> getSubExprTree();
+    const std::shared_ptr<TokenQueue>& getSubExpr() const;
+    const std::shared_ptr<ExpressionNode>& getSubExprTree() const;
     std::string getFullStr() override;
-
-    
+    std::shared_ptr<Token> clone() const override;
 };
 
 /**
@@ -303,6 +329,7 @@ public:
      * @brief Constructs a '(' token
      */
     LeftParenthesis();
+    std::shared_ptr<Token> clone() const override;
 };
 
 /**
@@ -315,6 +342,7 @@ public:
      * @brief Constructs a '(' token
      */
     RightParenthesis();
+    std::shared_ptr<Token> clone() const override;
 };
 
 #endif // __TOKEN_HPP__
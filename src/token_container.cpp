@@ -2,7 +2,7 @@
 
 TokenContainer::TokenContainer(std::vector<std::shared_ptr<Token>> input)
 {
-    this->container = input;
+    this->container = std::move(input);
 }
 
 
@@ -91,7 +91,7 @@ void TokenContainer::removeParens()
     }
 }
 
-std::vector<std::shared_ptr<Token>> TokenContainer::getVector() const
+const std::vector<std::shared_ptr<Token>>& TokenContainer::getVector() const
 {
     return this->container;
 }
\ No newline at end of file
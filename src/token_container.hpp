@@ -19,6 +19,10 @@ protected:
    
 public:
     TokenContainer() = default;
+    TokenContainer(const TokenContainer& other) = default;
+    TokenContainer(TokenContainer&& other) = default;
+    TokenContainer& operator=(const TokenContainer& other) = default;
+    TokenContainer& operator=(TokenContainer&& other) = default;
     TokenContainer(std::shared_ptr<TokenContainer> container);
     TokenContainer(std::vector<std::shared_ptr<Token>> input);
     
@@ -29,7 +33,7 @@ public:
     int size();
     bool empty();
     void removeParens();
-    std::vector<std::shared_ptr<Token>> getVector() const;
+    const std::vector<std::shared_ptr<Token>>& getVector() const;
     
     std::string toString();
     
@@ -0,0 +1,63 @@
+#include "token_pool.hpp"
+
+#include <array>
+#include <stdexcept>
+
+template <typename T>
+std::shared_ptr<T> TokenPool::share(std::shared_ptr<T> token)
+{
+    token->pooled = true;
+    return token;
+}
+
+std::shared_ptr<Number> TokenPool::make(int value)
+{
+    // Number keeps the magnitude and a sign flag
+    int magnitude = value < 0 ? -value : value;
+    auto out = std::make_shared<Number>(std::to_string(magnitude), magnitude);
+    if (value < 0)
+    {
+        out->flipSign();
+    }
+    return out;
+}
+
+std::shared_ptr<Number> TokenPool::number(int value)
+{
+    if (value < MIN_INTEGER || value > MAX_INTEGER)
+    {
+        return make(value);
+    }
+    // Built on first use, after the lookup tables Token depends on
+    static const auto integers = []() {
+        std::array<std::shared_ptr<Number>, MAX_INTEGER - MIN_INTEGER + 1>
+                                                                        out;
+        for (int idx = MIN_INTEGER; idx <= MAX_INTEGER; idx++)
+        {
+            out[idx - MIN_INTEGER] = share(make(idx));
+        }
+        return out;
+    }();
+    return integers[value - MIN_INTEGER];
+}
+
+std::shared_ptr<Operator> TokenPool::op(const std::string& str)
+{
+    static const std::string symbols = "+-*/^";
+    static const auto operators = []() {
+        std::array<std::shared_ptr<Operator>, 5> out;
+        for (int idx = 0; idx < out.size(); idx++)
+        {
+            out[idx] = share(std::make_shared<Operator>(
+                                            std::string(1, symbols[idx])));
+        }
+        return out;
+    }();
+    std::size_t idx = str.size() == 1 ? symbols.find(str[0]) :
+                                                        std::string::npos;
+    if (idx == std::string::npos)
+    {
+        throw std::runtime_error("No pooled operator " + str);
+    }
+    return operators[idx];
+}
@@ -0,0 +1,44 @@
+#ifndef __TOKEN_POOL_HPP__
+#define __TOKEN_POOL_HPP__
+
+#include "token.hpp"
+
+#include <memory>
+#include <string>
+
+/**
+ * @brief Shared, immutable tokens for the constants and operators that
+ * the derivative rules and simplifier create over and over.
+ *
+ * @details Pooled tokens are created once per process and handed out to
+ * any number of nodes. Changing the sign of one throws, so code that
+ * needs a negated copy clones it first (clones are never pooled).
+ * Function tokens are not pooled: each one owns its argument tree.
+ */
+class TokenPool
+{
+public:
+    //! Smallest and largest integer kept in the pool
+    static const int MIN_INTEGER = -1;
+    static const int MAX_INTEGER = 16;
+
+    /**
+     * @brief The pooled integer, or a new Number outside
+     * [MIN_INTEGER, MAX_INTEGER].
+     */
+    static std::shared_ptr<Number> number(int value);
+
+    /**
+     * @brief The pooled operator, one of + - * / ^.
+     *
+     * @throws std::runtime_error for any other string
+     */
+    static std::shared_ptr<Operator> op(const std::string& str);
+
+private:
+    static std::shared_ptr<Number> make(int value);
+    template <typename T>
+    static std::shared_ptr<T> share(std::shared_ptr<T> token);
+};
+
+#endif // __TOKEN_POOL_HPP__
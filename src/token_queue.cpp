@@ -2,9 +2,7 @@
 #include "token_vector.hpp"
 
 TokenQueue::TokenQueue(TokenContainer container)
-{
-    this->container = container.getVector();
-}
+    : TokenContainer(std::move(container)) {}
 
 TokenQueue::TokenQueue(const TokenVector& tokenVector)
     : TokenContainer(tokenVector.getVector()) {}
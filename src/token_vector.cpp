@@ -5,7 +5,7 @@
 
 
 TokenVector::TokenVector(TokenContainer input)
-    : TokenContainer(input) {}
+    : TokenContainer(std::move(input)) {}
 
 TokenVector::TokenVector(const TokenQueue& tokenQueue)
     : TokenContainer(tokenQueue.getVector()) {}
@@ -11,6 +11,8 @@
 #include "token_queue.hpp"
 #include "lookup.hpp"
 
+#include <charconv>
+#include <limits>
 #include <stdexcept>
 #include <iostream>
 
@@ -52,13 +54,22 @@ Tokenizer::Tokenizer(const std::string& input) : input(input)
 }
 
 TokenVector Tokenizer::tokenize()
+{
+    return this->tryTokenize().orThrow();
+}
+
+Result<TokenVector> Tokenizer::tryTokenize()
 {
 
     this->parseExpression();
+    if (this->failed())
+    {
+        return Error{Error::Code::SYNTAX, this->error};
+    }
 
 
-    for (this->tokensIdx = 0; this->tokensIdx < this->output.size();
-                                                    this->tokensIdx++)
+    for (this->tokensIdx = 0; this->tokensIdx < this->output.size() &&
+                                    !this->failed(); this->tokensIdx++)
     {
 
         if (this->currentToken()->getType() == TokenType::VARIABLE &&
@@ -82,6 +93,10 @@ TokenVector Tokenizer::tokenize()
         if (this->currentToken()->getType() == TokenType::FUNCTION)
         {
             this->handleFunction();
+            if (this->failed())
+            {
+                break;
+            }
         
             std::shared_ptr<Function> func =
                 std::dynamic_pointer_cast<Function>(this->currentToken());
@@ -98,9 +113,27 @@ TokenVector Tokenizer::tokenize()
             }
         }
     }
+    if (this->failed())
+    {
+        return Error{Error::Code::SYNTAX, this->error};
+    }
     this->nextImplicit(this->output);
-    return this->output;
+    return std::move(this->output);
+}
+
+void Tokenizer::fail(const std::string& message)
+{
+    if (this->error.empty())
+    {
+        this->error = message;
+    }
+}
+
+bool Tokenizer::failed() const
+{
+    return !this->error.empty();
 }
+
 std::shared_ptr<Token> Tokenizer::currentToken()
 {
     return this->output[this->tokensIdx];
@@ -157,6 +190,10 @@ void Tokenizer::parseExpression()
             this->clearSubstr();
             this->output.emplace_back(
                     std::make_shared<Number>(this->parseNumber()));
+            if (this->failed())
+            {
+                return;
+            }
 
         }
         else if (this->currentChar == ' ')
@@ -224,41 +261,78 @@ void Tokenizer::handleUnary()
     }
 
 }
+/**
+ * @brief Moves past a run of digits
+ * @param cursor First character to look at
+ * @param end End of the input
+ * @return The first character that is not a digit
+ */
+static const char* skipDigits(const char* cursor, const char* end)
+{
+    while (cursor != end && *cursor >= '0' && *cursor <= '9')
+    {
+        cursor++;
+    }
+    return cursor;
+}
+
 Number Tokenizer::parseNumber()
 {
-    std::string numberStr;
+    const char* begin = this->input.data() + this->currentIndex;
+    const char* end = this->input.data() + this->len;
     bool hasDecimalPoint = false;
     bool sciNotation = false;
 
-    while ((this->currentChar >= '0' && this->currentChar <= '9'))
+    const char* cursor = skipDigits(begin, end);
+    if (cursor != end && *cursor == '.')
     {
-        numberStr += this->currentChar;
-        if (this->peek() == '.')
+        hasDecimalPoint = true;
+        cursor = skipDigits(cursor + 1, end);
+        if (cursor != end && *cursor == '.')
         {
-            if (!hasDecimalPoint)
-            {
-                hasDecimalPoint = true;
-                numberStr += this->peek();
-                this->getNext();
-            }
-            else
-            {
-                throw std::runtime_error("Multiple decimal points in number");
-            }
+            this->fail("Multiple decimal points in number");
+            return Number("0", 0);
         }
-        this->getNext();
     }
+    // Only an 'e' followed by digits is an exponent, "2e" alone is 2*e
+    if (cursor != end && (*cursor == 'e' || *cursor == 'E'))
+    {
+        const char* exponent = cursor + 1;
+        if (exponent != end && (*exponent == '+' || *exponent == '-'))
+        {
+            exponent++;
+        }
+        if (exponent != end && *exponent >= '0' && *exponent <= '9')
+        {
+            sciNotation = true;
+            cursor = skipDigits(exponent, end);
+        }
+    }
+
+    this->currentIndex = cursor - this->input.data();
+    this->currentChar = (cursor == end) ? '\0' : *cursor;
+    std::string numberStr(begin, cursor);
 
-    if (hasDecimalPoint)
+    if (!hasDecimalPoint && !sciNotation)
     {
-        double value = std::stod(numberStr); // Convert to double
-        return Number(numberStr, value);
+        long long value = 0;
+        auto result = std::from_chars(begin, cursor, value);
+        if (result.ec == std::errc() &&
+                        value <= std::numeric_limits<int>::max())
+        {
+            return Number(numberStr, static_cast<int>(value));
+        }
+        // Too wide for an int: fall through and keep it as a double
     }
-    else
+
+    double value = 0;
+    auto result = std::from_chars(begin, cursor, value);
+    if (result.ec == std::errc::result_out_of_range)
     {
-        int value = std::stoi(numberStr); // Convert to integer
-        return Number(numberStr, value);
+        this->fail("Number out of range: " + numberStr);
+        return Number("0", 0);
     }
+    return Number(numberStr, value);
 }
 
 void Tokenizer::clearSubstr()
@@ -324,28 +398,28 @@ void Tokenizer::checkSubstr()
         }
 
         // Process the matched string as a function/operator
-        auto match = Lookup::symbolTable[matchedString];
-        if (match.first == TokenType::FUNCTION)
+        const SymbolEntry* match = Lookup::findSymbol(matchedString);
+        if (match->type == TokenType::FUNCTION)
         {
             this->output.emplace_back(
                                 std::make_shared<Function>(matchedString));
 
         }
-        else if (match.first == TokenType::OPERATOR)
+        else if (match->type == TokenType::OPERATOR)
         {
             this->output.emplace_back(
                                 std::make_shared<Operator>(matchedString));
         }
-        else if (match.first == TokenType::LEFTPAREN)
+        else if (match->type == TokenType::LEFTPAREN)
         {
             this->output.emplace_back(std::make_shared<LeftParenthesis>());
         }
-        else if (match.first == TokenType::UNDERSCORE)
+        else if (match->type == TokenType::UNDERSCORE)
         {
             this->output.emplace_back(
                         std::make_shared<Token>(TokenType::UNDERSCORE, "_"));
         }
-        else if (match.first == TokenType::RIGHTPAREN)
+        else if (match->type == TokenType::RIGHTPAREN)
             this->output.emplace_back(std::make_shared<RightParenthesis>());
         // Remove processed part from this->substr
         this->substr.erase(0, lastMatchedIndex + 1);
@@ -404,15 +478,20 @@ void Tokenizer::handleFunction()
                     std::string errorMsg =
                         "Only log function can have subscript, not \"" +
                         func->getStr() + "\"!";
-                    throw std::runtime_error(errorMsg.c_str());
+                    this->fail(errorMsg);
+                    return;
                 }
                 int underscoreIdx = this->tokensIdx++;
                 if (this->tokensIdx == this->output.size())
                 {
-                    throw std::runtime_error("No subscript found!");
+                    this->fail("No subscript found!");
                     return;
                 }
                 subScript = this->getSubTokens();
+                if (this->failed())
+                {
+                    return;
+                }
                 if (subScript->size() == 1 &&
                         subScript->top()->getType() == TokenType::NUMBER)
                 {
@@ -422,8 +501,9 @@ void Tokenizer::handleFunction()
                 }
                 else
                 {
-                    throw std::runtime_error(
+                    this->fail(
                         "Bad subscript! logarithm must have numeric base");
+                    return;
                 }
 
                 this->output.erase(underscoreIdx, this->tokensIdx + 1);
@@ -436,9 +516,14 @@ void Tokenizer::handleFunction()
                 int exponentIdx = this->tokensIdx++;
 
                 exponent = this->getSubTokens();
+                if (this->failed())
+                {
+                    return;
+                }
                 if (exponent->size() == 0)
                 {
-                    throw std::runtime_error("No exponent found!");
+                    this->fail("No exponent found!");
+                    return;
                 }
                 func->setExponent(exponent);
                 this->output.erase(exponentIdx, this->tokensIdx + 1);
@@ -446,6 +531,10 @@ void Tokenizer::handleFunction()
             }
         }
         subExpr = this->getSubTokens();
+        if (this->failed())
+        {
+            return;
+        }
 
 
 
@@ -484,6 +573,10 @@ std::shared_ptr<TokenQueue> Tokenizer::getSubTokens()
         if (token->getType() == TokenType::FUNCTION)
         {
             this->handleFunction();
+            if (this->failed())
+            {
+                return subExpr;
+            }
         }
         subExpr->push(token);
         // Check for left parenthesis and increment the count
@@ -520,7 +613,23 @@ std::shared_ptr<TokenQueue> Tokenizer::getSubTokens()
 
 void Tokenizer::handleVariable()
 {
-    std::shared_ptr<Token>& token = this->output[this->tokensIdx];
+    // a_1 or a_b: the token after the underscore becomes the subscript
+    if (this->tokensIdx + 2 >= this->output.size() ||
+        this->output[this->tokensIdx + 1]->getType() != TokenType::UNDERSCORE)
+    {
+        return;
+    }
+    std::shared_ptr<Token> subscript = this->output[this->tokensIdx + 2];
+    if (subscript->getType() != TokenType::NUMBER &&
+                            subscript->getType() != TokenType::VARIABLE)
+    {
+        this->fail("Invalid variable subscript: " + subscript->getFullStr());
+        return;
+    }
+    auto var = std::dynamic_pointer_cast<Variable>(this->currentToken());
+    var->setSubscript(subscript->getStr());
+    this->output.erase(this->tokensIdx + 1);
+    this->output.erase(this->tokensIdx + 1);
 }
 void Tokenizer::handleSubscript()
 {
@@ -566,11 +675,11 @@ void Tokenizer::nextImplicit(TokenVector& vec)
         if (currentType == TokenType::FUNCTION)
         {
             auto func = std::dynamic_pointer_cast<Function>(token);
-            TokenVector vec(func->getSubExpr());
-            this->nextImplicit(vec);
+            TokenVector subVec(func->getSubExpr());
+            this->nextImplicit(subVec);
             
 
-            func->setSubExpr(std::make_shared<TokenQueue>(vec));
+            func->setSubExpr(std::make_shared<TokenQueue>(subVec));
             vec[implicitIdx] = func;
 
         }
@@ -579,15 +688,9 @@ void Tokenizer::nextImplicit(TokenVector& vec)
             break;
         }
         TokenType nextType = vec[implicitIdx + 1]->getType();
-        if (Lookup::implicitMultiplication.find(
-            {currentType, nextType })
-                != Lookup::implicitMultiplication.end())
+        if (Lookup::isImplicit(currentType, nextType))
         {
-            if (Lookup::implicitMultiplication[{currentType, nextType}])
-            {
-                vec.emplace(implicitIdx + 1,
-                                    std::make_shared<Operator>("*"));
-            }
+            vec.emplace(implicitIdx + 1, std::make_shared<Operator>("*"));
         }
         
     }
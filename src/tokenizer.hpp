@@ -13,6 +13,7 @@
 #include "MWT.hpp"
 #include "token_queue.hpp"
 #include "token_vector.hpp"
+#include "result.hpp"
 
 #include <memory>
 #include <vector>
@@ -33,9 +34,16 @@ public:
 
     /**
      * @brief Tokenizes the input string into a vector of Tokens.
-     * @return A vector of Token objects.
+     * @return A vector of Token objects, moved out: tokenize once per
+     * Tokenizer.
+     * @throws std::runtime_error On input that cannot be tokenized.
      */
     TokenVector tokenize();
+
+    /**
+     * @brief tokenize() that returns a SYNTAX error instead of throwing.
+     */
+    Result<TokenVector> tryTokenize();
     //DEBUG START
     std::string listOutput();
     //DEBUG END
@@ -58,6 +66,16 @@ private:
     TokenVector output;
     int tokensIdx;
 
+    //! First error found, empty while the input is valid
+    std::string error;
+
+    /**
+     * @brief Records message unless an earlier error was recorded. The
+     * caller returns, and so does every caller up to tryTokenize().
+     */
+    void fail(const std::string& message);
+    bool failed() const;
+
 
     /**
      * @brief Peeks at the next character in the input string without
@@ -106,7 +124,11 @@ private:
     void nextImplicit(TokenVector& vec);
     /**
      * @brief Parses a number token from the input string.
-     * @return The parsed Number token.
+     *
+     * Scans the input buffer in place and accepts an exponent such as
+     * 1.2345e-07. Integers too wide for an int become doubles.
+     * @return The parsed Number token, 0 after a fail() on a second
+     * decimal point or a value out of double range.
      */
     Number parseNumber();
 
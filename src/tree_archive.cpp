@@ -0,0 +1,449 @@
+#include "tree_archive.hpp"
+#include "derivative.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char MAGIC[8] = {'S', 'Y', 'M', 'T', 'R', 'E', 'E', '\0'};
+const std::uint32_t ORDER_MARKER = 0x01020304;
+const std::size_t FILE_HEADER = 32;
+const std::size_t TREE_HEADER = 16;
+
+void TreeArchive::append(std::string& out, const void* data, std::size_t size)
+{
+    out.append(static_cast<const char*>(data), size);
+}
+
+void TreeArchive::pad(std::string& out)
+{
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+TreeArchive::TreeArchive(const std::string& path)
+    : data(nullptr), bytes(0), mapped(false)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Cannot open archive " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot read archive " + path);
+    }
+    void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map archive " + path);
+    }
+    this->data = static_cast<const char*>(map);
+    this->bytes = info.st_size;
+    this->mapped = true;
+    try
+    {
+        this->open();
+    }
+    catch (...)
+    {
+        munmap(map, this->bytes);
+        throw;
+    }
+}
+
+TreeArchive::TreeArchive(const char* data, std::size_t size)
+    : data(data), bytes(size), mapped(false)
+{
+    if (reinterpret_cast<std::uintptr_t>(data) % 8 != 0)
+    {
+        throw std::runtime_error("Archive data must be 8-byte aligned");
+    }
+    this->open();
+}
+
+TreeArchive::~TreeArchive()
+{
+    if (this->mapped)
+    {
+        munmap(const_cast<char*>(this->data), this->bytes);
+    }
+}
+
+void TreeArchive::open()
+{
+    if (this->bytes < FILE_HEADER ||
+                    std::memcmp(this->data, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw std::runtime_error("Not a tree archive");
+    }
+    std::uint32_t version;
+    std::uint32_t order;
+    std::uint64_t count;
+    std::memcpy(&version, this->data + 8, sizeof(version));
+    std::memcpy(&order, this->data + 12, sizeof(order));
+    std::memcpy(&count, this->data + 16, sizeof(count));
+    if (version != VERSION)
+    {
+        throw std::runtime_error("Unsupported tree archive version " +
+                                                    std::to_string(version));
+    }
+    if (order != ORDER_MARKER)
+    {
+        throw std::runtime_error("Tree archive was written with a different "
+                                                                "byte order");
+    }
+    if (count > (this->bytes - FILE_HEADER) / sizeof(std::uint64_t))
+    {
+        throw std::runtime_error("Truncated tree archive");
+    }
+    const auto* offsets = reinterpret_cast<const std::uint64_t*>(
+                                                this->data + FILE_HEADER);
+    this->views.clear();
+    this->views.reserve(count);
+    for (std::uint64_t idx = 0; idx < count; idx++)
+    {
+        this->views.push_back(this->readTree(offsets[idx]));
+    }
+}
+
+TreeArchive::View TreeArchive::readTree(std::uint64_t offset) const
+{
+    if (offset % 8 != 0 || offset > this->bytes ||
+                                        this->bytes - offset < TREE_HEADER)
+    {
+        throw std::runtime_error("Corrupt tree archive: bad tree offset");
+    }
+    const auto* header = reinterpret_cast<const std::uint32_t*>(
+                                                        this->data + offset);
+    std::uint64_t entries = header[0];
+    std::uint64_t variables = header[1];
+    std::uint64_t strings = header[2];
+    std::uint64_t poolBytes = header[3];
+    std::uint64_t stringCount = strings + 2 * variables;
+    std::uint64_t need = TREE_HEADER + entries * sizeof(double) +
+                        4 * entries * sizeof(std::int32_t) +
+                        (stringCount + 1) * sizeof(std::uint32_t) +
+                        entries + poolBytes;
+    if (entries == 0 || need > this->bytes - offset)
+    {
+        throw std::runtime_error("Corrupt tree archive: truncated tree");
+    }
+
+    View view;
+    view.entries = entries;
+    view.variables = variables;
+    view.strings = strings;
+    const char* cursor = this->data + offset + TREE_HEADER;
+    view.values = reinterpret_cast<const double*>(cursor);
+    cursor += entries * sizeof(double);
+    view.lefts = reinterpret_cast<const std::int32_t*>(cursor);
+    view.rights = view.lefts + entries;
+    view.firsts = view.rights + entries;
+    view.symbols = view.firsts + entries;
+    cursor += 4 * entries * sizeof(std::int32_t);
+    view.stringOffsets = reinterpret_cast<const std::uint32_t*>(cursor);
+    cursor += (stringCount + 1) * sizeof(std::uint32_t);
+    view.opcodes = reinterpret_cast<const OpCode*>(cursor);
+    view.pool = cursor + entries;
+
+    for (std::uint64_t idx = 0; idx < stringCount; idx++)
+    {
+        if (view.stringOffsets[idx] > view.stringOffsets[idx + 1])
+        {
+            throw std::runtime_error("Corrupt tree archive: bad string table");
+        }
+    }
+    if (view.stringOffsets[0] != 0 ||
+                                view.stringOffsets[stringCount] != poolBytes)
+    {
+        throw std::runtime_error("Corrupt tree archive: bad string table");
+    }
+
+    // Children must precede their parent, as evaluate relies on
+    for (int idx = 0; idx < view.entries; idx++)
+    {
+        auto code = static_cast<std::uint8_t>(view.opcodes[idx]);
+        int left = view.lefts[idx];
+        int right = view.rights[idx];
+        int symbol = view.symbols[idx];
+        // Sub-trees span firsts[idx]..idx, as hasVariable relies on
+        bool valid = code <= static_cast<std::uint8_t>(OpCode::SQRT) &&
+                        view.firsts[idx] >= 0 && view.firsts[idx] <= idx;
+        if (code <= static_cast<std::uint8_t>(OpCode::REAL))
+        {
+            valid = valid && symbol >= -1 && symbol < view.strings;
+        }
+        else if (view.opcodes[idx] == OpCode::VARIABLE)
+        {
+            valid = valid && symbol >= 0 && symbol < view.variables;
+        }
+        else if (code <= static_cast<std::uint8_t>(OpCode::POWER) &&
+                                        view.opcodes[idx] != OpCode::NEGATE)
+        {
+            valid = valid && left >= 0 && left < idx &&
+                                    right >= 0 && right < idx;
+        }
+        else
+        {
+            valid = valid && left >= 0 && left < idx &&
+                                    symbol >= -1 && symbol < view.strings;
+        }
+        if (!valid)
+        {
+            throw std::runtime_error("Corrupt tree archive: bad entry " +
+                                                        std::to_string(idx));
+        }
+    }
+    return view;
+}
+
+std::size_t TreeArchive::size() const
+{
+    return this->views.size();
+}
+
+TreeArchive::View TreeArchive::view(std::size_t idx) const
+{
+    if (idx >= this->views.size())
+    {
+        throw std::runtime_error("Tree archive index out of range");
+    }
+    return this->views[idx];
+}
+
+FlatTree TreeArchive::load(std::size_t idx) const
+{
+    View view = this->view(idx);
+    FlatTree out;
+    out.opcodes.assign(view.opcodes, view.opcodes + view.entries);
+    out.lefts.assign(view.lefts, view.lefts + view.entries);
+    out.rights.assign(view.rights, view.rights + view.entries);
+    out.firsts.assign(view.firsts, view.firsts + view.entries);
+    out.values.assign(view.values, view.values + view.entries);
+    out.symbols.assign(view.symbols, view.symbols + view.entries);
+    for (int str = 0; str < view.strings; str++)
+    {
+        out.strings.emplace_back(view.string(str));
+    }
+    for (int slot = 0; slot < view.variables; slot++)
+    {
+        auto var = std::make_shared<Variable>(
+                                std::string(view.getVariableName(slot)));
+        var->setSubscript(std::string(view.getVariableSubscript(slot)));
+        out.variables.push_back(var);
+    }
+    return out;
+}
+
+std::shared_ptr<ExpressionNode> TreeArchive::thaw(std::size_t idx) const
+{
+    return this->load(idx).thaw();
+}
+
+std::string TreeArchive::serialize(const std::vector<FlatTree>& trees)
+{
+    std::string out;
+    std::uint32_t version = VERSION;
+    std::uint64_t count = trees.size();
+    std::uint64_t reserved = 0;
+    append(out, MAGIC, sizeof(MAGIC));
+    append(out, &version, sizeof(version));
+    append(out, &ORDER_MARKER, sizeof(ORDER_MARKER));
+    append(out, &count, sizeof(count));
+    append(out, &reserved, sizeof(reserved));
+    std::size_t offsetTable = out.size();
+    out.append(count * sizeof(std::uint64_t), '\0');
+
+    for (std::size_t idx = 0; idx < trees.size(); idx++)
+    {
+        const FlatTree& tree = trees[idx];
+        if (tree.size() == 0)
+        {
+            throw std::runtime_error("Cannot serialize an empty tree");
+        }
+        pad(out);
+        std::uint64_t offset = out.size();
+        std::memcpy(&out[offsetTable + idx * sizeof(offset)], &offset,
+                                                            sizeof(offset));
+
+        std::vector<std::string> strings = tree.strings;
+        for (const auto& var : tree.variables)
+        {
+            strings.push_back(var->getStr());
+            strings.push_back(var->getSubscript());
+        }
+        std::vector<std::uint32_t> stringOffsets(1, 0);
+        std::string pool;
+        for (const auto& str : strings)
+        {
+            pool += str;
+            stringOffsets.push_back(pool.size());
+        }
+
+        std::uint32_t header[4] = {
+            static_cast<std::uint32_t>(tree.size()),
+            static_cast<std::uint32_t>(tree.variables.size()),
+            static_cast<std::uint32_t>(tree.strings.size()),
+            static_cast<std::uint32_t>(pool.size())};
+        std::size_t entries = tree.size();
+        append(out, header, sizeof(header));
+        append(out, tree.values.data(), entries * sizeof(double));
+        append(out, tree.lefts.data(), entries * sizeof(std::int32_t));
+        append(out, tree.rights.data(), entries * sizeof(std::int32_t));
+        append(out, tree.firsts.data(), entries * sizeof(std::int32_t));
+        append(out, tree.symbols.data(), entries * sizeof(std::int32_t));
+        append(out, stringOffsets.data(),
+                            stringOffsets.size() * sizeof(std::uint32_t));
+        append(out, tree.opcodes.data(), entries);
+        out += pool;
+    }
+    pad(out);
+    return out;
+}
+
+void TreeArchive::save(const std::string& path,
+                                        const std::vector<FlatTree>& trees)
+{
+    std::string encoded = serialize(trees);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Cannot write archive " + path);
+    }
+    file.write(encoded.data(), encoded.size());
+    if (!file)
+    {
+        throw std::runtime_error("Cannot write archive " + path);
+    }
+}
+
+std::vector<FlatTree> TreeArchive::differentiate(
+                const std::vector<std::string>& inputs, std::string wrt)
+{
+    auto var = Derivative::parseVariable(wrt);
+    std::vector<FlatTree> out;
+    out.reserve(2 * inputs.size());
+    for (const auto& input : inputs)
+    {
+        Tokenizer parser(input);
+        auto parsed = parser.tokenize();
+        ShuntingYard converter(parsed);
+        auto root = ExpressionNode::buildTree(converter.getPostfix());
+        if (!root)
+        {
+            throw std::runtime_error("Empty expression");
+        }
+        TreeFixer::checkTree(root);
+        root = TreeFixer::simplify(root);
+
+        Derivative engine(root, var);
+        engine.log.setEnabled(false);
+        out.emplace_back(root);
+        out.emplace_back(engine.solve());
+    }
+    return out;
+}
+
+std::string_view TreeArchive::View::string(int idx) const
+{
+    std::uint32_t begin = this->stringOffsets[idx];
+    return std::string_view(this->pool + begin,
+                                    this->stringOffsets[idx + 1] - begin);
+}
+
+int TreeArchive::View::size() const
+{
+    return this->entries;
+}
+
+OpCode TreeArchive::View::getOpCode(int idx) const
+{
+    return this->opcodes[idx];
+}
+
+int TreeArchive::View::getLeft(int idx) const
+{
+    return this->lefts[idx];
+}
+
+int TreeArchive::View::getRight(int idx) const
+{
+    return this->rights[idx];
+}
+
+int TreeArchive::View::getFirst(int idx) const
+{
+    return this->firsts[idx];
+}
+
+double TreeArchive::View::getValue(int idx) const
+{
+    return this->values[idx];
+}
+
+int TreeArchive::View::getSymbol(int idx) const
+{
+    return this->symbols[idx];
+}
+
+std::string_view TreeArchive::View::getString(int idx) const
+{
+    if (this->opcodes[idx] == OpCode::VARIABLE)
+    {
+        return this->getVariableName(this->symbols[idx]);
+    }
+    if (this->symbols[idx] == -1)
+    {
+        return std::string_view();
+    }
+    return this->string(this->symbols[idx]);
+}
+
+int TreeArchive::View::getVariableCount() const
+{
+    return this->variables;
+}
+
+std::string_view TreeArchive::View::getVariableName(int slot) const
+{
+    return this->string(this->strings + 2 * slot);
+}
+
+std::string_view TreeArchive::View::getVariableSubscript(int slot) const
+{
+    return this->string(this->strings + 2 * slot + 1);
+}
+
+int TreeArchive::View::getSlot(std::string_view name,
+                                        std::string_view subscript) const
+{
+    for (int slot = 0; slot < this->variables; slot++)
+    {
+        if (this->getVariableName(slot) == name &&
+                            this->getVariableSubscript(slot) == subscript)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+double TreeArchive::View::evaluate(const double* slots,
+                                        std::vector<double>& scratch) const
+{
+    scratch.resize(this->entries);
+    return FlatTree::evaluate(this->entries, this->opcodes, this->lefts,
+                            this->rights, this->values, this->symbols, slots,
+                            scratch.data());
+}
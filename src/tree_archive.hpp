@@ -0,0 +1,162 @@
+#ifndef __TREE_ARCHIVE_HPP__
+#define __TREE_ARCHIVE_HPP__
+
+#include "flat_tree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Versioned binary file of frozen expression trees.
+ *
+ * @details Each tree is stored as its FlatTree tables: the post-order node
+ * table as parallel arrays, followed by one string pool holding number
+ * and subscript text and the variable names. Every array starts at a
+ * suitably aligned offset, so a mapped file is used in place through a
+ * View, with no parsing and no allocation; load and thaw copy a tree back
+ * out when an owning FlatTree or ExpressionNode tree is needed.
+ *
+ * File layout, all integers in the writer's byte order:
+ *
+ *     char[8]  magic "SYMTREE"
+ *     u32      version
+ *     u32      byte-order marker 0x01020304
+ *     u64      tree count
+ *     u64      reserved
+ *     u64      offset of every tree block
+ *
+ * Tree block, 8-byte aligned:
+ *
+ *     u32      entries, variables, strings, pool bytes
+ *     f64      values[entries]
+ *     i32      lefts[entries], rights[entries], firsts[entries],
+ *              symbols[entries]
+ *     u32      string offsets[strings + 2 * variables + 1]
+ *     u8       opcodes[entries]
+ *     char     pool[pool bytes]
+ *
+ * The name and subscript of variable slot s are the strings
+ * strings + 2s and strings + 2s + 1.
+ */
+class TreeArchive
+{
+public:
+    static const std::uint32_t VERSION = 1;
+
+    /**
+     * @brief Read-only window on one stored tree.
+     *
+     * @details Only valid while the archive it came from is alive.
+     */
+    class View
+    {
+    public:
+        int size() const;
+        OpCode getOpCode(int idx) const;
+        int getLeft(int idx) const;
+        int getRight(int idx) const;
+        int getFirst(int idx) const;
+        double getValue(int idx) const;
+        int getSymbol(int idx) const;
+
+        /**
+         * @brief The stored text of a number entry, the subscript of a
+         * function entry or the name of a variable entry.
+         */
+        std::string_view getString(int idx) const;
+
+        int getVariableCount() const;
+        std::string_view getVariableName(int slot) const;
+        std::string_view getVariableSubscript(int slot) const;
+
+        /**
+         * @brief Slot of a variable, -1 when the tree does not use it.
+         */
+        int getSlot(std::string_view name,
+                                    std::string_view subscript = "") const;
+
+        /**
+         * @brief Same as FlatTree::evaluate on the stored tables.
+         */
+        double evaluate(const double* slots,
+                                        std::vector<double>& scratch) const;
+
+    private:
+        friend class TreeArchive;
+
+        int entries = 0;
+        int variables = 0;
+        int strings = 0;
+        const OpCode* opcodes = nullptr;
+        const double* values = nullptr;
+        const std::int32_t* lefts = nullptr;
+        const std::int32_t* rights = nullptr;
+        const std::int32_t* firsts = nullptr;
+        const std::int32_t* symbols = nullptr;
+        const std::uint32_t* stringOffsets = nullptr;
+        const char* pool = nullptr;
+
+        std::string_view string(int idx) const;
+    };
+
+    /**
+     * @brief Maps an archive file read-only.
+     */
+    explicit TreeArchive(const std::string& path);
+
+    /**
+     * @brief Reads an archive from memory owned by the caller, which must
+     * be 8-byte aligned and outlive the archive.
+     */
+    TreeArchive(const char* data, std::size_t size);
+
+    ~TreeArchive();
+    TreeArchive(const TreeArchive&) = delete;
+    TreeArchive& operator=(const TreeArchive&) = delete;
+
+    std::size_t size() const;
+    View view(std::size_t idx) const;
+
+    /**
+     * @brief Copies a stored tree into an owning FlatTree.
+     */
+    FlatTree load(std::size_t idx) const;
+
+    /**
+     * @brief Rebuilds a stored tree as an ExpressionNode tree.
+     */
+    std::shared_ptr<ExpressionNode> thaw(std::size_t idx) const;
+
+    /**
+     * @brief Encodes trees in the archive format.
+     */
+    static std::string serialize(const std::vector<FlatTree>& trees);
+
+    static void save(const std::string& path,
+                                        const std::vector<FlatTree>& trees);
+
+    /**
+     * @brief Parses and differentiates every input: tree 2i of the result
+     * is input i and tree 2i + 1 its derivative.
+     */
+    static std::vector<FlatTree> differentiate(
+                const std::vector<std::string>& inputs, std::string wrt);
+
+private:
+    const char* data;
+    std::size_t bytes;
+    //! Set when data is a mapping owned by the archive
+    bool mapped;
+    std::vector<View> views;
+
+    void open();
+    View readTree(std::uint64_t offset) const;
+    static void append(std::string& out, const void* data, std::size_t size);
+    //! Zero-fills out to the next multiple of 8 bytes
+    static void pad(std::string& out);
+};
+
+#endif // __TREE_ARCHIVE_HPP__
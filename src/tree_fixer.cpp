@@ -4,26 +4,63 @@
 #include "arithmetic.hpp"
 #include "text_converter.hpp"
 #include "lookup.hpp"
+#include "limit_guard.hpp"
+#include "operation.hpp"
+#include "equivalence.hpp"
+#include "token_pool.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <unordered_map>
+#include <utility>
 
 
 
 
 void TreeFixer::checkTree(nodePtr node)
+{
+    TreeFixer::tryCheckTree(node).orThrow();
+}
+
+void TreeFixer::checkTree(nodePtr node, nodeSet& settled)
+{
+    std::string error;
+    if (!TreeFixer::checkTree(node, &settled, error))
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+Result<std::shared_ptr<ExpressionNode>> TreeFixer::tryCheckTree(nodePtr node)
+{
+    std::string error;
+    if (!TreeFixer::checkTree(node, nullptr, error))
+    {
+        return Error{Error::Code::SYNTAX, error};
+    }
+    return node;
+}
+
+bool TreeFixer::checkTree(nodePtr node, nodeSet* settled, std::string& error)
 {
     
     if (!node)
     {
-        std::string msg = "Node is nullptr parent " +
-            node->getParent().lock()->getStr();
-        throw std::runtime_error(msg.c_str());
+        error = "Node is nullptr";
+        return false;
+    }
+    if (settled && settled->count(node))
+    {
+        return true;
     }
     if (node->getType() == TokenType::FUNCTION)
     {
         auto function = std::dynamic_pointer_cast<Function>(node->getToken());
-        TreeFixer::checkTree(function->getSubExprTree());
+        if (!TreeFixer::checkTree(function->getSubExprTree(), settled, error))
+        {
+            return false;
+        }
     }
 
     if (node->getType() != TokenType::NUMBER && node->getToken()->isNegative())
@@ -39,26 +76,39 @@ void TreeFixer::checkTree(nodePtr node)
     }
     if (node->getType() == TokenType::OPERATOR)
     {
-        TreeFixer::checkChildren(node);
+        if (!TreeFixer::checkChildren(node, error))
+        {
+            return false;
+        }
         if (!node->getLeft())
         {
-            std::string msg = "Operator " + node->getStr() + 
-            " is missing left child";
-            throw std::runtime_error(msg.c_str());
+            error = "Operator " + node->getStr() + " is missing left child";
+            return false;
+        }
+        if (!TreeFixer::checkTree(node->getLeft(), settled, error))
+        {
+            return false;
         }
-        TreeFixer::checkTree(node->getLeft());
         if (!node->getRight())
         {
-            std::string msg = "Operator " + node->getStr() + 
-            " is missing right child";
-            throw std::runtime_error(msg.c_str());
+            error = "Operator " + node->getStr() + " is missing right child";
+            return false;
         }
-        TreeFixer::checkTree(node->getRight());
+        return TreeFixer::checkTree(node->getRight(), settled, error);
     }
-
+    return true;
 }
 
 void TreeFixer::checkChildren(nodePtr node)
+{
+    std::string error;
+    if (!TreeFixer::checkChildren(node, error))
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+bool TreeFixer::checkChildren(nodePtr node, std::string& error)
 {
     
     auto left = node->getLeft();
@@ -66,17 +116,17 @@ void TreeFixer::checkChildren(nodePtr node)
 
     if (!left)
     {
-        std::string errMsg = "The node " + node->getToken()->getFullStr() +
+        error = "The node " + node->getToken()->getFullStr() +
             "has no left child\n";
-        throw std::runtime_error(errMsg.c_str());
+        return false;
     }
     if (!right)
     {
-        std::string errMsg = "The node " + node->getToken()->getFullStr() +
+        error = "The node " + node->getToken()->getFullStr() +
             "has no right child\n";
-        throw std::runtime_error(errMsg.c_str());
+        return false;
     }
-    
+    return true;
 }
 
 
@@ -84,103 +134,606 @@ void TreeFixer::checkChildren(nodePtr node)
 
 std::shared_ptr<ExpressionNode> TreeFixer::simplify(nodePtr node)
 {
-    ////std::cout << "\ninput: " << TextConverter::convertToText(node) << "\n";
-    auto left = node->getLeft();
-    auto right = node->getRight();
+    return TreeFixer::trySimplify(node).orThrow();
+}
+
+std::shared_ptr<ExpressionNode> TreeFixer::simplify(nodePtr node,
+                                                        nodeSet& settled)
+{
+    return TreeFixer::trySimplify(node, settled).orThrow();
+}
+
+Result<std::shared_ptr<ExpressionNode>> TreeFixer::trySimplify(nodePtr node)
+{
+    std::string error;
+    nodePtr out = TreeFixer::simplify(node, nullptr, error);
+    if (!out)
+    {
+        return Error{Error::Code::DOMAIN, error};
+    }
+    return out;
+}
+
+Result<std::shared_ptr<ExpressionNode>> TreeFixer::trySimplify(nodePtr node,
+                                                        nodeSet& settled)
+{
+    std::string error;
+    nodePtr out = TreeFixer::simplify(node, &settled, error);
+    if (!out)
+    {
+        return Error{Error::Code::DOMAIN, error};
+    }
+    return out;
+}
+
+std::shared_ptr<ExpressionNode> TreeFixer::simplify(nodePtr node,
+                                        nodeSet* settled, std::string& error)
+{
+    LimitGuard::Level level;
+    if (settled && settled->count(node))
+    {
+        return node;
+    }
+    if (isChain(node, true) || isChain(node, false))
+    {
+        return simplifyChain(node, isChain(node, true), settled, error);
+    }
+    // Nodes are never changed: a rewrite builds new nodes along the path
+    // to the change and shares every untouched sub-tree
+    nodePtr out = node;
+    // Whether checkTree leaves the children alone as well
+    bool checked = true;
     if (node->getType() == TokenType::OPERATOR)
     {
-        if (node->getRight()->getPrecedence() < 
-                node->getLeft()->getPrecedence())
+        // Operands keep the order they were written in; commutative ones
+        // are not reordered by precedence
+        auto left = node->getLeft();
+        auto right = node->getRight();
+        auto newLeft = simplify(left, settled, error);
+        if (!newLeft)
         {
-            if (node->getToken()->isCommutative())
-            {
-                node->swapChildren();
-                
-            }
+            return nullptr;
+        }
+        auto newRight = simplify(right, settled, error);
+        if (!newRight)
+        {
+            return nullptr;
         }
-        if (left)
+
+        if (newLeft != left || newRight != right)
         {
-            node->setLeft(simplify(left));
+            out = std::make_shared<ExpressionNode>(node->getToken());
+            out->setLeft(newLeft);
+            out->setRight(newRight);
         }
-        if (right)
+        error = Arithmetic::getDomainError(out);
+        if (!error.empty())
         {
-            node->setRight(simplify(right));
+            return nullptr;
         }
         if (node->getStr() == "^")
         {
-            Arithmetic::simplifyExponent(node);
+            Arithmetic::simplifyExponent(out);
         }
         else if (node->getStr() == "*")
         {
-            
-            
-            Arithmetic::simplifyMultiplication(node);
-            
-            
-            
+            Arithmetic::simplifyMultiplication(out);
         }
         else if (node->getStr() == "/")
         {
-            Arithmetic::simplifyDivision(node);
+            Arithmetic::simplifyDivision(out);
         }
         else if (node->getStr() == "+")
         {
-            Arithmetic::simplifyAddition(node);
+            Arithmetic::simplifyAddition(out);
         }
         else if (node->getStr() == "-")
         {
-            Arithmetic::simplifySubtraction(node);
+            Arithmetic::simplifySubtraction(out);
         }
-        
+        checked = settled && settled->count(left) && settled->count(right);
     }
-    if (node->getType() == TokenType::FUNCTION)
+    else if (node->getType() == TokenType::FUNCTION)
     {
         auto funcToken = std::dynamic_pointer_cast<Function>(node->getToken());
-        nodePtr newSubRoot = TreeFixer::simplify(funcToken->getSubExprTree());
-        
-        funcToken->setSubExprTree(newSubRoot);
-        auto funcIter = Lookup::functionLookup.find(node->getStr());
-        if (funcIter != Lookup::functionLookup.end())
+        nodePtr subRoot = funcToken->getSubExprTree();
+        nodePtr newSubRoot = TreeFixer::simplify(subRoot, settled, error);
+        if (!newSubRoot)
+        {
+            return nullptr;
+        }
+        if (newSubRoot != subRoot)
+        {
+            auto copy = std::make_shared<Function>(*funcToken);
+            copy->setSubExprTree(newSubRoot);
+            out = std::make_shared<ExpressionNode>(copy);
+        }
+
+        auto definition = Lookup::getFunction(node->getStr());
+        if (definition &&
+                                newSubRoot->getType() == TokenType::NUMBER)
         {
-            auto func = funcIter->second;
+            // The definition is shared per thread, point it at this node
+            definition->update(out);
+            auto arg = std::dynamic_pointer_cast<Number>(
+                                                    newSubRoot->getToken());
+            double result = definition->evaluate(arg->isInt() ?
+                                arg->getInt() * 1.0 : arg->getDouble());
+            if (std::fmod(result, 1) == 0 ||
+                                        Arithmetic::floatSimplification)
+            {
+                out = std::make_shared<ExpressionNode>(
+                        std::make_shared<Number>(std::to_string(result),
+                                                                    result));
+            }
+        }
+        checked = settled && settled->count(subRoot);
+    }
+    // Settled: unchanged here, and nothing for checkTree to expand
+    if (settled && out == node && checked &&
+            (node->getType() == TokenType::NUMBER ||
+                                        !node->getToken()->isNegative()))
+    {
+        settled->insert(node);
+    }
+    return out;
+}
+
+// -number, from a clone since pooled numbers never change sign
+static std::shared_ptr<Number> negated(const std::shared_ptr<Number>& number)
+{
+    if (number->equals(0))
+    {
+        return number;
+    }
+    auto out = std::dynamic_pointer_cast<Number>(number->clone());
+    out->flipSign();
+    return out;
+}
 
-             
-            func->update(node);
+static bool isBelowZero(const std::shared_ptr<Number>& number)
+{
+    return number->isInt() ? number->getInt() < 0 : number->getDouble() < 0;
+}
+
+bool TreeFixer::isChain(const nodePtr& node, bool additive)
+{
+    // A negated chain is a single operand: -(a + b) is not a + b
+    if (node->getType() != TokenType::OPERATOR ||
+                                            node->getToken()->isNegative())
+    {
+        return false;
+    }
+    std::string op = node->getStr();
+    return additive ? op == "+" || op == "-" : op == "*" || op == "/";
+}
 
-            
-            if (newSubRoot->getType() == TokenType::NUMBER)
+int TreeFixer::collectChain(const nodePtr& node, bool additive,
+                                bool inverted, std::vector<Operand>& out)
+{
+    // An explicit stack, a chain typed out by hand can be thousands deep
+    int depth = 0;
+    std::vector<std::pair<Operand, int>> pending{{{node, inverted}, 0}};
+    while (!pending.empty())
+    {
+        Operand operand = pending.back().first;
+        int level = pending.back().second;
+        pending.pop_back();
+        if (!isChain(operand.node, additive))
+        {
+            out.push_back(operand);
+            depth = std::max(depth, level);
+            continue;
+        }
+        bool flips = operand.node->getStr() == (additive ? "-" : "/");
+        pending.push_back({{operand.node->getRight(),
+                                    operand.inverted != flips}, level + 1});
+        pending.push_back({{operand.node->getLeft(), operand.inverted},
+                                                                level + 1});
+    }
+    return depth;
+}
+
+std::shared_ptr<ExpressionNode> TreeFixer::simplifyChain(nodePtr node,
+                        bool additive, nodeSet* settled, std::string& error)
+{
+    std::vector<Operand> operands;
+    int depth = collectChain(node, additive, false, operands);
+
+    std::vector<Operand> simplified;
+    // Operands replaced one for one, or the chain reshaped
+    bool replaced = false;
+    bool reshaped = false;
+    bool checked = true;
+    for (const auto& operand : operands)
+    {
+        checked = checked && settled && settled->count(operand.node);
+        nodePtr out = simplify(operand.node, settled, error);
+        if (!out)
+        {
+            return nullptr;
+        }
+        auto number = Arithmetic::getNumberToken(out);
+        if (!additive && operand.inverted && number && number->equals(0))
+        {
+            error = Arithmetic::getDomainError(Operation::divide(node, out));
+            return nullptr;
+        }
+        if (out != operand.node && isChain(out, additive))
+        {
+            collectChain(out, additive, operand.inverted, simplified);
+            reshaped = true;
+            continue;
+        }
+        replaced = replaced || out != operand.node;
+        simplified.push_back({out, operand.inverted});
+    }
+    if (additive ? collectTerms(simplified) : collectFactors(simplified))
+    {
+        reshaped = true;
+    }
+
+    // A spine more than twice as deep as a balanced tree is rebuilt
+    int balanced = 0;
+    while ((std::size_t(1) << balanced) < operands.size())
+    {
+        balanced++;
+    }
+    nodePtr out = node;
+    if (reshaped || depth > 2 * balanced)
+    {
+        out = buildChain(simplified, 0, simplified.size(), additive, false);
+    }
+    else if (replaced)
+    {
+        std::size_t next = 0;
+        out = replaceOperands(node, additive, simplified, next);
+    }
+    if (settled && out == node && checked)
+    {
+        settled->insert(node);
+    }
+    return out;
+}
+
+void TreeFixer::splitTerm(const nodePtr& node,
+                    std::shared_ptr<Number>& coefficient, nodePtr& rest)
+{
+    coefficient = TokenPool::number(1);
+    rest = node;
+    if (node->getType() == TokenType::NUMBER)
+    {
+        coefficient = Arithmetic::getNumberToken(node);
+        rest = nullptr;
+        return;
+    }
+    if (!isChain(node, false))
+    {
+        return;
+    }
+    // The coefficient is the first number multiplied in, wherever it is
+    std::vector<Operand> factors;
+    collectChain(node, false, false, factors);
+    for (std::size_t idx = 0; idx < factors.size(); idx++)
+    {
+        auto number = Arithmetic::getNumberToken(factors[idx].node);
+        if (!number || factors[idx].inverted)
+        {
+            continue;
+        }
+        factors.erase(factors.begin() + idx);
+        if (factors[0].inverted)
+        {
+            // 2/x: the rest would be 1/x, leave the term whole
+            return;
+        }
+        coefficient = number;
+        rest = factors.size() == 1 ? factors[0].node :
+                            buildChain(factors, 0, factors.size(), false, false);
+        return;
+    }
+}
+
+bool TreeFixer::collectTerms(std::vector<Operand>& operands)
+{
+    // Each term is coefficient * rest, the constant has no rest
+    std::vector<std::shared_ptr<Number>> coefficients;
+    std::vector<nodePtr> rests;
+    std::vector<bool> merged;
+    std::vector<Operand> terms;
+    int constant = -1;
+    Equivalence::hashTable table;
+    std::unordered_map<std::size_t, std::vector<std::size_t>> index;
+    bool changed = false;
+    for (const auto& operand : operands)
+    {
+        std::shared_ptr<Number> coefficient;
+        nodePtr rest;
+        splitTerm(operand.node, coefficient, rest);
+        if (operand.inverted)
+        {
+            coefficient = negated(coefficient);
+        }
+        int like = rest ? -1 : constant;
+        std::size_t key = rest ? Equivalence::hash(rest, table) : 0;
+        for (std::size_t idx : rest ? index[key] : std::vector<std::size_t>())
+        {
+            if (Equivalence::structurallyEqual(rests[idx], rest))
             {
-                auto arg = std::dynamic_pointer_cast<Number>(
-                                            newSubRoot->getToken());
-                double result;
-                //std::cout << funcToken->getStr() << "(";
-                if (arg->isInt())
-                {
-                    result = func->evaluate(arg->getInt() * 1.0);
-                    //std::cout << arg->getInt() * 1.0 << ")";
-                }
-                else
-                {
-                    result = func->evaluate(arg->getDouble());
-                    //std::cout << arg->getDouble() << ")";
-                }
-                //std::cout << " = " << result << "\n";
-                if (std::fmod(result, 1) == 0 || 
-                            Arithmetic::floatSimplification)
-                {
-                    
-                    node->setToken(std::make_shared<Number>(
-                                        std::to_string(result),
-                                        result));
-                }
+                like = static_cast<int>(idx);
+                break;
             }
-            
-            
-            
         }
-        
+        // Coefficients that do not fold, as 0.5 + 0.25 without float
+        // simplification, stay separate terms
+        auto sum = like == -1 ? nullptr :
+                    Arithmetic::add(nullptr, coefficients[like], coefficient);
+        if (sum)
+        {
+            coefficients[like] = sum;
+            merged[like] = true;
+            changed = true;
+            continue;
+        }
+        if (rest)
+        {
+            index[key].push_back(terms.size());
+        }
+        else if (constant == -1)
+        {
+            constant = terms.size();
+        }
+        coefficients.push_back(coefficient);
+        // The rest stays alive while its address is in the table
+        rests.push_back(rest);
+        merged.push_back(false);
+        terms.push_back(operand);
     }
-    
-    //std::cout << "Simplified: " << TextConverter::convertToText(node) << "\n";
-    return node;
-}
\ No newline at end of file
+
+    std::vector<Operand> out;
+    for (std::size_t idx = 0; idx < terms.size(); idx++)
+    {
+        if (coefficients[idx]->equals(0))
+        {
+            changed = true;
+            continue;
+        }
+        if (!merged[idx])
+        {
+            out.push_back(terms[idx]);
+            continue;
+        }
+        // x - 2*x is x + (-1)*x, but only the first term needs the sign
+        bool inverted = !out.empty() && isBelowZero(coefficients[idx]);
+        auto magnitude = inverted ? negated(coefficients[idx]) :
+                                                        coefficients[idx];
+        auto number = std::make_shared<ExpressionNode>(magnitude);
+        nodePtr term = !rests[idx] ? number : magnitude->equals(1) ?
+                            rests[idx] : Operation::times(number, rests[idx]);
+        out.push_back({term, inverted});
+    }
+    if (out.empty())
+    {
+        out.push_back({std::make_shared<ExpressionNode>(
+                                            TokenPool::number(0)), false});
+    }
+    if (out[0].inverted)
+    {
+        // 0 - u is -u
+        nodePtr negative = Operation::subtract(
+                std::make_shared<ExpressionNode>(TokenPool::number(0)),
+                                                            out[0].node);
+        Arithmetic::simplifySubtraction(negative);
+        out[0] = {negative, false};
+    }
+    operands = out;
+    return changed;
+}
+
+bool TreeFixer::collectFactors(std::vector<Operand>& operands)
+{
+    // Each factor is base^exponent, numbers fold into a single coefficient
+    std::vector<std::shared_ptr<Number>> exponents;
+    std::vector<nodePtr> bases;
+    std::vector<bool> merged;
+    std::vector<Operand> factors;
+    int coefficient = -1;
+    std::shared_ptr<Number> scale;
+    bool divisor = false;
+    Equivalence::hashTable table;
+    std::unordered_map<std::size_t, std::vector<std::size_t>> index;
+    bool changed = false;
+    for (const auto& operand : operands)
+    {
+        auto number = Arithmetic::getNumberToken(operand.node);
+        if (number && coefficient == -1)
+        {
+            coefficient = factors.size();
+            scale = number;
+            divisor = operand.inverted;
+        }
+        else if (number)
+        {
+            // a*b, a/b, b/a or 1/(a*b); a division that does not fold
+            // leaves the number where it is
+            std::shared_ptr<Number> folded;
+            bool inverted = divisor;
+            if (divisor == operand.inverted)
+            {
+                folded = Arithmetic::multiply(nullptr, scale, number);
+            }
+            else if (!divisor)
+            {
+                folded = Arithmetic::divide(nullptr, scale, number);
+            }
+            else
+            {
+                folded = Arithmetic::divide(nullptr, number, scale);
+                inverted = false;
+            }
+            if (folded)
+            {
+                scale = folded;
+                divisor = inverted;
+                merged[coefficient] = true;
+                changed = true;
+                continue;
+            }
+        }
+        if (number)
+        {
+            exponents.push_back(nullptr);
+            bases.push_back(nullptr);
+            merged.push_back(false);
+            factors.push_back(operand);
+            continue;
+        }
+
+        nodePtr base = operand.node;
+        std::shared_ptr<Number> exponent = TokenPool::number(1);
+        if (base->getType() == TokenType::OPERATOR &&
+                base->getStr() == "^" && !base->getToken()->isNegative() &&
+                            Arithmetic::getNumberToken(base->getRight()))
+        {
+            exponent = Arithmetic::getNumberToken(base->getRight());
+            base = base->getLeft();
+        }
+        if (operand.inverted)
+        {
+            exponent = negated(exponent);
+        }
+        std::size_t key = Equivalence::hash(base, table);
+        bool found = false;
+        for (std::size_t idx : index[key])
+        {
+            if (!Equivalence::structurallyEqual(bases[idx], base))
+            {
+                continue;
+            }
+            auto sum = Arithmetic::add(nullptr, exponents[idx], exponent);
+            if (sum)
+            {
+                exponents[idx] = sum;
+                merged[idx] = true;
+                changed = true;
+                found = true;
+            }
+            break;
+        }
+        if (!found)
+        {
+            index[key].push_back(factors.size());
+            exponents.push_back(exponent);
+            bases.push_back(base);
+            merged.push_back(false);
+            factors.push_back(operand);
+        }
+    }
+
+    if (coefficient != -1 && !divisor && scale->equals(0))
+    {
+        // 0 times anything
+        auto zero = std::make_shared<ExpressionNode>(TokenPool::number(0));
+        changed = operands.size() != 1;
+        operands = {{zero, false}};
+        return changed;
+    }
+    std::vector<Operand> out;
+    for (std::size_t idx = 0; idx < factors.size(); idx++)
+    {
+        if (static_cast<int>(idx) == coefficient)
+        {
+            // 1/x keeps its 1, there is no other way to write it
+            bool needed = idx == 0 && factors.size() > 1 &&
+                                                        factors[1].inverted;
+            if (scale->equals(1) && !needed)
+            {
+                changed = true;
+            }
+            else if (merged[idx])
+            {
+                out.push_back({std::make_shared<ExpressionNode>(scale),
+                                                                divisor});
+            }
+            else
+            {
+                out.push_back(factors[idx]);
+            }
+            continue;
+        }
+        if (!merged[idx])
+        {
+            out.push_back(factors[idx]);
+            continue;
+        }
+        if (exponents[idx]->equals(0))
+        {
+            continue;
+        }
+        bool inverted = isBelowZero(exponents[idx]);
+        auto magnitude = inverted ? negated(exponents[idx]) : exponents[idx];
+        nodePtr factor = magnitude->equals(1) ? bases[idx] :
+                Operation::power(bases[idx],
+                                std::make_shared<ExpressionNode>(magnitude));
+        out.push_back({factor, inverted});
+    }
+    if (out.empty())
+    {
+        out.push_back({std::make_shared<ExpressionNode>(
+                                            TokenPool::number(1)), false});
+    }
+    if (out[0].inverted)
+    {
+        out[0] = {Operation::divide(std::make_shared<ExpressionNode>(
+                        TokenPool::number(1)), out[0].node), false};
+    }
+    operands = out;
+    return changed;
+}
+
+std::shared_ptr<ExpressionNode> TreeFixer::buildChain(
+                            const std::vector<Operand>& operands,
+                            std::size_t begin, std::size_t end,
+                            bool additive, bool flip)
+{
+    if (end - begin == 1)
+    {
+        return operands[begin].node;
+    }
+    // The left half takes the extra operand, so a - b + c stays (a - b) + c
+    std::size_t middle = begin + (end - begin + 1) / 2;
+    nodePtr left = buildChain(operands, begin, middle, additive, flip);
+    // a - (b + c) when b is subtracted: the right half is built inverted
+    bool inverted = operands[middle].inverted != flip;
+    nodePtr right = buildChain(operands, middle, end, additive,
+                                                        flip != inverted);
+    if (additive)
+    {
+        return inverted ? Operation::subtract(left, right) :
+                                                Operation::add(left, right);
+    }
+    return inverted ? Operation::divide(left, right) :
+                                                Operation::times(left, right);
+}
+
+std::shared_ptr<ExpressionNode> TreeFixer::replaceOperands(
+                            const nodePtr& node, bool additive,
+                            const std::vector<Operand>& operands,
+                            std::size_t& next)
+{
+    if (!isChain(node, additive))
+    {
+        return operands[next++].node;
+    }
+    nodePtr left = replaceOperands(node->getLeft(), additive, operands, next);
+    nodePtr right = replaceOperands(node->getRight(), additive, operands,
+                                                                        next);
+    if (left == node->getLeft() && right == node->getRight())
+    {
+        return node;
+    }
+    auto out = std::make_shared<ExpressionNode>(node->getToken());
+    out->setLeft(left);
+    out->setRight(right);
+    return out;
+}
@@ -2,18 +2,110 @@
 #define __TREE_FIXER_HPP__
 
 #include "expression_node.hpp"
+#include "result.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 class TreeFixer
 {   
     typedef std::shared_ptr<ExpressionNode> nodePtr;
+    typedef std::unordered_set<nodePtr> nodeSet;
+
+    // On failure these set error and return false, or null, at once
+    static bool checkTree(nodePtr node, nodeSet* settled, std::string& error);
+    static bool checkChildren(nodePtr node, std::string& error);
+    static nodePtr simplify(nodePtr node, nodeSet* settled,
+                                                        std::string& error);
+
+    //! An operand of a chain of + and - (or * and /), inverted when it is
+    //! subtracted (or divided by)
+    struct Operand
+    {
+        nodePtr node;
+        bool inverted;
+    };
+
+    static bool isChain(const nodePtr& node, bool additive);
+    //! Appends the operands in written order, returns the chain's depth
+    static int collectChain(const nodePtr& node, bool additive,
+                                bool inverted, std::vector<Operand>& out);
+    static nodePtr simplifyChain(nodePtr node, bool additive,
+                                    nodeSet* settled, std::string& error);
+    // Collect like operands in place, return whether anything changed
+    static bool collectTerms(std::vector<Operand>& operands);
+    static bool collectFactors(std::vector<Operand>& operands);
+    //! Splits a term into its numeric coefficient and the rest, null for
+    //! a number
+    static void splitTerm(const nodePtr& node,
+                    std::shared_ptr<Number>& coefficient, nodePtr& rest);
+    //! Balanced chain; flip inverts every operand, for the right side of
+    //! a - or a /
+    static nodePtr buildChain(const std::vector<Operand>& operands,
+                                std::size_t begin, std::size_t end,
+                                bool additive, bool flip);
+    //! The chain with its operands replaced one for one, same shape
+    static nodePtr replaceOperands(const nodePtr& node, bool additive,
+                    const std::vector<Operand>& operands, std::size_t& next);
 public:
 
+    /**
+     * @throws std::runtime_error if an operator is missing an operand
+     */
     static void checkTree(nodePtr node);
+
+    /**
+     * @brief checkTree that returns a SYNTAX error instead of throwing.
+     *
+     * @return node, which checkTree may have changed in place
+     */
+    static Result<nodePtr> tryCheckTree(nodePtr node);
+
+    /**
+     * @brief checkTree that skips the settled sub-trees.
+     *
+     * @details A sub-tree is settled when neither checkTree nor simplify
+     * would change it. Neither changes a node outside of what it is
+     * called on, so a settled sub-tree stays settled: a tree rebuilt
+     * around earlier results, as a derivative of a long sum is, costs
+     * only its new nodes.
+     */
+    static void checkTree(nodePtr node, nodeSet& settled);
     
     static void checkChildren(nodePtr node);
+
+    /**
+     * @brief Folds constants and drops identities (x*1, x+0, x^1, ...).
+     *
+     * @details A chain of + and - (or * and /) is simplified as a whole:
+     * like terms are collected (x + y + x is 2*x + y), repeated factors
+     * become powers (x*y*x is x^2*y) and numbers fold into one constant,
+     * each kept where its first operand was written. Operands are never
+     * reordered otherwise. A chain whose spine is more than twice as deep
+     * as a balanced one, or whose operands were collected, is rebuilt
+     * balanced, so a sum of n terms ends up log2(n) deep.
+     *
+     * The input tree is left untouched; the result shares every
+     * sub-tree that did not change, and is node itself when nothing did.
+     * Callers keep the returned root.
+     * @throws std::runtime_error on a division by 0 or 0^0
+     */
     static nodePtr simplify(nodePtr node);
+
+    /**
+     * @brief simplify that returns a DOMAIN error instead of throwing.
+     */
+    static Result<nodePtr> trySimplify(nodePtr node);
+
+    /**
+     * @brief simplify that skips the settled sub-trees, and adds the
+     * sub-trees it finds settled.
+     */
+    static nodePtr simplify(nodePtr node, nodeSet& settled);
+    static Result<nodePtr> trySimplify(nodePtr node, nodeSet& settled);
 };
 
 #endif // __TREE_FIXER_HPP__
\ No newline at end of file
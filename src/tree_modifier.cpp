@@ -1,4 +1,5 @@
 #include "tree_modifier.hpp"
+#include "token_pool.hpp"
 
 
 
@@ -23,21 +24,30 @@ void TreeModifier::swapNodes(nodePtr node1, nodePtr node2)
 
 std::shared_ptr<ExpressionNode> TreeModifier::expandNegative(nodePtr node)
 {
-    
-    // Flip the sign of the original node's token to make it positive
-    node->getToken()->flipSign();
+    // The token may be pooled or shared with another tree, so the
+    // positive one is a copy; a function keeps sharing its argument
+    std::shared_ptr<Token> positive;
+    if (auto func = std::dynamic_pointer_cast<Function>(node->getToken()))
+    {
+        positive = std::make_shared<Function>(*func);
+    }
+    else
+    {
+        positive = node->getToken()->clone();
+    }
+    positive->flipSign();
 
     // Create -1 node
-    auto negativeOne = std::make_shared<Number>("1", 1);
-    negativeOne->setNegative(true);
-    auto negativeOneNode = std::make_shared<ExpressionNode>(negativeOne);
+    auto negativeOneNode = std::make_shared<ExpressionNode>(
+                                                    TokenPool::number(-1));
 
     // New parent '*' pointer
-    auto timesToken = std::make_shared<Operator>("*");
+    auto timesToken = TokenPool::op("*");
     auto timesNode = std::make_shared<ExpressionNode>(timesToken);
 
     // Copy of current node
     auto copyNode = node->copyTree();
+    copyNode->setToken(positive);
 
     timesNode->setLeft(negativeOneNode);
     timesNode->setRight(copyNode);
@@ -70,7 +80,7 @@ void TreeModifier::replaceWithRightChild(nodePtr& node) {
     if (!node || !node->getRight()) return;
 
     // Get the right child of the node
-    auto right = node->getRight()->copyTree();
+    auto right = node->getRight();
 
 
    
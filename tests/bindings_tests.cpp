@@ -0,0 +1,83 @@
+/**
+ * @file bindings_tests.cpp
+ * @brief Google Tests for bindings.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "bindings.hpp"
+#include "approx.hpp"
+#include "derivative.hpp"
+#include "tabulator.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <memory>
+
+
+class BindingsTests : public SymbolicTest
+{
+protected:
+    FlatTree freeze(const std::string& input)
+    {
+        return FlatTree(TreeFixer::simplify(parseTree(input)));
+    }
+};
+
+TEST_F(BindingsTests, ParsesList)
+{
+    Bindings bindings = Bindings::parse("a=2,b=-3.5,a_1=1e-3");
+    ASSERT_EQ(bindings.size(), 3);
+    EXPECT_DOUBLE_EQ(bindings.getValue(
+                    bindings.find(std::make_shared<Variable>("a"))), 2.0);
+    EXPECT_DOUBLE_EQ(bindings.getValue(
+                    bindings.find(std::make_shared<Variable>("b"))), -3.5);
+    EXPECT_DOUBLE_EQ(bindings.getValue(bindings.find(
+                    Derivative::parseVariable("a_1"))), 1e-3);
+
+    bindings.set("a", 5.0);
+    EXPECT_EQ(bindings.size(), 3);
+
+    EXPECT_THROW(Bindings::parse("a"), std::runtime_error);
+    EXPECT_THROW(Bindings::parse("a=2,"), std::runtime_error);
+    EXPECT_THROW(Bindings::parse("a=2x"), std::runtime_error);
+    EXPECT_THROW(Bindings::parse("2=a"), std::runtime_error);
+    EXPECT_THROW(Bindings::parse("a=3,a=4"), std::runtime_error);
+    EXPECT_THROW(Bindings::parse("a=nan"), std::runtime_error);
+    EXPECT_THROW(Bindings::parse("a=inf"), std::runtime_error);
+    EXPECT_NO_THROW(Bindings::parse("a=3,a_1=4"));
+}
+
+TEST_F(BindingsTests, EvaluatesEveryVariable)
+{
+    FlatTree tree = freeze("a*x^2+b*x+k_1");
+    Bindings bindings = Bindings::parse("a=2,b=3,k_1=-4");
+    bindings.set("x", 1.5);
+    EXPECT_DOUBLE_EQ(Approx::approximate(tree, bindings),
+                                            2 * 1.5 * 1.5 + 3 * 1.5 - 4);
+
+    // The slots follow the tree, not the order of the bindings
+    auto slots = bindings.getSlots(tree);
+    ASSERT_EQ(slots.size(), tree.getVariables().size());
+    EXPECT_DOUBLE_EQ(slots[tree.getSlot(std::make_shared<Variable>("b"))],
+                                                                        3.0);
+
+    // Nothing silently becomes 1.0
+    EXPECT_THROW(Approx::approximate(tree, Bindings::parse("a=2,b=3")),
+                                                        std::runtime_error);
+}
+
+TEST_F(BindingsTests, BindsTabulatorParameters)
+{
+    Tabulator table(freeze("a*sin(x)"), freeze("a*cos(x)"), x);
+    table.bind(Bindings::parse("a=3"));
+    double out[3];
+    table.tabulate({0.5, 0.5, 1.0}, out, 1);
+    EXPECT_DOUBLE_EQ(out[1], 3 * std::sin(0.5));
+    EXPECT_DOUBLE_EQ(out[2], 3 * std::cos(0.5));
+
+    EXPECT_THROW(table.bind(Bindings::parse("b=3")), std::runtime_error);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file code_converter_tests.cpp
+ * @brief Google Tests for code_converter.cpp and compiled_function.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "code_converter.hpp"
+#include "compiled_function.hpp"
+#include "derivative.hpp"
+#include "eval_optimizer.hpp"
+#include "specializer.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class CodeConverterTests : public SymbolicTest
+{
+protected:
+    nodePtr getDerivative(std::string input)
+    {
+        return Derivative(input, "x").solve();
+    }
+};
+
+TEST_F(CodeConverterTests, GeneratesFunctionSource)
+{
+    FlatTree tree(getDerivative("x^2+sin(x)"));
+    std::string source = CodeConverter::convertToC(tree, {x}, "deriv");
+    EXPECT_NE(source.find("double deriv(const double* vars)"),
+                                                        std::string::npos);
+    EXPECT_NE(source.find("cos(vars[0])"), std::string::npos) << source;
+}
+
+TEST_F(CodeConverterTests, MissingVariableThrows)
+{
+    FlatTree tree(getDerivative("x*y"));
+    EXPECT_THROW(CodeConverter::convertToC(tree, {x}), std::runtime_error);
+}
+
+TEST_F(CodeConverterTests, CompiledMatchesFlatTree)
+{
+    FlatTree tree(getDerivative("x^3*cos(x)+ln(x)/sqrt(x)"));
+    auto variables = CodeConverter::getVariables(tree, x);
+    CompiledFunction compiled(tree, variables);
+    for (double value : {0.5, 1.5, 3.0, 7.25})
+    {
+        EXPECT_NEAR(compiled(&value), tree.evaluate(&value), 1e-9);
+    }
+}
+
+TEST_F(CodeConverterTests, GeneratesSharedAssignments)
+{
+    auto root = parseTree("sin(x)^2+sin(x)");
+    Program program = EvalOptimizer::compile(root, x);
+    program.addOutput(EvalOptimizer::differentiate(program,
+                                                program.getOutput(), x));
+    std::string code = CodeConverter::convertToSSA(program, {"f", "df"});
+
+    // sin(x) and cos(x) are each assigned once, for f and df alike
+    EXPECT_EQ(code.find("t1 = sin(x);\n"), 0u);
+    EXPECT_EQ(code.find("sin(x)", 6), std::string::npos);
+    EXPECT_EQ(code.find("cos(x)"), code.rfind("cos(x)"));
+    EXPECT_NE(code.find("\nf = t"), std::string::npos);
+    EXPECT_NE(code.find("\ndf = t"), std::string::npos);
+    EXPECT_THROW(CodeConverter::convertToSSA(program, {"f"}),
+                                                        std::runtime_error);
+}
+
+TEST_F(CodeConverterTests, CompilesNonFiniteConstants)
+{
+    auto makeTree = [this](double value)
+    {
+        auto root = std::make_shared<ExpressionNode>(
+                                        std::make_shared<Operator>("*"));
+        root->setLeft(std::make_shared<ExpressionNode>(x));
+        root->setRight(Specializer::makeNumber(value));
+        return FlatTree(root);
+    };
+    std::string source = CodeConverter::convertToC(makeTree(-INFINITY), {x});
+    EXPECT_NE(source.find("(-INFINITY)"), std::string::npos) << source;
+    EXPECT_EQ(source.find("inf"), std::string::npos) << source;
+
+    double value = 2.0;
+    EXPECT_EQ(CompiledFunction(makeTree(INFINITY), {x})(&value), INFINITY);
+    EXPECT_EQ(CompiledFunction(makeTree(-INFINITY), {x})(&value), -INFINITY);
+
+    // Binding can fold a constant into nan
+    FlatTree folded = Specializer::compile(parseTree("x+ln(b)"),
+                                                Bindings::parse("b=-1"));
+    source = CodeConverter::convertToC(folded, {x});
+    EXPECT_NE(source.find("NAN"), std::string::npos) << source;
+    EXPECT_TRUE(std::isnan(CompiledFunction(folded, {x})(&value)));
+}
@@ -0,0 +1,125 @@
+/**
+ * @file derivative_cache_tests.cpp
+ * @brief Google Tests for derivative_cache.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "derivative_cache.hpp"
+#include "derivative.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <memory>
+
+
+class DerivativeCacheTests : public SymbolicTest
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        SymbolicTest::SetUp();
+        path = ::testing::TempDir() + "derivative_cache_test.bin";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+        SymbolicTest::TearDown();
+    }
+
+    FlatTree derive(std::string input)
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        return FlatTree(engine.solve());
+    }
+};
+
+TEST_F(DerivativeCacheTests, MissThenHit)
+{
+    DerivativeCache cache(path);
+    std::string key = DerivativeCache::key("x^2 * sin(x)", "x", "log");
+    DerivativeCache::Entry entry;
+    EXPECT_FALSE(cache.find(key, entry));
+
+    FlatTree tree = derive("x^2*sin(x)");
+    cache.insert(key, "rendered", tree);
+    ASSERT_TRUE(cache.find(key, entry));
+    EXPECT_EQ(entry.output, "rendered");
+    EXPECT_TRUE(DerivativeCache::derivative(entry).equals(tree));
+
+    // Whitespace does not change the key, the options do
+    EXPECT_TRUE(cache.find(DerivativeCache::key("x^2*sin(x)", "x", "log"),
+                                                                    entry));
+    EXPECT_FALSE(cache.find(DerivativeCache::key("x^2*sin(x)", "x",
+                                                    "codegen"), entry));
+    EXPECT_FALSE(cache.find(DerivativeCache::key("x^2*sin(x)", "y", "log"),
+                                                                    entry));
+}
+
+TEST_F(DerivativeCacheTests, SharedBetweenInstances)
+{
+    DerivativeCache reader(path);
+    DerivativeCache writer(path);
+    DerivativeCache::Entry entry;
+    std::string first = DerivativeCache::key("exp(x)", "x", "log");
+    std::string second = DerivativeCache::key("ln(x)", "x", "log");
+
+    EXPECT_FALSE(reader.find(first, entry));
+    writer.insert(first, "one", derive("exp(x)"));
+    writer.insert(second, "two", derive("ln(x)"));
+    // A second insert of the same key keeps the first record
+    writer.insert(first, "ignored", derive("exp(x)"));
+
+    ASSERT_TRUE(reader.find(second, entry));
+    EXPECT_EQ(entry.output, "two");
+    ASSERT_TRUE(reader.find(first, entry));
+    EXPECT_EQ(entry.output, "one");
+
+    DerivativeCache reopened(path);
+    ASSERT_TRUE(reopened.find(second, entry));
+    EXPECT_EQ(entry.output, "two");
+}
+
+TEST_F(DerivativeCacheTests, IgnoresUncommittedTail)
+{
+    std::string key = DerivativeCache::key("cos(x)", "x", "log");
+    {
+        DerivativeCache cache(path);
+        cache.insert(key, "kept", derive("cos(x)"));
+    }
+    // A writer that died half way leaves bytes without a commit marker
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in |
+                                                        std::ios::out);
+        file.seekp(-8, std::ios::end);
+        std::string garbage(64, '\x7f');
+        garbage[0] = garbage[1] = garbage[2] = garbage[3] = 0;
+        file.write(garbage.data(), garbage.size());
+    }
+    DerivativeCache cache(path);
+    DerivativeCache::Entry entry;
+    ASSERT_TRUE(cache.find(key, entry));
+    EXPECT_EQ(entry.output, "kept");
+
+    std::string other = DerivativeCache::key("sin(x)", "x", "log");
+    cache.insert(other, "appended", derive("sin(x)"));
+    ASSERT_TRUE(cache.find(other, entry));
+    EXPECT_EQ(entry.output, "appended");
+}
+
+TEST_F(DerivativeCacheTests, RejectsForeignFile)
+{
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "definitely not a cache file";
+    }
+    EXPECT_THROW(DerivativeCache cache(path), std::runtime_error);
+}
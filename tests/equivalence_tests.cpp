@@ -0,0 +1,104 @@
+/**
+ * @file equivalence_tests.cpp
+ * @brief Google Tests for equivalence.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "equivalence.hpp"
+#include "derivative.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <memory>
+
+
+class EquivalenceTests : public SymbolicTest
+{
+};
+
+TEST_F(EquivalenceTests, HashIgnoresOperandOrder)
+{
+    EXPECT_EQ(Equivalence::hash(parseTree("x*y+sin(x)")),
+                Equivalence::hash(parseTree("sin(x)+y*x")));
+    EXPECT_EQ(Equivalence::hash(parseTree("x+y+z")),
+                Equivalence::hash(parseTree("x+(z+y)")));
+    EXPECT_NE(Equivalence::hash(parseTree("x-y")),
+                Equivalence::hash(parseTree("y-x")));
+    EXPECT_NE(Equivalence::hash(parseTree("x/y")),
+                Equivalence::hash(parseTree("y/x")));
+    EXPECT_NE(Equivalence::hash(parseTree("sin(x)")),
+                Equivalence::hash(parseTree("cos(x)")));
+}
+
+TEST_F(EquivalenceTests, HashIsMemoized)
+{
+    auto root = parseTree("x^2*sin(x)+exp(x)");
+    Equivalence::hashTable table;
+    std::size_t hash = Equivalence::hash(root, table);
+    std::size_t visited = table.size();
+    EXPECT_GT(visited, 1);
+    EXPECT_EQ(Equivalence::hash(root, table), hash);
+    EXPECT_EQ(table.size(), visited);
+}
+
+TEST_F(EquivalenceTests, StructuralEquality)
+{
+    EXPECT_TRUE(Equivalence::structurallyEqual(parseTree("x*y*z+1"),
+                                                parseTree("1+z*(y*x)")));
+    EXPECT_TRUE(Equivalence::structurallyEqual(parseTree("2.0*x"),
+                                                parseTree("x*2")));
+    EXPECT_FALSE(Equivalence::structurallyEqual(parseTree("x*y+z"),
+                                                parseTree("x*(y+z)")));
+    EXPECT_FALSE(Equivalence::structurallyEqual(parseTree("x^2"),
+                                                parseTree("2^x")));
+}
+
+TEST_F(EquivalenceTests, NumericFallback)
+{
+    EXPECT_TRUE(Equivalence::equivalent(parseTree("2*x"), parseTree("x+x")));
+    EXPECT_TRUE(Equivalence::equivalent(parseTree("sin(x)^2+cos(x)^2"),
+                                        parseTree("1")));
+    EXPECT_TRUE(Equivalence::equivalent(parseTree("exp(x+y)"),
+                                        parseTree("exp(x)*exp(y)")));
+    // Different domains: x < 0 is finite on one side only
+    EXPECT_FALSE(Equivalence::equivalent(parseTree("ln(x^2)"),
+                                        parseTree("2*ln(x)")));
+    EXPECT_FALSE(Equivalence::equivalent(parseTree("sqrt(x)^2"), parseTree("x")));
+    EXPECT_FALSE(Equivalence::equivalent(parseTree("x^2"), parseTree("x^3")));
+    EXPECT_FALSE(Equivalence::equivalent(parseTree("x+1e-6"), parseTree("x")));
+}
+
+TEST_F(EquivalenceTests, RejectsNoSamples)
+{
+    for (int samples : {0, -1})
+    {
+        EXPECT_THROW(Equivalence::equivalent(parseTree("x^2"),
+                        parseTree("x^3"), samples), std::invalid_argument);
+    }
+}
+
+TEST_F(EquivalenceTests, DerivativeMatchesHandWritten)
+{
+    Derivative engine("x^2*sin(x)", "x");
+    engine.log.setEnabled(false);
+    auto derivative = engine.solve();
+    EXPECT_TRUE(Equivalence::equivalent(derivative,
+                                parseTree("2*x*sin(x)+x^2*cos(x)")));
+    EXPECT_FALSE(Equivalence::equivalent(derivative,
+                                parseTree("2*x*sin(x)+x^2*sin(x)")));
+}
+
+TEST_F(EquivalenceTests, UlpDistance)
+{
+    EXPECT_EQ(Equivalence::ulpDistance(1.0, 1.0), 0);
+    EXPECT_EQ(Equivalence::ulpDistance(1.0, std::nextafter(1.0, 2.0)), 1);
+    EXPECT_EQ(Equivalence::ulpDistance(0.0, -0.0), 0);
+    EXPECT_EQ(Equivalence::ulpDistance(-DBL_TRUE_MIN, DBL_TRUE_MIN), 2);
+    EXPECT_TRUE(Equivalence::close(1e-300, -1e-300, 4));
+    EXPECT_FALSE(Equivalence::close(1.0, 1.0 + 1e-9, 1024));
+}
@@ -0,0 +1,166 @@
+/**
+ * @file eval_optimizer_tests.cpp
+ * @brief Google Tests for eval_optimizer.cpp and program.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "eval_optimizer.hpp"
+#include "derivative.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <memory>
+
+class EvalOptimizerTests : public SymbolicTest
+{
+};
+
+static void expectSame(const std::shared_ptr<ExpressionNode>& root,
+                                                    const Program& program)
+{
+    FlatTree tree(root);
+    ASSERT_EQ(tree.getVariables().size(), 1u);
+    ASSERT_EQ(program.getVariables().size(), 1u);
+    for (double value : {-1.75, -0.5, 0.3, 1.0, 2.5})
+    {
+        double expected = tree.evaluate(&value);
+        double actual = program.evaluate(&value);
+        if (std::isnan(expected))
+        {
+            EXPECT_TRUE(std::isnan(actual));
+        }
+        else
+        {
+            EXPECT_NEAR(actual, expected, 1e-9 * (1 + std::fabs(expected)));
+        }
+    }
+}
+
+TEST_F(EvalOptimizerTests, HornerForm)
+{
+    auto root = parseTree("3*x^4+2*x^3-x^2+5*x-7");
+    Program program = EvalOptimizer::compile(root, x);
+    expectSame(root, program);
+
+    // ((3x + 2)x - 1)x + 5)x - 7: four multiplications, no pow
+    EXPECT_EQ(program.count(OpCode::POWER), 0);
+    EXPECT_EQ(program.count(OpCode::MULTIPLY), 4);
+
+    // A gap of three degrees costs one power of x
+    auto sparse = parseTree("x^7+x^4+1");
+    Program sparseProgram = EvalOptimizer::compile(sparse, x);
+    expectSame(sparse, sparseProgram);
+    EXPECT_EQ(sparseProgram.count(OpCode::POWER), 0);
+    EXPECT_LE(sparseProgram.count(OpCode::MULTIPLY), 5);
+}
+
+TEST_F(EvalOptimizerTests, StrengthReducesPowers)
+{
+    auto eighth = parseTree("x^8");
+    Program program = EvalOptimizer::compile(eighth, x);
+    expectSame(eighth, program);
+    EXPECT_EQ(program.count(OpCode::POWER), 0);
+    EXPECT_EQ(program.count(OpCode::MULTIPLY), 3);
+
+    auto inverse = parseTree("1/x^3+x^2.5");
+    Program inverseProgram = EvalOptimizer::compile(inverse, x);
+    expectSame(inverse, inverseProgram);
+    EXPECT_EQ(inverseProgram.count(OpCode::POWER), 0);
+    EXPECT_EQ(inverseProgram.count(OpCode::SQRT), 1);
+
+    auto real = parseTree("x^0.3");
+    EXPECT_EQ(EvalOptimizer::compile(real, x).count(OpCode::POWER), 1);
+}
+
+TEST_F(EvalOptimizerTests, SharesSubExpressions)
+{
+    auto root = parseTree("sin(x^2+1)*cos(x^2+1)+sin(x^2+1)/(x^2+1)");
+    Program program = EvalOptimizer::compile(root, x);
+    expectSame(root, program);
+    EXPECT_EQ(program.count(OpCode::SIN), 1);
+    EXPECT_EQ(program.count(OpCode::COS), 1);
+    EXPECT_EQ(program.count(OpCode::ADD), 2);
+    EXPECT_LT(program.size(), FlatTree(root).size());
+}
+
+TEST_F(EvalOptimizerTests, MatchesDerivatives)
+{
+    for (std::string input : {"x^3*sin(x)*exp(x)+cos(x)/(x^2+1)",
+                            "exp(sin(cos(tan(x^2+1))))",
+                            "sqrt(x^2+1)*ln(x^2+2)",
+                            "(x^2+3x+1)^3/(x-4)"})
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        auto derivative = engine.solve();
+        Program program = EvalOptimizer::compile(derivative, x);
+        expectSame(derivative, program);
+        EXPECT_LE(program.size(), FlatTree(derivative).size());
+    }
+}
+
+TEST_F(EvalOptimizerTests, DifferentiatesPrograms)
+{
+    for (std::string input : {"x^3*sin(x)*exp(x)+cos(x)/(x^2+1)",
+                            "tan(x)*sec(x)+cot(x^2)-csc(x)",
+                            "sqrt(x^2+1)*ln(x^2+2)",
+                            "(x-4)^3/(x^2+1)+x^0.3"})
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        FlatTree derivative(engine.solve());
+
+        Program program = EvalOptimizer::compile(parseTree(input), x);
+        program.addOutput(EvalOptimizer::differentiate(program,
+                                                program.getOutput(), x));
+        std::vector<double> scratch;
+        double results[2];
+        for (double value : {0.3, 1.0, 2.5})
+        {
+            program.evaluate(&value, scratch, results);
+            double expected = derivative.evaluate(&value);
+            EXPECT_NEAR(results[1], expected,
+                            1e-9 * (1 + std::fabs(expected))) << input;
+        }
+    }
+
+    // Checked by hand, the tree derivative of log is not usable here
+    Program program = EvalOptimizer::compile(parseTree("log_2(x^2+1)"), x);
+    int derivative = EvalOptimizer::differentiate(program,
+                                                program.getOutput(), x);
+    program.setOutput(derivative);
+    double value = 1.5;
+    EXPECT_NEAR(program.evaluate(&value),
+                            2 * value / ((value * value + 1) * std::log(2.0)),
+                            1e-12);
+}
+
+TEST_F(EvalOptimizerTests, DerivativeGrowsLinearly)
+{
+    std::string nested = "x";
+    std::string product = "sin(x)";
+    int previous = 0;
+    int previousProduct = 0;
+    for (int depth = 1; depth <= 12; depth++)
+    {
+        nested = "sin(" + nested + "*x)";
+        product += "*sin(x+" + std::to_string(depth) + ")";
+        Program program = EvalOptimizer::compile(parseTree(nested), x);
+        program.addOutput(EvalOptimizer::differentiate(program,
+                                                program.getOutput(), x));
+        Program products = EvalOptimizer::compile(parseTree(product), x);
+        products.addOutput(EvalOptimizer::differentiate(products,
+                                                products.getOutput(), x));
+        // Each level adds the same few entries
+        if (depth > 1)
+        {
+            EXPECT_LE(program.size() - previous, 8);
+            EXPECT_LE(products.size() - previousProduct, 10);
+        }
+        previous = program.size();
+        previousProduct = products.size();
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file flat_tree_tests.cpp
+ * @brief Google Tests for flat_tree.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "flat_tree.hpp"
+#include "approx.hpp"
+#include "latex_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <memory>
+
+
+class FlatTreeTests : public SymbolicTest
+{
+};
+
+TEST_F(FlatTreeTests, PostOrderLayout)
+{
+    FlatTree tree(parseTree("x+2*y", false));
+    ASSERT_EQ(tree.size(), 5);
+    EXPECT_EQ(tree.getOpCode(tree.root()), OpCode::ADD);
+    for (int idx = 0; idx < tree.size(); idx++)
+    {
+        EXPECT_LT(tree.getLeft(idx), idx);
+        EXPECT_LT(tree.getRight(idx), idx);
+    }
+    EXPECT_EQ(tree.getFirst(tree.root()), 0);
+    EXPECT_EQ(tree.getVariables().size(), 2);
+}
+
+TEST_F(FlatTreeTests, EvaluateMatchesApprox)
+{
+    auto root = parseTree("x^2*sin(x)+exp(x)/(x+1)", false);
+    FlatTree tree(root);
+    for (double value : {0.5, 1.1, 2.0, 10.0})
+    {
+        double expected = value * value * std::sin(value) +
+                            std::exp(value) / (value + 1);
+        EXPECT_NEAR(Approx::approximate(tree, x, value), expected, 1e-9);
+    }
+    // Other variables are not quietly set to 1.0
+    EXPECT_THROW(Approx::approximate(FlatTree(parseTree("a*x^2", false)), x,
+                                            2.0), std::runtime_error);
+}
+
+TEST_F(FlatTreeTests, HasVariable)
+{
+    FlatTree tree(parseTree("sin(y)+3*x", false));
+    auto y = std::make_shared<Variable>("y");
+    auto z = std::make_shared<Variable>("z");
+    EXPECT_TRUE(tree.hasVariable(x));
+    EXPECT_TRUE(tree.hasVariable(y));
+    EXPECT_FALSE(tree.hasVariable(z));
+    // sin(y) is the left subtree of the root
+    int left = tree.getLeft(tree.root());
+    EXPECT_TRUE(tree.hasVariable(y, left));
+    EXPECT_FALSE(tree.hasVariable(x, left));
+}
+
+TEST_F(FlatTreeTests, Equality)
+{
+    FlatTree first(parseTree("x*cos(x)+2", false));
+    FlatTree second(parseTree("x*cos(x)+2", false));
+    FlatTree third(parseTree("x*cos(y)+2", false));
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, third);
+}
+
+TEST_F(FlatTreeTests, LaTeXMatchesTree)
+{
+    for (std::string input : {"x+2*y", "sin(x)/x", "x^3-cos(x)", "sqrt(x)"})
+    {
+        auto root = parseTree(input, false);
+        EXPECT_EQ(LaTeXConverter::convertToLaTeX(FlatTree(root)),
+                    LaTeXConverter::convertToLaTeX(root)) << input;
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file incremental_derivative_tests.cpp
+ * @brief Google Tests for incremental_derivative.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "incremental_derivative.hpp"
+#include "derivative.hpp"
+#include "flat_tree.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class IncrementalDerivativeTests : public SymbolicTest
+{
+protected:
+    double evaluate(nodePtr root, double x)
+    {
+        FlatTree tree(root);
+        std::vector<double> slots(tree.getVariables().size(), x);
+        return tree.evaluate(slots.data());
+    }
+};
+
+TEST_F(IncrementalDerivativeTests, MatchesFullDerivative)
+{
+    std::vector<std::string> edits = {"x^2*sin(x)+x^3",
+                                        "x^2*sin(x)+x^4",
+                                        "x^2*sin(x)+x^4-exp(2*x)",
+                                        "ln(x)*sin(x)+x^4-exp(2*x)",
+                                        "ln(x)*sin(x)+x^4-exp(3*x)"};
+    IncrementalDerivative incremental(edits[0], "x");
+    auto first = incremental.solve();
+    EXPECT_NEAR(evaluate(first, 1.3),
+                evaluate(Derivative(edits[0], "x").solve(), 1.3), 1e-9);
+    for (int idx = 1; idx < edits.size(); idx++)
+    {
+        auto result = incremental.update(edits[idx]);
+        auto expected = Derivative(edits[idx], "x").solve();
+        EXPECT_NEAR(evaluate(result, 1.3), evaluate(expected, 1.3), 1e-9)
+            << edits[idx];
+    }
+}
+
+TEST_F(IncrementalDerivativeTests, ReusesUnchangedSubtrees)
+{
+    IncrementalDerivative incremental("x^2*sin(x)+x^3", "x");
+    incremental.solve();
+    incremental.update("x^2*sin(x)+x^4");
+    EXPECT_GT(incremental.getReusedNodes(), 0);
+    EXPECT_LT(incremental.getDirtyNodes(), incremental.getReusedNodes());
+
+    incremental.update("x^2*sin(x)+x^4");
+    EXPECT_EQ(incremental.getDirtyNodes(), 0);
+}
+
+TEST_F(IncrementalDerivativeTests, DropsReplacedNodesFromTheIndex)
+{
+    std::string first = "x^2*sin(x)+x^4-exp(2*x)";
+    std::string second = "x^2*cos(x)+x^3";
+    IncrementalDerivative incremental(first, "x");
+    incremental.solve();
+    incremental.update(second);
+    incremental.update(first);
+    int firstSize = incremental.getIndexedNodes();
+    incremental.update(second);
+    int secondSize = incremental.getIndexedNodes();
+    // Grafted trees may share a leaf, never more nodes than a fresh parse
+    EXPECT_LE(firstSize, IncrementalDerivative(first, "x").getIndexedNodes());
+    EXPECT_LE(secondSize,
+                    IncrementalDerivative(second, "x").getIndexedNodes());
+    for (int round = 0; round < 5; round++)
+    {
+        incremental.update(first);
+        EXPECT_EQ(incremental.getIndexedNodes(), firstSize);
+        incremental.update(second);
+        EXPECT_EQ(incremental.getIndexedNodes(), secondSize);
+    }
+}
+
+TEST_F(IncrementalDerivativeTests, EditedLogBaseIsNotReused)
+{
+    IncrementalDerivative incremental("x*log_2(x)", "x");
+    incremental.solve();
+    auto result = incremental.update("x*log_3(x)");
+    auto expected = Derivative("x*log_3(x)", "x").solve();
+    EXPECT_NEAR(evaluate(result, 8.0), evaluate(expected, 8.0), 1e-9);
+    EXPECT_NE(evaluate(result, 8.0),
+                evaluate(Derivative("x*log_2(x)", "x").solve(), 8.0));
+}
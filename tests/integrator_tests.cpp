@@ -0,0 +1,76 @@
+/**
+ * @file integrator_tests.cpp
+ * @brief Google Tests for integrator.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "integrator.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+
+class IntegratorTests : public SymbolicTest
+{
+};
+
+TEST_F(IntegratorTests, SmoothIntegrands)
+{
+    auto result = Integrator("x^2", "x").integrate(0, 3, 1e-12, 2);
+    EXPECT_NEAR(result.value, 9.0, 1e-12);
+    EXPECT_TRUE(result.converged);
+    EXPECT_FALSE(result.singular);
+    EXPECT_EQ(result.evaluations, 15);
+
+    result = Integrator("sin(x)*exp(x)", "x").integrate(0, PI, 1e-12, 4);
+    EXPECT_NEAR(result.value, (std::exp(PI) + 1) / 2, 1e-10);
+    EXPECT_TRUE(result.converged);
+    EXPECT_LE(result.error, 1e-10);
+
+    result = Integrator("x^2", "x").integrate(3, 0, 1e-12, 2);
+    EXPECT_NEAR(result.value, -9.0, 1e-12);
+}
+
+TEST_F(IntegratorTests, OscillatingIntegrandIsRefined)
+{
+    auto result = Integrator("cos(50*x)", "x").integrate(0, 2, 1e-10, 4);
+    EXPECT_NEAR(result.value, std::sin(100.0) / 50, 1e-9);
+    EXPECT_TRUE(result.converged);
+    EXPECT_GT(result.intervals, 1);
+    EXPECT_EQ(result.evaluations % 15, 0);
+}
+
+TEST_F(IntegratorTests, EndPointSingularities)
+{
+    auto result = Integrator("ln(x)", "x").integrate(0, 1, 1e-8, 4);
+    EXPECT_NEAR(result.value, -1.0, 1e-7);
+    EXPECT_TRUE(result.singular);
+
+    result = Integrator("1/sqrt(x)", "x").integrate(0, 4, 1e-8, 4);
+    EXPECT_NEAR(result.value, 4.0, 1e-6);
+    EXPECT_TRUE(result.singular);
+}
+
+TEST_F(IntegratorTests, PoleIsFlagged)
+{
+    Integrator integrator("tan(x)", "x");
+    integrator.setMaxIntervals(200);
+    auto result = integrator.integrate(1, 2, 1e-10, 4);
+    EXPECT_TRUE(result.singular);
+    EXPECT_FALSE(result.converged);
+    EXPECT_LE(result.intervals, 200);
+}
+
+TEST_F(IntegratorTests, RejectsInvalidSettings)
+{
+    Integrator integrator("x^2", "x");
+    EXPECT_THROW(integrator.integrate(0, 1, 0), std::runtime_error);
+    EXPECT_THROW(integrator.integrate(0, 1, -1e-8), std::runtime_error);
+    EXPECT_THROW(integrator.integrate(0, 1, NAN), std::runtime_error);
+    EXPECT_THROW(integrator.setMaxIntervals(0), std::runtime_error);
+    EXPECT_THROW(integrator.setMaxIntervals(-1), std::runtime_error);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file interval_tests.cpp
+ * @brief Google Tests for interval.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "interval.hpp"
+#include "approx.hpp"
+#include "derivative.hpp"
+#include "flat_tree.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class IntervalTests : public SymbolicTest
+{
+protected:
+    // Every finite sample inside range must land inside the bound
+    void expectEncloses(std::string input, Interval range)
+    {
+        auto root = parseTree(input);
+        FlatTree tree(root);
+        Interval bound = Approx::bound(root, x, range);
+        Interval flatBound = Approx::bound(tree, x, range);
+        EXPECT_EQ(bound.lo, flatBound.lo) << input;
+        EXPECT_EQ(bound.hi, flatBound.hi) << input;
+        for (int idx = 0; idx <= 200; idx++)
+        {
+            double value = range.lo + (range.hi - range.lo) * idx / 200.0;
+            double sample = Approx::approximate(tree, x, value);
+            if (std::isfinite(sample))
+            {
+                EXPECT_TRUE(bound.contains(sample))
+                    << input << " at " << value << " = " << sample
+                    << " not in [" << bound.lo << ", " << bound.hi << "]";
+            }
+        }
+    }
+};
+
+TEST_F(IntervalTests, Arithmetic)
+{
+    Interval first(1.0, 2.0);
+    Interval second(-3.0, 4.0);
+    Interval sum = first + second;
+    EXPECT_LE(sum.lo, -2.0);
+    EXPECT_GE(sum.hi, 6.0);
+    Interval product = first * second;
+    EXPECT_LE(product.lo, -6.0);
+    EXPECT_GE(product.hi, 8.0);
+    EXPECT_FALSE(product.partial);
+    Interval quotient = first / Interval(2.0, 4.0);
+    EXPECT_LE(quotient.lo, 0.25);
+    EXPECT_GE(quotient.hi, 1.0);
+    EXPECT_LT(quotient.width(), 0.76);
+}
+
+TEST_F(IntervalTests, DomainErrorsDoNotThrow)
+{
+    Interval zeroDivisor = Interval(1.0) / Interval(-1.0, 1.0);
+    EXPECT_TRUE(zeroDivisor.partial);
+    EXPECT_TRUE(std::isinf(zeroDivisor.hi));
+
+    EXPECT_TRUE(Interval::ln(Interval(-2.0, -1.0)).isEmpty());
+    Interval clipped = Interval::sqrt(Interval(-1.0, 4.0));
+    EXPECT_TRUE(clipped.partial);
+    EXPECT_EQ(clipped.lo, 0.0);
+    EXPECT_GE(clipped.hi, 2.0);
+
+    Interval pole = Interval::tan(Interval(1.0, 2.0));
+    EXPECT_TRUE(pole.partial);
+    EXPECT_TRUE(std::isinf(pole.lo) && std::isinf(pole.hi));
+    EXPECT_FALSE(Interval::tan(Interval(-1.0, 1.0)).partial);
+
+    auto root = parseTree("ln(x)/(x-1)");
+    EXPECT_NO_THROW(Approx::bound(root, x, Interval(-2.0, 3.0)));
+    EXPECT_TRUE(Approx::bound(root, x, Interval(-2.0, 3.0)).partial);
+    EXPECT_FALSE(Approx::bound(root, x, Interval(2.0, 3.0)).partial);
+}
+
+TEST_F(IntervalTests, NegativeBaseKeepsIntegerPowers)
+{
+    // (-2)^3 and (-1)^2 are real values of [-2,-1]^[2,3]
+    Interval power = Interval::pow(Interval(-2.0, -1.0), Interval(2.0, 3.0));
+    EXPECT_TRUE(power.partial);
+    EXPECT_TRUE(power.contains(-8.0));
+    EXPECT_TRUE(power.contains(-1.0));
+    EXPECT_TRUE(power.contains(4.0));
+    EXPECT_TRUE(power.contains(1.0));
+
+    Interval mixed = Interval::pow(Interval(-2.0, 3.0), Interval(2.0, 3.0));
+    EXPECT_TRUE(mixed.contains(-8.0));
+    EXPECT_TRUE(mixed.contains(27.0));
+
+    // No integer exponent, no real value
+    EXPECT_TRUE(Interval::pow(Interval(-2.0, -1.0),
+                                        Interval(2.25, 2.75)).isEmpty());
+    EXPECT_TRUE(std::isinf(Interval::pow(Interval(-2.0, -1.0),
+                                        Interval(0.0, INFINITY)).hi));
+}
+
+TEST_F(IntervalTests, Periodic)
+{
+    Interval peak = Interval::sin(Interval(1.0, 2.0));
+    EXPECT_EQ(peak.hi, 1.0);
+    EXPECT_LE(peak.lo, std::sin(1.0));
+    Interval full = Interval::cos(Interval(-10.0, 10.0));
+    EXPECT_EQ(full.lo, -1.0);
+    EXPECT_EQ(full.hi, 1.0);
+}
+
+TEST_F(IntervalTests, EnclosesSamples)
+{
+    expectEncloses("x^2*sin(x)+x^3", Interval(-2.0, 3.0));
+    expectEncloses("exp(2*x)*cos(3*x)", Interval(-1.0, 1.5));
+    expectEncloses("sqrt(x)+ln(x)", Interval(0.5, 4.0));
+    expectEncloses("x^0.5*2^x", Interval(0.0, 3.0));
+    expectEncloses("tan(x)/x", Interval(0.1, 1.4));
+    expectEncloses("sec(x)+csc(x)+cot(x)", Interval(0.2, 1.3));
+    expectEncloses("log(x)-x^2", Interval(1.0, 5.0));
+    expectEncloses("1/(x-1)", Interval(-3.0, 0.5));
+}
@@ -0,0 +1,65 @@
+/**
+ * @file jacobian_tests.cpp
+ * @brief Google Tests for jacobian.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "jacobian.hpp"
+#include "derivative.hpp"
+#include "flat_tree.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class JacobianTests : public SymbolicTest
+{
+protected:
+    std::map<std::string, double> point = {{"x", 1.3}, {"y", 0.7},
+                                                            {"z", 2.1}};
+
+    double evaluate(nodePtr root)
+    {
+        FlatTree tree(root);
+        std::vector<double> slots;
+        for (const auto& var : tree.getVariables())
+        {
+            slots.push_back(point.at(var->getFullStr()));
+        }
+        return tree.evaluate(slots.data());
+    }
+};
+
+TEST_F(JacobianTests, MatchesSeparateDerivatives)
+{
+    std::vector<std::string> inputs = {"x^2*y+sin(x*y)",
+                                        "exp(z)*sin(x*y)-y/z",
+                                        "ln(x)+z^3"};
+    std::vector<std::string> wrt = {"x", "y", "z"};
+    auto entries = Jacobian(inputs, wrt, 2).solve();
+    ASSERT_EQ(entries.size(), inputs.size());
+    for (int row = 0; row < inputs.size(); row++)
+    {
+        ASSERT_EQ(entries[row].size(), wrt.size());
+        for (int col = 0; col < wrt.size(); col++)
+        {
+            auto expected = Derivative(inputs[row], wrt[col]).solve();
+            EXPECT_NEAR(evaluate(entries[row][col]), evaluate(expected), 1e-9)
+                << inputs[row] << " d/d" << wrt[col];
+        }
+    }
+}
+
+TEST_F(JacobianTests, Gradient)
+{
+    auto gradient = Jacobian::gradient("x*y*z", {"x", "y", "z"});
+    ASSERT_EQ(gradient.size(), 3);
+    EXPECT_NEAR(evaluate(gradient[0]), 0.7 * 2.1, 1e-9);
+    EXPECT_NEAR(evaluate(gradient[1]), 1.3 * 2.1, 1e-9);
+    EXPECT_NEAR(evaluate(gradient[2]), 1.3 * 0.7, 1e-9);
+}
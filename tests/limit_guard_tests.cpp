@@ -0,0 +1,149 @@
+/**
+ * @file limit_guard_tests.cpp
+ * @brief Google Tests for limit_guard.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "limit_guard.hpp"
+#include "derivative.hpp"
+#include "text_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+class LimitGuardTests : public SymbolicTest
+{
+};
+
+// Nested quotients, one quotient rule per level
+static std::string nestedQuotient(int depth)
+{
+    std::string out = "x";
+    for (int idx = 0; idx < depth; idx++)
+    {
+        out = "(" + out + ")/(x+" + std::to_string(idx + 1) + ")";
+    }
+    return out;
+}
+
+// A continued fraction, x/(1 + x/(2 + ...)): + and / alternate, so no
+// chain is flattened and the tree stays two levels deeper per fraction
+static std::string continuedFraction(int depth)
+{
+    std::string out = "x";
+    for (int idx = 0; idx < depth; idx++)
+    {
+        out = "x/(" + std::to_string(idx + 1) + "+" + out + ")";
+    }
+    return out;
+}
+
+static std::string differentiate(const std::string& input)
+{
+    Derivative engine(input, "x");
+    engine.log.setEnabled(false);
+    return TextConverter::convertToText(engine.solve());
+}
+
+static LimitExceeded::Limit limitHit(const std::string& input,
+                                                        const Limits& limits)
+{
+    LimitGuard guard(limits);
+    LimitGuard::Scope scope(&guard);
+    try
+    {
+        differentiate(input);
+    }
+    catch (const LimitExceeded& e)
+    {
+        EXPECT_GT(e.getStats().nodes, 0);
+        EXPECT_GT(e.getStats().depth, 0);
+        return e.getLimit();
+    }
+    ADD_FAILURE() << "No limit was exceeded";
+    return LimitExceeded::Limit::DEADLINE;
+}
+
+TEST_F(LimitGuardTests, StopsAtNodeBudget)
+{
+    Limits limits;
+    limits.maxNodes = 100;
+    EXPECT_EQ(limitHit(nestedQuotient(12), limits),
+                                            LimitExceeded::Limit::NODES);
+    // Nothing is left installed once the scope has gone
+    EXPECT_EQ(LimitGuard::current(), nullptr);
+    EXPECT_EQ(LimitGuard::depth(), 0);
+}
+
+TEST_F(LimitGuardTests, StopsAtDepth)
+{
+    Limits limits;
+    limits.maxDepth = 20;
+    EXPECT_EQ(limitHit(continuedFraction(30), limits),
+                                            LimitExceeded::Limit::DEPTH);
+    EXPECT_EQ(LimitGuard::depth(), 0);
+}
+
+TEST_F(LimitGuardTests, StopsAtDeadline)
+{
+    Limits limits;
+    limits.seconds = 1e-9;
+    EXPECT_EQ(limitHit(nestedQuotient(12), limits),
+                                            LimitExceeded::Limit::DEADLINE);
+}
+
+TEST_F(LimitGuardTests, ReportsStatsInMessage)
+{
+    Limits limits;
+    limits.maxNodes = 10;
+    LimitGuard guard(limits);
+    LimitGuard::Scope scope(&guard);
+    try
+    {
+        differentiate("sin(x)*cos(x)+x^3");
+        FAIL() << "No limit was exceeded";
+    }
+    catch (const LimitExceeded& e)
+    {
+        EXPECT_EQ(e.getStats().nodes, 11);
+        EXPECT_EQ(std::string(e.what()).find("Node limit exceeded: 11 nodes"),
+                                                                        0u);
+    }
+}
+
+TEST_F(LimitGuardTests, LeavesResultsAlone)
+{
+    std::string input = nestedQuotient(6) + "+sin(x^2)*exp(x)";
+    std::string expected = differentiate(input);
+
+    Limits limits;
+    limits.maxNodes = 1000000;
+    limits.maxDepth = 1000;
+    limits.seconds = 60.0;
+    LimitGuard guard(limits);
+    {
+        LimitGuard::Scope scope(&guard);
+        EXPECT_EQ(differentiate(input), expected);
+    }
+    LimitStats stats = guard.getStats();
+    EXPECT_GT(stats.nodes, 0);
+    EXPECT_GT(stats.depth, 6);
+    EXPECT_LT(stats.depth, 1000);
+}
+
+TEST_F(LimitGuardTests, ScopesNest)
+{
+    LimitGuard outer(Limits{});
+    LimitGuard inner(Limits{});
+    LimitGuard::Scope outerScope(&outer);
+    {
+        LimitGuard::Scope innerScope(&inner);
+        EXPECT_EQ(LimitGuard::current(), &inner);
+        // A null guard keeps the installed one
+        LimitGuard::Scope keep(nullptr);
+        EXPECT_EQ(LimitGuard::current(), &inner);
+    }
+    EXPECT_EQ(LimitGuard::current(), &outer);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file nary_node_tests.cpp
+ * @brief Google Tests for nary_node.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "nary_node.hpp"
+#include "equivalence.hpp"
+#include "derivative.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+
+class NaryNodeTests : public SymbolicTest
+{
+protected:
+    typedef NaryNode::naryPtr naryPtr;
+
+    naryPtr getNary(std::string input)
+    {
+        return NaryNode::build(parseTree(input));
+    }
+
+    int binaryDepth(const nodePtr& node)
+    {
+        if (!node)
+        {
+            return 0;
+        }
+        return 1 + std::max(binaryDepth(node->getLeft()),
+                            binaryDepth(node->getRight()));
+    }
+};
+
+TEST_F(NaryNodeTests, FlattensAndSorts)
+{
+    auto first = getNary("x+y+z");
+    auto second = getNary("z+(y+x)");
+    EXPECT_TRUE(first->isSum());
+    EXPECT_EQ(first->getOperands().size(), 3);
+    EXPECT_EQ(first->getHash(), second->getHash());
+    EXPECT_TRUE(first->equals(*second));
+    EXPECT_TRUE(getNary("x*y*z")->equals(*getNary("z*(x*y)")));
+    EXPECT_FALSE(getNary("x-y")->equals(*getNary("y-x")));
+}
+
+TEST_F(NaryNodeTests, CollectsLikeTerms)
+{
+    EXPECT_EQ(getNary("x+x+2*x")->toString(), "4*x");
+    EXPECT_EQ(getNary("x*x*x")->toString(), "x^3");
+    EXPECT_EQ(getNary("x-x")->toString(), "0");
+    EXPECT_EQ(getNary("x/x")->toString(), "1");
+    EXPECT_EQ(getNary("2+3*4")->toString(), "14");
+    EXPECT_EQ(getNary("x^2*x^3/x")->toString(), "x^4");
+    EXPECT_EQ(getNary("3*x*y-y*x")->toString(), "2*x*y");
+    EXPECT_EQ(getNary("x/y")->toString(), "x/y");
+}
+
+TEST_F(NaryNodeTests, DerivativesMatchBinaryEngine)
+{
+    for (std::string input : {"x^3+2*x^2-5*x+7", "x*sin(x)*exp(x)",
+                    "cos(x)/(x^2+1)", "tan(x)*ln(x)", "sqrt(x)*sec(x)",
+                    "x^3*sin(x)*exp(x)+cos(x)/(x^2+1)", "2^x*csc(x)"})
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        auto expected = engine.solve();
+        auto derivative = getNary(input)->differentiate(x)->toBinary();
+        EXPECT_TRUE(Equivalence::equivalent(derivative, expected)) << input;
+    }
+}
+
+TEST_F(NaryNodeTests, ProductRuleIsLinear)
+{
+    std::vector<naryPtr> factors;
+    for (int offset = 1; offset <= 64; offset++)
+    {
+        factors.push_back(NaryNode::sum({NaryNode::variable(x),
+                                            NaryNode::number(offset)}));
+    }
+    auto derivative = NaryNode::product(factors)->differentiate(x);
+
+    // Distinct nodes: the prefix and suffix products are shared by the terms
+    std::unordered_set<const NaryNode*> seen;
+    std::vector<const NaryNode*> pending{derivative.get()};
+    while (!pending.empty())
+    {
+        const NaryNode* node = pending.back();
+        pending.pop_back();
+        if (seen.insert(node).second)
+        {
+            for (const auto& operand : node->getOperands())
+            {
+                pending.push_back(operand.get());
+            }
+        }
+    }
+    EXPECT_LE(seen.size(), 8 * factors.size());
+    EXPECT_EQ(derivative->getOperands().size(), factors.size());
+}
+
+TEST_F(NaryNodeTests, LogarithmKeepsBase)
+{
+    auto derivative = getNary("log_2(x)")->differentiate(x);
+    EXPECT_TRUE(Equivalence::equivalent(derivative->toBinary(),
+                                        parseTree("1/(x*ln(2))")));
+    EXPECT_EQ(getNary("log_2(x)")->toString(), "log_2(x)");
+}
+
+TEST_F(NaryNodeTests, BalancedBinaryTree)
+{
+    std::vector<naryPtr> terms;
+    for (int power = 1; power <= 1000; power++)
+    {
+        terms.push_back(NaryNode::product({NaryNode::number(power),
+                NaryNode::power(NaryNode::variable(x),
+                                                NaryNode::number(power))}));
+    }
+    auto polynomial = NaryNode::sum(terms);
+    EXPECT_EQ(polynomial->getOperands().size(), 1000);
+    EXPECT_EQ(polynomial->depth(), 4);
+
+    auto root = polynomial->toBinary();
+    // ceil(log2(1000)) levels of +, then c*x^k
+    EXPECT_LE(binaryDepth(root), 10 + 3);
+    EXPECT_TRUE(NaryNode::build(root)->equals(*polynomial));
+}
+
+TEST_F(NaryNodeTests, RoundTripsNegatives)
+{
+    auto tree = getNary("x-y*2-z/3")->toBinary();
+    EXPECT_TRUE(Equivalence::equivalent(tree, parseTree("x-2*y-z/3")));
+    auto negative = getNary("0-x-y")->toBinary();
+    EXPECT_TRUE(Equivalence::equivalent(negative, parseTree("0-(x+y)")));
+}
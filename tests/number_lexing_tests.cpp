@@ -0,0 +1,95 @@
+/**
+ * @file number_lexing_tests.cpp
+ * @brief Google Tests for Tokenizer::parseNumber
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "tokenizer.hpp"
+#include "token.hpp"
+#include "derivative.hpp"
+#include "approx.hpp"
+#include "text_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <memory>
+
+class NumberLexingTests : public SymbolicTest
+{
+};
+
+static std::shared_ptr<Number> onlyNumber(const std::string& input)
+{
+    Tokenizer parser(input);
+    TokenVector tokens = parser.tokenize();
+    EXPECT_EQ(tokens.size(), 1u);
+    auto number = std::dynamic_pointer_cast<Number>(tokens[0]);
+    EXPECT_TRUE(number != nullptr);
+    return number;
+}
+
+TEST_F(NumberLexingTests, IntegersAndDecimals)
+{
+    auto integer = onlyNumber("42");
+    ASSERT_TRUE(integer->isInt());
+    EXPECT_EQ(integer->getInt(), 42);
+
+    auto decimal = onlyNumber("3.25");
+    ASSERT_TRUE(decimal->isDouble());
+    EXPECT_DOUBLE_EQ(decimal->getDouble(), 3.25);
+    EXPECT_EQ(decimal->getStr(), "3.25");
+
+    EXPECT_THROW(Tokenizer("1.2.3").tokenize(), std::runtime_error);
+}
+
+TEST_F(NumberLexingTests, ScientificNotation)
+{
+    auto small = onlyNumber("1.2345e-07");
+    ASSERT_TRUE(small->isDouble());
+    EXPECT_DOUBLE_EQ(small->getDouble(), 1.2345e-07);
+    EXPECT_EQ(small->getStr(), "1.2345e-07");
+
+    EXPECT_DOUBLE_EQ(onlyNumber("2e3")->getDouble(), 2000.0);
+    EXPECT_DOUBLE_EQ(onlyNumber("5E+2")->getDouble(), 500.0);
+
+    // Without exponent digits the e is still Euler's number
+    Tokenizer parser("2e");
+    TokenVector tokens = parser.tokenize();
+    ASSERT_GT(tokens.size(), 1u);
+    EXPECT_EQ(std::dynamic_pointer_cast<Number>(tokens[0])->getInt(), 2);
+}
+
+TEST_F(NumberLexingTests, WideIntegersBecomeDoubles)
+{
+    auto wide = onlyNumber("12345678901");
+    ASSERT_TRUE(wide->isDouble());
+    EXPECT_DOUBLE_EQ(wide->getDouble(), 12345678901.0);
+    EXPECT_EQ(wide->getStr(), "12345678901");
+
+    auto huge = onlyNumber("123456789012345678901234567890");
+    ASSERT_TRUE(huge->isDouble());
+    EXPECT_DOUBLE_EQ(huge->getDouble(), 1.2345678901234568e29);
+
+    EXPECT_THROW(Tokenizer("1e999").tokenize(), std::runtime_error);
+}
+
+TEST_F(NumberLexingTests, WideIntegersSurviveFolding)
+{
+    for (std::string input : {"3000000000*x", "99999999999*x",
+                                                        "2*x*3000000000"})
+    {
+        Derivative engine(input, "x");
+        engine.log.setEnabled(false);
+        auto derivative = engine.solve();
+        double expected = input[0] == '2' ? 6e9 : std::stod(input);
+        EXPECT_DOUBLE_EQ(Approx::approximate(derivative, x, 1.0),
+                                                        expected) << input;
+    }
+    // Folding 2*3000000000 must not wrap around to a negative int
+    Derivative engine("x*(2*3000000000)", "x");
+    engine.log.setEnabled(false);
+    EXPECT_EQ(TextConverter::convertToText(engine.solve()), "6000000000");
+}
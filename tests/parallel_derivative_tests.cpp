@@ -0,0 +1,86 @@
+/**
+ * @file parallel_derivative_tests.cpp
+ * @brief Google Tests for forked solves in derivative.cpp and for
+ * ThreadPool::join
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "derivative.hpp"
+#include "thread_pool.hpp"
+#include "text_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+class ParallelDerivativeTests : public SymbolicTest
+{
+};
+
+// A sum of count terms, each well over the parallel threshold
+static std::string wideSum(int count)
+{
+    std::string out;
+    for (int idx = 1; idx <= count; idx++)
+    {
+        std::string k = std::to_string(idx);
+        out += (idx > 1 ? "+" : "") + ("sin(x^2+" + k + ")*exp(cos(x*" + k +
+                    "))*(x^3+" + k + "*x^2+x+" + k + ")/(x^2+" + k +
+                    ")*ln(x^4+" + k + ")*sqrt(x^2+" + k + "*x+" + k +
+                    ")*tan(x+" + k + ")");
+    }
+    return out;
+}
+
+static std::string differentiate(const std::string& input, int threads)
+{
+    Derivative engine(input, "x");
+    engine.log.setEnabled(false);
+    engine.setThreads(threads);
+    return TextConverter::convertToText(engine.solve());
+}
+
+TEST_F(ParallelDerivativeTests, MatchesSequential)
+{
+    std::string input = wideSum(16);
+    std::string expected = differentiate(input, 1);
+    EXPECT_EQ(differentiate(input, 4), expected);
+    // More tasks than workers, forks nest inside forks
+    EXPECT_EQ(differentiate(input, 2), expected);
+}
+
+TEST_F(ParallelDerivativeTests, LoggedSolvesStaySequential)
+{
+    Derivative engine(wideSum(4), "x");
+    engine.setThreads(4);
+    auto derivative = engine.solve();
+    EXPECT_NE(engine.log.out().find("\"Rule\": \"chain\""),
+                                                        std::string::npos);
+    EXPECT_EQ(TextConverter::convertToText(derivative),
+                                            differentiate(wideSum(4), 1));
+}
+
+TEST_F(ParallelDerivativeTests, JoinRunsNestedTasks)
+{
+    // Every task waits on two more, one worker must not deadlock
+    ThreadPool pool(1);
+    std::function<int(int)> count = [&](int depth) {
+        if (depth == 0)
+        {
+            return 1;
+        }
+        auto left = pool.submit([&, depth]() { return count(depth - 1); });
+        auto right = pool.submit([&, depth]() { return count(depth - 1); });
+        return pool.join(left) + pool.join(right);
+    };
+    auto root = pool.submit([&]() { return count(8); });
+    EXPECT_EQ(pool.join(root), 256);
+
+    auto failing = pool.submit([]() -> int {
+        throw std::runtime_error("failed");
+    });
+    EXPECT_THROW(pool.join(failing), std::runtime_error);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file result_tests.cpp
+ * @brief Google Tests for the try* forms of the tokenizer, parser,
+ * simplifier, differentiator and evaluator
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "result.hpp"
+#include "tokenizer.hpp"
+#include "tree_fixer.hpp"
+#include "derivative.hpp"
+#include "approx.hpp"
+#include "bindings.hpp"
+#include "flat_tree.hpp"
+#include "text_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+class ResultTests : public SymbolicTest
+{
+};
+
+static Error parseError(const std::string& input)
+{
+    auto root = ExpressionNode::tryParse(input);
+    EXPECT_FALSE(root.ok()) << input;
+    return root.ok() ? Error{Error::Code::DOMAIN, ""} : root.error();
+}
+
+TEST_F(ResultTests, ReportsTokenizerErrors)
+{
+    auto parsed = Tokenizer("1.2.3").tryTokenize();
+    ASSERT_FALSE(parsed.ok());
+    EXPECT_EQ(parsed.error().code, Error::Code::SYNTAX);
+    EXPECT_EQ(parsed.error().message, "Multiple decimal points in number");
+
+    EXPECT_EQ(parseError("sin_2(x)").message,
+                        "Only log function can have subscript, not \"sin\"!");
+    EXPECT_EQ(parseError("log_x(x)").message,
+                        "Bad subscript! logarithm must have numeric base");
+    EXPECT_EQ(parseError("x_+").message, "Invalid variable subscript: +");
+
+    auto good = Tokenizer("2x+sin(x)").tryTokenize();
+    ASSERT_TRUE(good.ok());
+    EXPECT_EQ(good.value().size(), 5);
+}
+
+TEST_F(ResultTests, ReportsMismatchedParentheses)
+{
+    EXPECT_EQ(parseError("(x").message, "Mismatched parentheses");
+    EXPECT_EQ(parseError("2*x+(3").message, "Mismatched parentheses");
+    // A closing parenthesis with nothing open
+    EXPECT_EQ(parseError("x)").message, "Mismatched parentheses");
+    EXPECT_EQ(parseError("sin(x))").message, "Mismatched parentheses");
+}
+
+TEST_F(ResultTests, ReportsIncompleteTrees)
+{
+    EXPECT_EQ(parseError("x+").code, Error::Code::SYNTAX);
+    EXPECT_EQ(parseError("*x").code, Error::Code::SYNTAX);
+    EXPECT_EQ(parseError("").message, "Node is nullptr");
+}
+
+TEST_F(ResultTests, ReportsUndefinedConstants)
+{
+    auto root = ExpressionNode::tryParse("x+1/0");
+    ASSERT_TRUE(root.ok());
+    auto simplified = TreeFixer::trySimplify(root.value());
+    ASSERT_FALSE(simplified.ok());
+    EXPECT_EQ(simplified.error().code, Error::Code::DOMAIN);
+    EXPECT_EQ(simplified.error().message,
+                                        "Undefined arithmetic: divide by 0");
+
+    auto power = Derivative::trySolve("x*0^0", "x");
+    ASSERT_FALSE(power.ok());
+    EXPECT_EQ(power.error().message, "Undefined arithmetic: 0^0");
+}
+
+TEST_F(ResultTests, SolvesLikeTheThrowingForm)
+{
+    for (std::string input : {"x^2*sin(x)", "ln(x^2+1)/(x-4)",
+                                                        "exp(2x)+3x^4-7"})
+    {
+        auto derivative = Derivative::trySolve(input, "x");
+        ASSERT_TRUE(derivative.ok()) << input;
+        Derivative engine(input, "x");
+        EXPECT_EQ(TextConverter::convertToText(derivative.value()),
+                    TextConverter::convertToText(engine.solve())) << input;
+    }
+    EXPECT_EQ(Derivative::trySolve("x^2", "2").error().code,
+                                                    Error::Code::SYNTAX);
+}
+
+TEST_F(ResultTests, WrappersStillThrow)
+{
+    EXPECT_THROW(Derivative("x+1/0", "x"), std::runtime_error);
+    EXPECT_THROW(Derivative("(x", "x"), std::runtime_error);
+    EXPECT_THROW(Derivative("x)", "x"), std::runtime_error);
+    try
+    {
+        Derivative("x", "x+y");
+        FAIL() << "No error for a bad variable";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_EQ(std::string(e.what()).find("Invalid differentiating"), 0u);
+    }
+}
+
+TEST_F(ResultTests, ReportsEvaluationErrors)
+{
+    auto root = ExpressionNode::tryParse("a/(x-1)");
+    ASSERT_TRUE(root.ok());
+    FlatTree tree(root.value());
+
+    auto unbound = Approx::tryApproximate(tree, Bindings::parse("x=2"));
+    ASSERT_FALSE(unbound.ok());
+    EXPECT_EQ(unbound.error().code, Error::Code::UNBOUND);
+
+    auto pole = Approx::tryApproximate(tree, Bindings::parse("a=1,x=1"));
+    ASSERT_FALSE(pole.ok());
+    EXPECT_EQ(pole.error().code, Error::Code::DOMAIN);
+
+    auto value = Approx::tryApproximate(tree, Bindings::parse("a=3,x=4"));
+    ASSERT_TRUE(value.ok());
+    EXPECT_DOUBLE_EQ(value.value(), 1.0);
+}
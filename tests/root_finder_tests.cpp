@@ -0,0 +1,125 @@
+/**
+ * @file root_finder_tests.cpp
+ * @brief Google Tests for root_finder.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "root_finder.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+class RootFinderTests : public SymbolicTest
+{
+protected:
+    void expectRoots(std::string input, double lo, double hi,
+                        std::vector<double> expected,
+                        RootFinder::Method method, double tolerance = 1e-9)
+    {
+        RootFinder finder(input, "x", method);
+        auto roots = finder.solve(lo, hi, 50, 4);
+        ASSERT_EQ(roots.size(), expected.size()) << input;
+        for (int idx = 0; idx < roots.size(); idx++)
+        {
+            EXPECT_NEAR(roots[idx].value, expected[idx], tolerance) << input;
+            EXPECT_GE(roots[idx].hits, 1);
+            EXPECT_LE(roots[idx].iterations, 100);
+        }
+    }
+};
+
+TEST_F(RootFinderTests, Polynomial)
+{
+    for (auto method : {RootFinder::Method::NEWTON,
+                                            RootFinder::Method::HALLEY})
+    {
+        expectRoots("x^3-2*x^2-5*x+6", -5, 5, {-2, 1, 3}, method);
+    }
+}
+
+TEST_F(RootFinderTests, Transcendental)
+{
+    for (auto method : {RootFinder::Method::NEWTON,
+                                            RootFinder::Method::HALLEY})
+    {
+        expectRoots("sin(x)", -7, 7, {-2 * PI, -PI, 0, PI, 2 * PI}, method);
+        expectRoots("exp(x)-2", -3, 3, {std::log(2.0)}, method);
+        expectRoots("ln(x)-1", 0.1, 5, {std::exp(1.0)}, method);
+    }
+}
+
+TEST_F(RootFinderTests, DoubleRootAndPoles)
+{
+    expectRoots("(x-1)^2", -2, 3, {1}, RootFinder::Method::NEWTON, 1e-5);
+    // The sign change across the pole at 0 is not a root
+    expectRoots("1/x", -1, 1, {}, RootFinder::Method::NEWTON);
+    expectRoots("x^2+1", -3, 3, {}, RootFinder::Method::HALLEY);
+}
+
+TEST_F(RootFinderTests, SlowStepsFallBackToBisection)
+{
+    // Newton steps on log(x)-2 barely shrink the bracket around 100, and
+    // end once they are below the tolerance rather than the error
+    RootFinder finder("log(x)-2", "x");
+    auto roots = finder.solve(1, 1000, 1, 1);
+    ASSERT_EQ(roots.size(), 1);
+    EXPECT_NEAR(roots[0].value, 100, 1e-6);
+    EXPECT_LT(roots[0].iterations, 100);
+
+    // Out of iterations before the tolerance is no root
+    finder.setMaxIterations(5);
+    EXPECT_TRUE(finder.solve(1, 1000, 1, 1).empty());
+}
+
+TEST_F(RootFinderTests, HalleyNeedsFewerIterations)
+{
+    RootFinder newton("exp(x)-10*x^3", "x", RootFinder::Method::NEWTON);
+    RootFinder halley("exp(x)-10*x^3", "x", RootFinder::Method::HALLEY);
+    auto slow = newton.solve(0.5, 1, 1, 1);
+    auto fast = halley.solve(0.5, 1, 1, 1);
+    ASSERT_EQ(slow.size(), 1);
+    ASSERT_EQ(fast.size(), 1);
+    EXPECT_NEAR(slow[0].value, fast[0].value, 1e-10);
+    EXPECT_LE(fast[0].iterations, slow[0].iterations);
+}
+
+TEST_F(RootFinderTests, BoundParameters)
+{
+    for (auto method : {RootFinder::Method::NEWTON,
+                                            RootFinder::Method::HALLEY})
+    {
+        RootFinder finder("x^2-a*x", "x", method);
+        finder.bind(Bindings::parse("a=3"));
+        auto roots = finder.solve(-5, 5, 50, 4);
+        ASSERT_EQ(roots.size(), 2);
+        EXPECT_NEAR(roots[0].value, 0, 1e-9);
+        EXPECT_NEAR(roots[1].value, 3, 1e-9);
+    }
+    RootFinder unbound("x-a*b", "x");
+    EXPECT_THROW(unbound.bind(Bindings::parse("a=3")), std::runtime_error);
+}
+
+TEST_F(RootFinderTests, LeavesCallerTreeAlone)
+{
+    // sin(-x), with the sign still on the argument's token
+    auto root = parseTree("sin(x)-1/2", false);
+    auto func = std::dynamic_pointer_cast<Function>(
+                                            root->getLeft()->getToken());
+    auto argument = func->getSubExprTree();
+    argument->getToken()->setNegative(true);
+
+    RootFinder finder(root, x);
+    EXPECT_EQ(func->getSubExprTree(), argument);
+    EXPECT_EQ(argument->getType(), TokenType::VARIABLE);
+    EXPECT_TRUE(argument->getToken()->isNegative());
+    auto roots = finder.solve(-3, 0, 50, 4);
+    ASSERT_EQ(roots.size(), 2);
+    EXPECT_NEAR(roots[0].value, -5 * PI / 6, 1e-9);
+    EXPECT_NEAR(roots[1].value, -PI / 6, 1e-9);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file specializer_tests.cpp
+ * @brief Google Tests for specializer.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "specializer.hpp"
+#include "approx.hpp"
+#include "token_pool.hpp"
+#include "text_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <memory>
+
+
+class SpecializerTests : public SymbolicTest
+{
+};
+
+TEST_F(SpecializerTests, FoldsBoundParameters)
+{
+    auto root = parseTree("exp(a*b)*sin(k*x)+(a+b)^2*x");
+    std::string before = TextConverter::convertToText(root);
+    auto special = Specializer::specialize(root,
+                                    Bindings::parse("a=0.5,b=2,k=3"));
+
+    // The input is untouched, only x is left
+    EXPECT_EQ(TextConverter::convertToText(root), before);
+    FlatTree tree(special);
+    ASSERT_EQ(tree.getVariables().size(), 1u);
+    EXPECT_EQ(tree.getVariables()[0]->getStr(), "x");
+    EXPECT_LT(tree.size(), FlatTree(root).size());
+
+    for (double value : {-1.0, 0.25, 2.0})
+    {
+        Bindings all = Bindings::parse("a=0.5,b=2,k=3");
+        all.set("x", value);
+        double expected = std::exp(1.0) * std::sin(3 * value) +
+                                                            6.25 * value;
+        EXPECT_NEAR(Approx::approximate(FlatTree(root), all), expected,
+                                                                    1e-12);
+        EXPECT_NEAR(Approx::approximate(tree, Bindings::parse(
+                    "x=" + std::to_string(value))), expected, 1e-12);
+    }
+}
+
+TEST_F(SpecializerTests, DropsIdentities)
+{
+    auto special = Specializer::specialize(parseTree("a*sin(x)+b*x^n"),
+                                        Bindings::parse("a=1,b=0,n=2"));
+    EXPECT_EQ(TextConverter::convertToText(special), "sin(x)");
+
+    auto partial = Specializer::specialize(parseTree("a*x+b"),
+                                                Bindings::parse("a=2"));
+    FlatTree tree(partial);
+    EXPECT_EQ(tree.getVariables().size(), 2u);
+}
+
+TEST_F(SpecializerTests, FoldsNonFiniteConstants)
+{
+    FlatTree tree = Specializer::compile(parseTree("x+1/a+ln(b)"),
+                                            Bindings::parse("a=0,b=-1"));
+    double value = 1.0;
+    EXPECT_TRUE(std::isnan(tree.evaluate(&value)));
+}
+
+TEST_F(SpecializerTests, KeepsExactNumbers)
+{
+    auto value = Specializer::makeNumber(0.1 + 0.2);
+    auto num = std::dynamic_pointer_cast<Number>(value->getToken());
+    EXPECT_EQ(num->getDouble(), 0.1 + 0.2);
+    EXPECT_EQ(num->getStr(), "0.30000000000000004");
+
+    auto negative = Specializer::makeNumber(-2.5);
+    EXPECT_EQ(std::dynamic_pointer_cast<Number>(
+                                negative->getToken())->getDouble(), -2.5);
+    EXPECT_EQ(Specializer::makeNumber(-1.0)->getToken(),
+                                                TokenPool::number(-1));
+}
@@ -0,0 +1,93 @@
+/**
+ * @file tabulator_tests.cpp
+ * @brief Google Tests for tabulator.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "tabulator.hpp"
+#include "approx.hpp"
+#include "derivative.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class TabulatorTests : public SymbolicTest
+{
+protected:
+    std::string input = "x^2*sin(x)+exp(x)/x";
+};
+
+TEST_F(TabulatorTests, ParseRange)
+{
+    auto range = Tabulator::parseRange("0:1:0.25");
+    EXPECT_EQ(range.count(), 5);
+    EXPECT_DOUBLE_EQ(range.at(4), 1.0);
+    EXPECT_EQ(Tabulator::parseRange("1:-1:-0.1").count(), 21);
+    EXPECT_THROW(Tabulator::parseRange("0:1"), std::runtime_error);
+    EXPECT_THROW(Tabulator::parseRange("0:1:0"), std::runtime_error);
+    EXPECT_THROW(Tabulator::parseRange("0:1:-1"), std::runtime_error);
+    EXPECT_THROW(Tabulator::parseRange("0:a:1"), std::runtime_error);
+}
+
+TEST_F(TabulatorTests, MatchesPointEvaluation)
+{
+    Tabulator table(input, "x");
+    auto range = Tabulator::parseRange("0.5:3:0.001");
+    std::vector<double> rows(3 * range.count());
+    table.tabulate(range, rows.data(), 3);
+
+    FlatTree function(Derivative(input, "x").solve());
+    for (std::size_t idx = 0; idx < range.count(); idx += 97)
+    {
+        double value = range.at(idx);
+        EXPECT_EQ(rows[3 * idx], value);
+        EXPECT_NEAR(rows[3 * idx + 2],
+                    Approx::approximate(function, x, value), 1e-9);
+    }
+    EXPECT_NEAR(rows[1], 0.25 * std::sin(0.5) + std::exp(0.5) / 0.5, 1e-12);
+}
+
+TEST_F(TabulatorTests, WritesBinaryAndCSV)
+{
+    Tabulator table(input, "x");
+    auto range = Tabulator::parseRange("1:2:0.0001");
+    std::vector<double> rows(3 * range.count());
+    table.tabulate(range, rows.data(), 2);
+
+    std::ostringstream binary;
+    table.write(binary, range, Tabulator::Format::BINARY, 4);
+    std::string bytes = binary.str();
+    ASSERT_EQ(bytes.size(), rows.size() * sizeof(double));
+    std::vector<double> read(rows.size());
+    std::memcpy(read.data(), bytes.data(), bytes.size());
+    EXPECT_EQ(read, rows);
+
+    std::ostringstream csv;
+    table.write(csv, range, Tabulator::Format::CSV, 4);
+    std::istringstream lines(csv.str());
+    std::string line;
+    std::getline(lines, line);
+    EXPECT_EQ(line, "x,f,df");
+    std::size_t count = 0;
+    while (std::getline(lines, line))
+    {
+        double first = 0;
+        double second = 0;
+        double third = 0;
+        char comma;
+        std::istringstream(line) >> first >> comma >> second >> comma
+                                                                    >> third;
+        EXPECT_EQ(first, rows[3 * count]);
+        EXPECT_EQ(third, rows[3 * count + 2]);
+        count++;
+    }
+    EXPECT_EQ(count, range.count());
+}
@@ -0,0 +1,121 @@
+/**
+ * @file taylor_tests.cpp
+ * @brief Google Tests for taylor.cpp and series.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "taylor.hpp"
+#include "approx.hpp"
+#include "derivative.hpp"
+#include "flat_tree.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class TaylorTests : public SymbolicTest
+{
+protected:
+    // The polynomial must match f near point up to the truncation error,
+    // and its slope must match the symbolic derivative
+    void expectExpansion(std::string input, double point)
+    {
+        Taylor taylor(input, "x");
+        auto polynomial = FlatTree(taylor.polynomial(point, 10));
+        auto function = FlatTree(Derivative(input, "x").solve());
+        EXPECT_NEAR(taylor.derivatives(point, 1)[1],
+                    Approx::approximate(function, x, point), 1e-9) << input;
+
+        Taylor exact(input, "x");
+        for (double offset : {-0.05, 0.02, 0.05})
+        {
+            double expected = exact.coefficients(point + offset, 0)[0];
+            EXPECT_NEAR(Approx::approximate(polynomial, x, point + offset),
+                        expected, 1e-10 * (1 + std::fabs(expected)))
+                << input << " at " << point + offset;
+        }
+    }
+};
+
+TEST_F(TaylorTests, KnownSeries)
+{
+    auto exp = Taylor("exp(x)", "x").coefficients(0, 6);
+    double factorial = 1;
+    for (int idx = 0; idx <= 6; idx++)
+    {
+        factorial *= idx == 0 ? 1 : idx;
+        EXPECT_NEAR(exp[idx], 1 / factorial, 1e-15);
+    }
+
+    auto sin = Taylor("sin(x)", "x").coefficients(0, 5);
+    EXPECT_NEAR(sin[1], 1, 1e-15);
+    EXPECT_NEAR(sin[3], -1.0 / 6, 1e-15);
+    EXPECT_NEAR(sin[5], 1.0 / 120, 1e-15);
+
+    auto ln = Taylor("ln(x)", "x").coefficients(1, 4);
+    EXPECT_NEAR(ln[0], 0, 1e-15);
+    EXPECT_NEAR(ln[2], -0.5, 1e-15);
+    EXPECT_NEAR(ln[4], -0.25, 1e-15);
+
+    auto root = Taylor("sqrt(x^2)", "x").coefficients(0, 3);
+    EXPECT_NEAR(root[1], 1, 1e-15);
+}
+
+TEST_F(TaylorTests, MatchesFunctionNearPoint)
+{
+    expectExpansion("x^2*sin(x)+exp(x)/x", 1.3);
+    expectExpansion("tan(x)*ln(x)", 0.7);
+    expectExpansion("sqrt(x)*sec(x)-cot(x)", 0.9);
+    expectExpansion("csc(x)+ln(x)", 1.1);
+
+    auto log = Taylor("log(x)", "x").coefficients(100, 1);
+    EXPECT_NEAR(log[0], 2, 1e-15);
+    EXPECT_NEAR(log[1], 1 / (100 * std::log(10.0)), 1e-15);
+
+    // x^x has a non-constant exponent, expanded through exp(x ln(x))
+    auto tower = Taylor("x^x", "x").derivatives(1.5, 1);
+    EXPECT_NEAR(tower[1], std::pow(1.5, 1.5) * (std::log(1.5) + 1), 1e-12);
+}
+
+TEST_F(TaylorTests, PolynomialEvaluatesToSeries)
+{
+    Taylor taylor("exp(x)*cos(x)", "x");
+    auto polynomial = taylor.polynomial(0.5, 8);
+    double approx = Approx::approximate(FlatTree(polynomial), x, 0.6);
+    EXPECT_NEAR(approx, std::exp(0.6) * std::cos(0.6), 1e-10);
+
+    // Lower orders come from the cached expansion
+    auto low = taylor.coefficients(0.5, 2);
+    EXPECT_EQ(low.size(), 3);
+    EXPECT_EQ(low[2], taylor.coefficients(0.5, 8)[2]);
+}
+
+TEST_F(TaylorTests, SingularPoint)
+{
+    Taylor taylor("1/x", "x");
+    EXPECT_THROW(taylor.coefficients(0, 2), std::domain_error);
+    EXPECT_THROW(taylor.polynomial(0, 2), std::domain_error);
+    EXPECT_NEAR(taylor.coefficients(1, 2)[2], 1, 1e-15);
+}
+
+TEST_F(TaylorTests, LeavesCallerTreeAlone)
+{
+    // sin(-x), with the sign still on the argument's token
+    auto root = parseTree("sin(x)", false);
+    auto func = std::dynamic_pointer_cast<Function>(root->getToken());
+    auto argument = func->getSubExprTree();
+    argument->getToken()->setNegative(true);
+
+    auto sin = Taylor(root, x).coefficients(0, 3);
+    EXPECT_EQ(func->getSubExprTree(), argument);
+    EXPECT_EQ(argument->getType(), TokenType::VARIABLE);
+    EXPECT_TRUE(argument->getToken()->isNegative());
+    EXPECT_NEAR(sin[1], -1, 1e-15);
+    EXPECT_NEAR(sin[3], 1.0 / 6, 1e-15);
+}
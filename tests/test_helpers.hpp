@@ -0,0 +1,70 @@
+/**
+ * @file test_helpers.hpp
+ * @brief Parsing helper and base fixture shared by the Google Tests
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#ifndef __TEST_HELPERS_HPP__
+#define __TEST_HELPERS_HPP__
+
+#include "expression_node.hpp"
+#include "tokenizer.hpp"
+#include "postfix.hpp"
+#include "tree_fixer.hpp"
+#include "arithmetic.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Parses input into a tree, neither checked nor simplified unless
+ * asked for.
+ *
+ * @param check run TreeFixer::checkTree, as every entry point does.
+ */
+inline std::shared_ptr<ExpressionNode> parseTree(const std::string& input,
+                                                        bool check = true)
+{
+    Tokenizer parser(input);
+    auto parsed = parser.tokenize();
+    ShuntingYard converter(parsed);
+    auto root = ExpressionNode::buildTree(converter.getPostfix());
+    if (check)
+    {
+        TreeFixer::checkTree(root);
+    }
+    return root;
+}
+
+/**
+ * @brief Fixture for tests that fold constants: they run with
+ * Arithmetic::floatSimplification off, as the command line does, and the
+ * flag is restored afterwards.
+ */
+class SymbolicTest : public ::testing::Test
+{
+protected:
+    typedef std::shared_ptr<ExpressionNode> nodePtr;
+
+    const double PI = 3.14159265358979323846;
+    //! The variable most tests differentiate and evaluate by
+    std::shared_ptr<Variable> x = std::make_shared<Variable>("x");
+
+    void SetUp() override
+    {
+        this->floatSimplification = Arithmetic::floatSimplification;
+        Arithmetic::floatSimplification = false;
+    }
+
+    void TearDown() override
+    {
+        Arithmetic::floatSimplification = this->floatSimplification;
+    }
+
+private:
+    bool floatSimplification = true;
+};
+
+#endif // __TEST_HELPERS_HPP__
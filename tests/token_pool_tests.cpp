@@ -0,0 +1,102 @@
+/**
+ * @file token_pool_tests.cpp
+ * @brief Google Tests for token_pool.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "token_pool.hpp"
+#include "derivative.hpp"
+#include "text_converter.hpp"
+#include "operation.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <memory>
+
+
+class TokenPoolTests : public SymbolicTest
+{
+};
+
+TEST_F(TokenPoolTests, SharesSmallIntegers)
+{
+    EXPECT_EQ(TokenPool::number(0), TokenPool::number(0));
+    EXPECT_EQ(TokenPool::number(2), TokenPool::number(2));
+    EXPECT_TRUE(TokenPool::number(TokenPool::MAX_INTEGER)->isPooled());
+    EXPECT_NE(TokenPool::number(1000), TokenPool::number(1000));
+    EXPECT_FALSE(TokenPool::number(1000)->isPooled());
+
+    EXPECT_EQ(TokenPool::number(-1)->getInt(), -1);
+    EXPECT_EQ(TokenPool::number(-1)->getFullStr(), "-1");
+    EXPECT_EQ(TokenPool::number(-20)->getInt(), -20);
+    EXPECT_EQ(TokenPool::number(7)->getFullStr(), "7");
+}
+
+TEST_F(TokenPoolTests, SharesOperators)
+{
+    for (std::string op : {"+", "-", "*", "/", "^"})
+    {
+        EXPECT_EQ(TokenPool::op(op), TokenPool::op(op));
+        EXPECT_EQ(TokenPool::op(op)->getStr(), op);
+    }
+    EXPECT_EQ(TokenPool::op("^")->getAssociativity(), Associativity::RIGHT);
+    EXPECT_THROW(TokenPool::op("sin"), std::runtime_error);
+    EXPECT_THROW(TokenPool::op("**"), std::runtime_error);
+}
+
+TEST_F(TokenPoolTests, PooledTokensNeverChange)
+{
+    auto two = TokenPool::number(2);
+    EXPECT_THROW(two->flipSign(), std::runtime_error);
+    EXPECT_THROW(TokenPool::op("*")->setNegative(true), std::runtime_error);
+    EXPECT_FALSE(two->isNegative());
+    EXPECT_EQ(two->getInt(), 2);
+
+    // Copies are private and can change
+    auto copy = std::dynamic_pointer_cast<Number>(two->clone());
+    EXPECT_FALSE(copy->isPooled());
+    copy->flipSign();
+    EXPECT_EQ(copy->getInt(), -2);
+    EXPECT_EQ(two->getInt(), 2);
+}
+
+TEST_F(TokenPoolTests, NegativeConstantsFold)
+{
+    Derivative engine("x*(2-5)", "x");
+    engine.log.setEnabled(false);
+    EXPECT_EQ(TextConverter::convertToText(engine.solve()), "-3");
+}
+
+TEST_F(TokenPoolTests, NegatingSimplifiedConstants)
+{
+    // x*0 and x^0 come back as the pooled 0 and 1
+    auto zero = TreeFixer::simplify(parseTree("x*0"));
+    auto one = TreeFixer::simplify(parseTree("x^0"));
+    ASSERT_TRUE(zero->getToken()->isPooled());
+    ASSERT_TRUE(one->getToken()->isPooled());
+    auto negated = TreeFixer::simplify(Operation::subtract(zero, one));
+    EXPECT_EQ(TextConverter::convertToText(negated), "-1");
+    EXPECT_EQ(TextConverter::convertToText(zero), "0");
+    EXPECT_EQ(TextConverter::convertToText(one), "1");
+
+    // 0-u negates the pooled operator of u, checkTree then expands it
+    auto product = TreeFixer::simplify(parseTree("0-x*y"));
+    TreeFixer::checkTree(product);
+    EXPECT_EQ(TextConverter::convertToText(product), "-1*(x*y)");
+    EXPECT_FALSE(TokenPool::op("*")->isNegative());
+
+    // Expanding a shared -x keeps its value in every tree holding it,
+    // and the token it started from stays negative
+    auto x = parseTree("x", false);
+    auto token = x->getToken();
+    token->setNegative(true);
+    auto first = Operation::add(x, TreeFixer::simplify(parseTree("x^0")));
+    auto second = Operation::times(parseTree("y"), x);
+    TreeFixer::checkTree(first);
+    EXPECT_EQ(TextConverter::convertToText(first), "(-1*x)+1");
+    EXPECT_EQ(TextConverter::convertToText(second), "y*(-1*x)");
+    EXPECT_TRUE(token->isNegative());
+}
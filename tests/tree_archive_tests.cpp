@@ -0,0 +1,202 @@
+/**
+ * @file tree_archive_tests.cpp
+ * @brief Google Tests for tree_archive.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "tree_archive.hpp"
+#include "latex_converter.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <vector>
+
+
+class TreeArchiveTests : public SymbolicTest
+{
+protected:
+    std::vector<std::string> inputs = {"x^2*sin(x)+exp(x)/(x+1)",
+                                        "x*y-3.5", "2-x*4"};
+
+    // Keeps the encoded buffer 8-byte aligned
+    std::vector<double> aligned(const std::string& encoded)
+    {
+        std::vector<double> out((encoded.size() + 7) / 8);
+        std::memcpy(out.data(), encoded.data(), encoded.size());
+        return out;
+    }
+};
+
+TEST_F(TreeArchiveTests, LoadRoundTrip)
+{
+    std::vector<FlatTree> trees;
+    for (const auto& input : inputs)
+    {
+        trees.emplace_back(parseTree(input));
+    }
+    std::string encoded = TreeArchive::serialize(trees);
+    auto buffer = aligned(encoded);
+    TreeArchive archive(reinterpret_cast<const char*>(buffer.data()),
+                                                            encoded.size());
+    ASSERT_EQ(archive.size(), trees.size());
+    for (int idx = 0; idx < trees.size(); idx++)
+    {
+        EXPECT_TRUE(archive.load(idx).equals(trees[idx])) << inputs[idx];
+    }
+}
+
+TEST_F(TreeArchiveTests, ViewEvaluatesInPlace)
+{
+    auto trees = TreeArchive::differentiate(inputs, "x");
+    std::string encoded = TreeArchive::serialize(trees);
+    auto buffer = aligned(encoded);
+    TreeArchive archive(reinterpret_cast<const char*>(buffer.data()),
+                                                            encoded.size());
+    ASSERT_EQ(archive.size(), 2 * inputs.size());
+    std::vector<double> scratch;
+    for (int idx = 0; idx < trees.size(); idx++)
+    {
+        auto view = archive.view(idx);
+        std::vector<double> slots(view.getVariableCount(), 2.0);
+        int slot = view.getSlot("x");
+        ASSERT_EQ(slot, trees[idx].getSlot(x));
+        if (slot != -1)
+        {
+            slots[slot] = 0.75;
+        }
+        EXPECT_DOUBLE_EQ(view.evaluate(slots.data(), scratch),
+                        trees[idx].evaluate(slots.data(), scratch));
+    }
+}
+
+TEST_F(TreeArchiveTests, ThawMatchesParsedTree)
+{
+    std::vector<FlatTree> trees;
+    for (const auto& input : inputs)
+    {
+        trees.emplace_back(parseTree(input));
+    }
+    std::string encoded = TreeArchive::serialize(trees);
+    auto buffer = aligned(encoded);
+    TreeArchive archive(reinterpret_cast<const char*>(buffer.data()),
+                                                            encoded.size());
+    for (int idx = 0; idx < trees.size(); idx++)
+    {
+        auto thawed = archive.thaw(idx);
+        EXPECT_EQ(LaTeXConverter::convertToLaTeX(thawed),
+                LaTeXConverter::convertToLaTeX(parseTree(inputs[idx])));
+        EXPECT_TRUE(FlatTree(thawed).equals(trees[idx]));
+    }
+
+}
+
+TEST_F(TreeArchiveTests, KeepsSubscripts)
+{
+    // The tokenizer does not carry subscripts into the tree, build
+    // log_2(x) * y_1 directly
+    auto log = std::make_shared<Function>("log");
+    log->setSubExprTree(parseTree("x"));
+    log->setSubscript(std::make_shared<Number>("2", 2));
+    auto y = std::make_shared<Variable>("y");
+    y->setSubscript("1");
+    auto root = std::make_shared<ExpressionNode>(
+                                        std::make_shared<Operator>("*"));
+    root->setLeft(std::make_shared<ExpressionNode>(log));
+    root->setRight(std::make_shared<ExpressionNode>(y));
+
+    std::vector<FlatTree> trees = {FlatTree(root)};
+    std::string encoded = TreeArchive::serialize(trees);
+    auto buffer = aligned(encoded);
+    TreeArchive archive(reinterpret_cast<const char*>(buffer.data()),
+                                                            encoded.size());
+    auto view = archive.view(0);
+    EXPECT_NE(view.getSlot("y", "1"), -1);
+    EXPECT_EQ(view.getSlot("y"), -1);
+    bool found = false;
+    for (int idx = 0; idx < view.size(); idx++)
+    {
+        if (view.getOpCode(idx) == OpCode::LOG)
+        {
+            EXPECT_EQ(view.getString(idx), "2");
+            EXPECT_EQ(view.getValue(idx), 2.0);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+
+    auto thawed = archive.thaw(0);
+    auto func = std::dynamic_pointer_cast<Function>(
+                                        thawed->getLeft()->getToken());
+    ASSERT_TRUE(func && func->getSubscript());
+    EXPECT_EQ(func->getSubscript()->getInt(), 2);
+    auto var = std::dynamic_pointer_cast<Variable>(
+                                        thawed->getRight()->getToken());
+    EXPECT_EQ(var->getSubscript(), "1");
+}
+
+TEST_F(TreeArchiveTests, MapsFile)
+{
+    std::string path = ::testing::TempDir() + "tree_archive_test.bin";
+    auto trees = TreeArchive::differentiate({"sin(x)*x"}, "x");
+    TreeArchive::save(path, trees);
+    {
+        TreeArchive archive(path);
+        ASSERT_EQ(archive.size(), 2);
+        double slots[1] = {1.5};
+        std::vector<double> scratch;
+        EXPECT_DOUBLE_EQ(archive.view(1).evaluate(slots, scratch),
+                        std::cos(1.5) * 1.5 + std::sin(1.5));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(TreeArchiveTests, RejectsCorruptData)
+{
+    std::vector<FlatTree> trees = {FlatTree(parseTree("x+1"))};
+    std::string encoded = TreeArchive::serialize(trees);
+
+    std::string magic = encoded;
+    magic[0] = 'X';
+    auto buffer = aligned(magic);
+    EXPECT_THROW(TreeArchive(reinterpret_cast<const char*>(buffer.data()),
+                                magic.size()), std::runtime_error);
+
+    std::string version = encoded;
+    version[8] = 9;
+    buffer = aligned(version);
+    EXPECT_THROW(TreeArchive(reinterpret_cast<const char*>(buffer.data()),
+                                version.size()), std::runtime_error);
+
+    buffer = aligned(encoded);
+    EXPECT_THROW(TreeArchive(reinterpret_cast<const char*>(buffer.data()),
+                                encoded.size() / 2), std::runtime_error);
+
+    // Point the root at itself
+    std::string cycle = encoded;
+    std::size_t tree = 40;
+    std::size_t lefts = tree + 16 + 3 * sizeof(double);
+    std::int32_t self = 2;
+    std::memcpy(&cycle[lefts + 2 * sizeof(std::int32_t)], &self,
+                                                            sizeof(self));
+    buffer = aligned(cycle);
+    EXPECT_THROW(TreeArchive(reinterpret_cast<const char*>(buffer.data()),
+                                cycle.size()), std::runtime_error);
+
+    // Start the root's sub-tree past its own entry, and before the tree
+    std::size_t firsts = lefts + 2 * 3 * sizeof(std::int32_t);
+    for (std::int32_t first : {3, -1})
+    {
+        std::string span = encoded;
+        std::memcpy(&span[firsts + 2 * sizeof(std::int32_t)], &first,
+                                                            sizeof(first));
+        buffer = aligned(span);
+        EXPECT_THROW(TreeArchive(reinterpret_cast<const char*>(
+                    buffer.data()), span.size()), std::runtime_error);
+    }
+}
@@ -0,0 +1,144 @@
+/**
+ * @file tree_fixer_tests.cpp
+ * @brief Google Tests for tree_fixer.cpp
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "tree_fixer.hpp"
+#include "text_converter.hpp"
+#include "latex_converter.hpp"
+#include "derivative.hpp"
+#include "equivalence.hpp"
+#include "flat_tree.hpp"
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <memory>
+
+
+class TreeFixerTests : public SymbolicTest
+{
+protected:
+    std::string simplified(const std::string& input)
+    {
+        return TextConverter::convertToText(
+                                    TreeFixer::simplify(parseTree(input)));
+    }
+
+    int depth(const nodePtr& node)
+    {
+        if (!node)
+        {
+            return 0;
+        }
+        return 1 + std::max(depth(node->getLeft()), depth(node->getRight()));
+    }
+};
+
+TEST_F(TreeFixerTests, SimplifyKeepsOperandOrder)
+{
+    EXPECT_EQ(simplified("x*y+2"), "(x*y)+2");
+    EXPECT_EQ(simplified("2+x*y"), "2+(x*y)");
+    EXPECT_EQ(simplified("x^2*3+x"), "((x^2)*3)+x");
+    EXPECT_EQ(simplified("3*x^2+x"), "(3*(x^2))+x");
+}
+
+TEST_F(TreeFixerTests, CollectsLikeOperandsInPlace)
+{
+    EXPECT_EQ(simplified("x+y+x"), "(2*x)+y");
+    EXPECT_EQ(simplified("y+x-3*x"), "y-(2*x)");
+    EXPECT_EQ(simplified("x-y-x"), "-y");
+    EXPECT_EQ(simplified("2*x*y+x*y"), "3*(x*y)");
+    EXPECT_EQ(simplified("x+1+y+2"), "(x+3)+y");
+    EXPECT_EQ(simplified("x*y*x"), "(x^2)*y");
+    EXPECT_EQ(simplified("x^2*y/x"), "x*y");
+    EXPECT_EQ(simplified("2/x*3"), "6/x");
+    EXPECT_EQ(simplified("x/2*2"), "x");
+    // Without float simplification 0.5 + 0.25 does not fold
+    EXPECT_EQ(simplified("0.5+x+0.25"), "(0.5+x)+0.25");
+
+    auto reciprocal = parseTree("1/x");
+    EXPECT_EQ(TreeFixer::simplify(reciprocal), reciprocal);
+    EXPECT_THROW(TreeFixer::simplify(parseTree("x*y/(x-x)")),
+                                                        std::runtime_error);
+}
+
+TEST_F(TreeFixerTests, BalancesLongChains)
+{
+    std::string input = "x";
+    for (int power = 2; power <= 1000; power++)
+    {
+        input += "+x^" + std::to_string(power);
+    }
+    auto root = parseTree(input);
+    ASSERT_EQ(depth(root), 1001);
+    auto out = TreeFixer::simplify(root);
+    // ceil(log2(1000)) levels of +, then x^k
+    EXPECT_LE(depth(out), 10 + 2);
+    EXPECT_TRUE(Equivalence::structurallyEqual(out, root));
+    // Already balanced, so left alone from now on
+    EXPECT_EQ(TreeFixer::simplify(out), out);
+}
+
+TEST_F(TreeFixerTests, ProductDerivativeIsShallow)
+{
+    // (x+1)(x+2)...(x+64), balanced before the product rule sees it
+    std::string input = "(x+1)";
+    for (int offset = 2; offset <= 64; offset++)
+    {
+        input += "*(x+" + std::to_string(offset) + ")";
+    }
+    Derivative engine(input, "x");
+    engine.log.setEnabled(false);
+    auto derivative = engine.solve();
+    EXPECT_LE(depth(derivative), 20);
+
+    // d/dx at 0 is 64! * (1 + 1/2 + ... + 1/64)
+    double expected = 1.0;
+    double harmonic = 0.0;
+    for (int offset = 1; offset <= 64; offset++)
+    {
+        expected *= offset;
+        harmonic += 1.0 / offset;
+    }
+    double zero = 0.0;
+    EXPECT_NEAR(FlatTree(derivative).evaluate(&zero) / (expected * harmonic),
+                                                                1.0, 1e-12);
+}
+
+TEST_F(TreeFixerTests, SimplifyLeavesInputAlone)
+{
+    auto root = parseTree("x*1+0*y");
+    auto left = root->getLeft();
+    auto right = root->getRight();
+    EXPECT_EQ(TextConverter::convertToText(TreeFixer::simplify(root)), "x");
+    EXPECT_EQ(root->getLeft(), left);
+    EXPECT_EQ(root->getRight(), right);
+    EXPECT_EQ(TextConverter::convertToText(root), "(x*1)+(0*y)");
+}
+
+TEST_F(TreeFixerTests, SharedFunctionKeepsItsLaTeX)
+{
+    // One sin(x) node, as the base of a power and as a factor
+    auto sin = parseTree("sin(x)");
+    auto power = std::make_shared<ExpressionNode>(
+                                        std::make_shared<Operator>("^"));
+    power->setLeft(sin);
+    power->setRight(parseTree("2"));
+    auto root = std::make_shared<ExpressionNode>(
+                                        std::make_shared<Operator>("+"));
+    root->setLeft(power);
+    auto product = std::make_shared<ExpressionNode>(
+                                        std::make_shared<Operator>("*"));
+    product->setLeft(parseTree("3"));
+    product->setRight(sin);
+    root->setRight(product);
+
+    EXPECT_EQ(LaTeXConverter::convertToLaTeX(root),
+        "\\left(\\left(\\sin^{{2}}\\left({x}\\right)\\right)"
+        "^{\\left({2}\\right)}\\right) + \\left(\\left({3}\\right) "
+        "\\cdot \\left(\\sin\\left({x}\\right)\\right)\\right)");
+}